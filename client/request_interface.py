@@ -618,10 +618,30 @@ class RequestInterface(ABC, Generic[RT]):
 
     def unsubscribe_all(self):
         """
-        Unsubscribe from all channels
+        Unsubscribe from all channels and patterns
         """
         return self.request("UNSUBSCRIBE_ALL")
 
+    def psubscribe(self, pattern: str):
+        """
+        Subscribe to every channel matching a pattern
+        :param pattern: the pattern to subscribe to, where * matches any sequence and ? any one character
+        """
+        return self.request("PSUBSCRIBE", pattern)
+
+    def psubscribed(self):
+        """
+        Get the patterns subscribed to
+        """
+        return self.request("PSUBSCRIBED")
+
+    def punsubscribe(self, pattern: str):
+        """
+        Unsubscribe from a pattern
+        :param pattern: the pattern to unsubscribe from
+        """
+        return self.request("PUNSUBSCRIBE", pattern)
+
     def cluster_key(self):
         """
         Get the key of a cluster
@@ -685,3 +705,9 @@ class RequestInterface(ABC, Generic[RT]):
         Unbind the server from a host and port
         """
         return self.request("UNBIND", host, port)
+
+    def client_output(self):
+        """
+        Get the number of bytes waiting to be written to each client, by client address
+        """
+        return self.request("CLIENT_OUTPUT")
@@ -23,8 +23,10 @@ class ServerHandle:
         no_db_persist: bool = True,
         no_auth_persist: bool = True,
         no_wal: bool = True,
+        wal_fsync: Literal["always", "everysec", "os"] = None,
         no_logging: bool = True,
         log_level: Literal["debug", "info", "warning", "error", "critical"] = None,
+        output_limits: dict[Literal["normal", "pubsub", "peer"], str] = None,
     ):
         """
         Create a new ServerHandle.
@@ -35,8 +37,10 @@ class ServerHandle:
         :param no_db_persist: Whether to persist the database.
         :param no_auth_persist: Whether to persist the users file.
         :param no_wal: Whether to use the write-ahead log.
+        :param wal_fsync: When to sync the write-ahead log to disk.
         :param no_logging: Whether to log.
         :param log_level: The level to log at.
+        :param output_limits: The <hard>:<soft> output limits of each client class.
         """
         self.args = [executable_path]
         self.env = env
@@ -65,12 +69,18 @@ class ServerHandle:
         if no_wal:
             self.args.append("--no-wal")
 
+        if wal_fsync:
+            self.args.append(f"--wal-fsync={wal_fsync}")
+
         if no_logging:
             self.args.append("--no-logging")
 
         if log_level:
             self.args.append(f"--log-level={log_level}")
 
+        for client_class, limit in (output_limits or {}).items():
+            self.args.append(f"--output-limit-{client_class}={limit}")
+
     def __enter__(self):
         self.start()
         return self
@@ -43,6 +43,46 @@ class GeneralDatabaseTest(BaseDatabaseTest):
         response = self.client.ping()
         self.assertTrue(response.is_pong())
 
+    def test_pipelined_requests(self):
+        """
+        Test that many requests sent at once all get a response, in order.
+        """
+        frames = b""
+        for i in range(500):
+            msg = self.client.request_from("STR_SET", f"test_pipelined_{i}", f"value_{i}")
+            frames += len(msg).to_bytes(4, "big") + msg.encode()
+        self.client.sock.sock.sendall(frames)
+
+        for i in range(500):
+            self.assertTrue(self.client.read_response().is_ok())
+
+        for i in range(0, 500, 50):
+            response = self.client.get(f"test_pipelined_{i}")
+            self.assertEqual(response.value, f"value_{i}")
+
+    def test_pipelined_large_responses(self):
+        """
+        Test that many large responses to requests sent at once all arrive whole, in order.
+        """
+        value = "v" * (64 * 1024)
+        self.client.str_set("test_pipelined_large", value)
+
+        msg = self.client.request_from("GET", "test_pipelined_large")
+        frame = len(msg).to_bytes(4, "big") + msg.encode()
+        self.client.sock.sock.sendall(frame * 100)
+
+        for i in range(100):
+            self.assertEqual(self.client.read_response().value, value)
+
+    def test_large_request(self):
+        """
+        Test that a request larger than a single read is received whole.
+        """
+        value = "v" * (1024 * 1024)
+        self.client.str_set("test_large_request", value)
+        response = self.client.get("test_large_request")
+        self.assertEqual(response.value, value)
+
     def test_reset(self):
         """
         Test that we can reset the database.
@@ -362,6 +402,41 @@ class GeneralDatabaseTestWithSwitching(BaseDatabaseTest):
         self.assertTrue(response.is_null())
 
 
+class ManyKeysTest(BaseDatabaseTest):
+    """
+    Test a keyspace large enough to grow its tables many times.
+    """
+
+    SIZE = 3000
+
+    def test_many_keys(self):
+        """
+        Test that keys, values and expiry times survive growth and deletion.
+        """
+        keys = [f"test_many_keys_{i}" for i in range(self.SIZE)]
+        for i, key in enumerate(keys):
+            self.client.str_set(key, f"value{i}")
+            if i % 3 == 0:
+                self.client.set_expiry(key, 100)
+
+        for key in keys[::2]:
+            response = self.client.delete(key)
+            self.assertTrue(response.is_ok())
+
+        response = self.client.keys()
+        self.assertEqual(len(response.value), self.SIZE // 2)
+        response = self.client.many_get(*keys)
+        self.assertEqual(
+            response.value,
+            [None if i % 2 == 0 else f"value{i}" for i in range(self.SIZE)],
+        )
+        for i in (3, 9, self.SIZE - 3):
+            response = self.client.get_expiry(keys[i])
+            self.assertTrue(90 < response.value <= 100)
+        response = self.client.get_expiry(keys[1])
+        self.assertTrue(response.is_null())
+
+
 class PrimitiveDatabaseTest(BaseDatabaseTest):
     def test_set_get(self):
         """
@@ -570,6 +645,29 @@ class PrimitiveDatabaseTest(BaseDatabaseTest):
         response = self.client.str_len("test_str_len_float")
         self.assertTrue(response.is_bad_type())
 
+    def test_set_get_str_encodings(self):
+        """
+        Test that strings of every length and numeric form stay strings.
+        """
+        values = [
+            "",
+            "123456789012345",
+            "1234567890123456",
+            "-9223372036854775808",
+            "9223372036854775808",
+            "0012345678901234567",
+            "x" * 100,
+        ]
+        for i, value in enumerate(values):
+            key = f"test_set_get_str_encodings_{i}"
+            self.client.str_set(key, value)
+            response = self.client.get(key)
+            self.assertEqual(response.value, value)
+            response = self.client.str_len(key)
+            self.assertEqual(response.value, len(value))
+            response = self.client.type(key)
+            self.assertTrue(response.type_is_str())
+
     def test_many_get(self):
         """
         Test that we can get many values at once.
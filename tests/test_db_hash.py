@@ -320,3 +320,34 @@ class HashTest(BaseDatabaseTest):
         """
         response = self.client.hash_many_get("test_hash_set", [])
         self.assertEqual(response.value, [])
+
+
+class LargeHashTest(BaseDatabaseTest):
+    """
+    Test hashes large enough to leave the compact encoding.
+    """
+
+    SIZE = 200
+
+    def test_large_hash_get_remove(self):
+        """
+        Test that a large hash keeps its fields as it shrinks.
+        """
+        values = {f"field{i}": f"value{i}" for i in range(self.SIZE)}
+        response = self.client.hash_set("test_large_hash", values)
+        self.assertTrue(response.is_ok())
+
+        response = self.client.hash_all("test_large_hash")
+        self.assertEqual(response.value, values)
+        response = self.client.hash_get("test_large_hash", "field150")
+        self.assertEqual(response.value, "value150")
+
+        removed = [f"field{i}" for i in range(0, self.SIZE, 2)]
+        response = self.client.hash_remove("test_large_hash", removed)
+        self.assertEqual(response.value, len(removed))
+        for field in removed:
+            del values[field]
+        response = self.client.hash_len("test_large_hash")
+        self.assertEqual(response.value, len(values))
+        response = self.client.hash_all("test_large_hash")
+        self.assertEqual(response.value, values)
@@ -675,3 +675,47 @@ class NegativeIndicesTest(BaseDatabaseTest):
                 "value12",
             ],
         )
+
+
+class LargeListTest(BaseDatabaseTest):
+    """
+    Test lists long enough to be stored in many chunks.
+    """
+
+    SIZE = 5000
+
+    def setUp(self) -> None:
+        super().setUp()
+        self.values = [f"value{i}" for i in range(self.SIZE)]
+        response = self.client.list_push_right("test_large_list", self.values[self.SIZE // 2:])
+        self.assertTrue(response.is_ok())
+        response = self.client.list_push_left("test_large_list", self.values[self.SIZE // 2 - 1::-1])
+        self.assertTrue(response.is_ok())
+        self.assertEqual(response.value, self.SIZE)
+
+    def test_large_list_get_set(self):
+        """
+        Test that elements anywhere in a large list can be read and replaced.
+        """
+        for index in (0, 1, self.SIZE // 3, self.SIZE // 2, self.SIZE - 1, -1, -self.SIZE // 3):
+            response = self.client.list_get("test_large_list", index)
+            self.assertEqual(response.value, self.values[index])
+            response = self.client.list_set("test_large_list", index, "x" * 10000)
+            self.assertEqual(response.value, self.values[index])
+            self.values[index] = "x" * 10000
+
+        response = self.client.list_range("test_large_list", 0, -1)
+        self.assertEqual(response.value, self.values)
+
+    def test_large_list_pop_trim(self):
+        """
+        Test that popping and trimming a large list spans chunks.
+        """
+        response = self.client.list_pop_left("test_large_list", 1500)
+        self.assertEqual(response.value, self.values[:1500])
+        response = self.client.list_pop_right("test_large_list", 1500)
+        self.assertEqual(response.value, self.values[-1500:])
+        response = self.client.list_trim("test_large_list", 700, -701)
+        self.assertEqual(response.value, 1400)
+        response = self.client.list_range("test_large_list", 0, -1)
+        self.assertEqual(response.value, self.values[2200:2800])
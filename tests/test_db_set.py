@@ -545,3 +545,70 @@ class SetTest(BaseDatabaseTest):
         self.assertEqual(response.value, 3)
         response = self.client.set_diff_len("set_test_diff_len1", "set_test_diff_len2")
         self.assertEqual(response.value, 2)
+
+
+class LargeSetTest(BaseDatabaseTest):
+    """
+    Test sets that grow past the compact encoding one element at a time.
+    """
+
+    SIZE = 200
+
+    def test_large_set_grow_shrink(self):
+        """
+        Test that a set keeps its elements as it grows and shrinks.
+        """
+        values = {f"value{i}" for i in range(self.SIZE)}
+        for value in values:
+            response = self.client.set_add("test_large_set", {value})
+            self.assertEqual(response.value, 1)
+
+        response = self.client.set_all("test_large_set")
+        self.assertEqual(response.value, values)
+        response = self.client.set_contains("test_large_set", "value150")
+        self.assertEqual(response.value, True)
+
+        removed = {f"value{i}" for i in range(0, self.SIZE, 2)}
+        response = self.client.set_discard("test_large_set", removed)
+        self.assertEqual(response.value, len(removed))
+        response = self.client.set_all("test_large_set")
+        self.assertEqual(response.value, values - removed)
+
+
+class IntegerSetTest(BaseDatabaseTest):
+    """
+    Test sets whose elements are all integers.
+    """
+
+    def setUp(self) -> None:
+        super().setUp()
+        self.evens = {str(i) for i in range(-1000, 1000, 2)}
+        self.threes = {str(i) for i in range(-999, 1000, 3)}
+        response = self.client.set_add("test_int_evens", self.evens)
+        self.assertEqual(response.value, len(self.evens))
+        response = self.client.set_add("test_int_threes", self.threes)
+        self.assertEqual(response.value, len(self.threes))
+
+    def test_int_set_algebra(self):
+        """
+        Test union, intersection and difference of integer sets.
+        """
+        response = self.client.set_union("test_int_evens", "test_int_threes")
+        self.assertEqual(response.value, self.evens | self.threes)
+        response = self.client.set_intersect("test_int_evens", "test_int_threes")
+        self.assertEqual(response.value, self.evens & self.threes)
+        response = self.client.set_diff("test_int_evens", "test_int_threes")
+        self.assertEqual(response.value, self.evens - self.threes)
+
+    def test_int_set_non_canonical(self):
+        """
+        Test that strings that only look like integers stay distinct.
+        """
+        response = self.client.set_add("test_int_evens", {"02", "+2", "-0", "2"})
+        self.assertEqual(response.value, 3)
+        response = self.client.set_contains("test_int_evens", "02")
+        self.assertEqual(response.value, True)
+        response = self.client.set_contains("test_int_evens", "4")
+        self.assertEqual(response.value, True)
+        response = self.client.set_all("test_int_evens")
+        self.assertEqual(response.value, self.evens | {"02", "+2", "-0"})
@@ -2,6 +2,7 @@ import time
 from tempfile import TemporaryDirectory
 import unittest
 
+from client import Pipe
 from client.server_handle import ServerHandle
 from tests.test_db import BaseDatabaseTest
 from tests.utils import get_free_port, make_client
@@ -52,6 +53,89 @@ class ExpiryTest(BaseDatabaseTest):
         response = self.client.get("key")
         self.assertEqual(response.value, "value")
 
+    def test_reset_expiry(self):
+        """
+        Test that a key outlives an expiry time it was given before its current one.
+        """
+        response = self.client.str_set("key", "value")
+        self.assertTrue(response.is_ok())
+        response = self.client.set_expiry("key", self.EXPIRE_TIME)
+        self.assertTrue(response.is_ok())
+        response = self.client.set_expiry("key", 10 * self.EXPIRE_TIME)
+        self.assertTrue(response.is_ok())
+        time.sleep(2 * self.EXPIRE_TIME)
+        response = self.client.get("key")
+        self.assertEqual(response.value, "value")
+
+    def test_refreshed_expiry_purged(self):
+        """
+        Test that a key whose expiry time is pushed back many times expires at the last one.
+        """
+        response = self.client.str_set("key", "value")
+        self.assertTrue(response.is_ok())
+        for i in range(1, 101):
+            response = self.client.set_expiry("key", self.EXPIRE_TIME + i * self.EXPIRE_TIME / 100)
+            self.assertTrue(response.is_ok())
+
+        time.sleep(self.EXPIRE_TIME)
+        response = self.client.keys()
+        self.assertEqual(response.value, ["key"])
+        time.sleep(2 * self.EXPIRE_TIME)
+        response = self.client.keys()
+        self.assertTrue(response.is_null())
+
+    def test_set_then_expire_cycles(self):
+        """
+        Test that a key set and given an expiry time over and over expires at the last one.
+        """
+        for i in range(2000):
+            response = self.client.str_set("key", f"value{i}")
+            self.assertTrue(response.is_ok())
+            response = self.client.set_expiry("key", self.EXPIRE_TIME)
+            self.assertTrue(response.is_ok())
+
+        response = self.client.get("key")
+        self.assertEqual(response.value, "value1999")
+        time.sleep(2 * self.EXPIRE_TIME)
+        response = self.client.keys()
+        self.assertTrue(response.is_null())
+
+    def test_expired_keys_purged(self):
+        """
+        Test that only expired keys are listed as gone, among many keys with expiry times.
+        """
+        for i in range(200):
+            response = self.client.str_set(f"key{i}", "value")
+            self.assertTrue(response.is_ok())
+            expiry = self.EXPIRE_TIME if i % 2 else 100 * self.EXPIRE_TIME
+            response = self.client.set_expiry(f"key{i}", expiry)
+            self.assertTrue(response.is_ok())
+
+        time.sleep(2 * self.EXPIRE_TIME)
+        response = self.client.keys()
+        self.assertEqual(set(response.value), {f"key{i}" for i in range(0, 200, 2)})
+
+    def test_many_keys_due_in_one_tick(self):
+        """
+        Test that keys keep expiring after many keys in a shard are due at the same time.
+        """
+        pipe = Pipe(self.client)
+        for group in range(20):
+            for i in range(5000):
+                pipe.str_set(f"key{group}_{i}", "value")
+                pipe.set_expiry(f"key{group}_{i}", self.EXPIRE_TIME)
+            response = pipe.execute()
+            self.assertTrue(all(r.is_ok() for r in response.value))
+
+        time.sleep(3 * self.EXPIRE_TIME)
+        response = self.client.str_set("key", "value")
+        self.assertTrue(response.is_ok())
+        response = self.client.set_expiry("key", self.EXPIRE_TIME)
+        self.assertTrue(response.is_ok())
+        time.sleep(3 * self.EXPIRE_TIME)
+        response = self.client.keys()
+        self.assertTrue(response.is_null())
+
 
 class WalExpiryTest(unittest.TestCase):
     """
@@ -1,3 +1,5 @@
+import os
+import struct
 import unittest
 from tempfile import TemporaryDirectory
 
@@ -266,6 +268,47 @@ class WALPersistenceDisabledTest(unittest.TestCase):
             self.assertEqual(response.value, {"red": "1", "green": "2", "blue": "3"})
 
 
+    def test_wal_persist_across_databases(self):
+        """
+        Test that writes to several databases, and moves between them,
+        are recovered in order.
+        """
+        with make_client(self.port) as client:
+            response = client.int_set("test_wal_across_db", 1)
+            self.assertTrue(response.is_ok())
+            response = client.switch_db(1)
+            self.assertTrue(response.is_ok())
+            response = client.int_set("test_wal_across_db", 10)
+            self.assertTrue(response.is_ok())
+            response = client.switch_db(0)
+            self.assertTrue(response.is_ok())
+            response = client.incr_int("test_wal_across_db", 1)
+            self.assertTrue(response.is_ok())
+            response = client.move_to_db("test_wal_across_db", 2)
+            self.assertTrue(response.is_ok())
+            response = client.switch_db(2)
+            self.assertTrue(response.is_ok())
+            response = client.incr_int("test_wal_across_db", 1)
+            self.assertTrue(response.is_ok())
+            response = client.switch_db(1)
+            self.assertTrue(response.is_ok())
+            response = client.incr_int("test_wal_across_db", 5)
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_across_db")
+            self.assertTrue(response.is_null())
+            response = client.switch_db(1)
+            self.assertTrue(response.is_ok())
+            response = client.get("test_wal_across_db")
+            self.assertEqual(response.value, 15)
+            response = client.switch_db(2)
+            self.assertTrue(response.is_ok())
+            response = client.get("test_wal_across_db")
+            self.assertEqual(response.value, 3)
+
 class WALPersistenceTest(unittest.TestCase):
     """
     Test that WAL recovery works if persistence is enabled.
@@ -387,3 +430,293 @@ class WALPersistenceTest(unittest.TestCase):
             self.assertEqual(
                 response.value, {"red", "green", "blue", "yellow", "purple"}
             )
+
+    def test_wal_after_persist(self):
+        """
+        Test that writes after a persist are recovered from the WAL,
+        and writes before it are not redone on top of the database file.
+        """
+        with make_client(self.port) as client:
+            response = client.int_set("test_wal_after_persist", 1)
+            self.assertTrue(response.is_ok())
+            response = client.persist()
+            self.assertTrue(response.is_ok())
+            response = client.incr_int("test_wal_after_persist")
+            self.assertEqual(response.value, 2)
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_after_persist")
+            self.assertEqual(response.value, 2)
+            response = client.incr_int("test_wal_after_persist")
+            self.assertEqual(response.value, 3)
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_after_persist")
+            self.assertEqual(response.value, 3)
+
+    def test_wal_unfinished_persist(self):
+        """
+        Test that the next WAL file of a persist that did not finish is recovered.
+        """
+        with make_client(self.port) as client:
+            response = client.int_set("test_wal_unfinished_persist", 1)
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.stop()
+        os.rename(
+            os.path.join(self.temp_dir.name, "vanity.wal"),
+            os.path.join(self.temp_dir.name, "next.vanity.wal"),
+        )
+        self.server_handle.start()
+
+        with make_client(self.port) as client:
+            response = client.incr_int("test_wal_unfinished_persist")
+            self.assertEqual(response.value, 2)
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_unfinished_persist")
+            self.assertEqual(response.value, 2)
+
+
+class WALFsyncAlwaysTest(unittest.TestCase):
+    """
+    Test that WAL recovery works if the WAL is synced after every write.
+    """
+
+    def setUp(self) -> None:
+        self.temp_dir = TemporaryDirectory()
+        self.port = get_free_port()
+        self.server_handle = ServerHandle(
+            ports=[self.port],
+            no_db_persist=True,
+            no_wal=False,
+            wal_fsync="always",
+            working_dir=self.temp_dir.name,
+        )
+        self.server_handle.start()
+
+    def tearDown(self) -> None:
+        self.server_handle.stop()
+        self.temp_dir.cleanup()
+
+    def test_wal_persist_int_incr(self):
+        """
+        Test that we can set an integer value, increment it,
+        restart the server, and get the correct value.
+        """
+        with make_client(self.port) as client:
+            response = client.int_set("test_wal_persist_int_incr", 123)
+            self.assertTrue(response.is_ok())
+            response = client.incr_int("test_wal_persist_int_incr", 10)
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_persist_int_incr")
+            self.assertEqual(response.value, 133)
+
+
+class UnversionedDatabaseFileTest(unittest.TestCase):
+    """
+    Test loading a database file written before snapshots were versioned.
+    """
+
+    NUM_DATABASES = 16
+
+    def setUp(self) -> None:
+        self.temp_dir = TemporaryDirectory()
+        self.db_file = os.path.join(self.temp_dir.name, "vanity.db")
+        self.port = get_free_port()
+        self.server_handle = ServerHandle(
+            ports=[self.port],
+            no_db_persist=False,
+            working_dir=self.temp_dir.name,
+        )
+
+    def tearDown(self) -> None:
+        self.server_handle.stop()
+        self.temp_dir.cleanup()
+
+    @staticmethod
+    def string(value: str) -> bytes:
+        return struct.pack("<Q", len(value)) + value.encode()
+
+    def test_unversioned_database_file(self):
+        """
+        Test that every database of an unversioned database file is loaded,
+        and that it is rewritten as a snapshot on persist.
+        """
+        with open(self.db_file, "wb") as db:
+            for index in range(self.NUM_DATABASES):
+                db.write(struct.pack("<I", index))
+                if index == 0:
+                    db.write(struct.pack("<Q", 2))
+                    db.write(self.string("test_unversioned_str") + struct.pack("<b", 0) + self.string("value"))
+                    db.write(self.string("test_unversioned_list") + struct.pack("<bQ", 3, 2))
+                    db.write(self.string("red") + self.string("green"))
+                elif index == 1:
+                    db.write(struct.pack("<Q", 1))
+                    db.write(self.string("test_unversioned_int") + struct.pack("<bq", 1, 123))
+                else:
+                    db.write(struct.pack("<Q", 0))
+                db.write(struct.pack("<Q", 0))
+        self.server_handle.start()
+
+        with make_client(self.port) as client:
+            response = client.get("test_unversioned_str")
+            self.assertEqual(response.value, "value")
+            response = client.list_range("test_unversioned_list", 0, -1)
+            self.assertEqual(response.value, ["red", "green"])
+            response = client.persist()
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_unversioned_str")
+            self.assertEqual(response.value, "value")
+            response = client.switch_db(1)
+            self.assertTrue(response.is_ok())
+            response = client.get("test_unversioned_int")
+            self.assertEqual(response.value, 123)
+
+
+class UnversionedWALTest(unittest.TestCase):
+    """
+    Test recovering from a WAL file written before WAL files had a header.
+    """
+
+    DB_OP = 0
+    STR_SET = 17
+    INCR_INT = 20
+
+    def setUp(self) -> None:
+        self.temp_dir = TemporaryDirectory()
+        self.wal_file = os.path.join(self.temp_dir.name, "vanity.wal")
+        self.port = get_free_port()
+        self.server_handle = ServerHandle(
+            ports=[self.port],
+            no_db_persist=True,
+            no_wal=False,
+            working_dir=self.temp_dir.name,
+        )
+
+    def tearDown(self) -> None:
+        self.server_handle.stop()
+        self.temp_dir.cleanup()
+
+    @staticmethod
+    def string(value: str) -> bytes:
+        return struct.pack("<Q", len(value)) + value.encode()
+
+    def db_op(self, op: int, args: bytes) -> bytes:
+        return struct.pack("<bIQB", self.DB_OP, 0, 0, op) + args + b"\n"
+
+    def test_unversioned_wal(self):
+        """
+        Test that the entries of an unversioned WAL are redone, up to a torn one,
+        and that records written after recovery are kept.
+        """
+        with open(self.wal_file, "wb") as wal:
+            wal.write(self.db_op(self.STR_SET, self.string("test_unversioned_wal") + self.string("value")))
+            wal.write(self.db_op(self.INCR_INT, self.string("test_unversioned_wal_int") + struct.pack("<q", 5)))
+            wal.write(self.db_op(self.INCR_INT, self.string("test_unversioned_wal_int") + struct.pack("<q", 3)))
+            wal.write(self.db_op(self.STR_SET, self.string("test_unversioned_wal_torn"))[:-1])
+        self.server_handle.start()
+
+        with make_client(self.port) as client:
+            response = client.get("test_unversioned_wal")
+            self.assertEqual(response.value, "value")
+            response = client.get("test_unversioned_wal_int")
+            self.assertEqual(response.value, 8)
+            response = client.get("test_unversioned_wal_torn")
+            self.assertTrue(response.is_null())
+            response = client.incr_int("test_unversioned_wal_int", 2)
+            self.assertEqual(response.value, 10)
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_unversioned_wal")
+            self.assertEqual(response.value, "value")
+            response = client.get("test_unversioned_wal_int")
+            self.assertEqual(response.value, 10)
+
+
+class WALCorruptionTest(unittest.TestCase):
+    """
+    Test that WAL recovery stops cleanly at a torn or corrupted record.
+    """
+
+    def setUp(self) -> None:
+        self.temp_dir = TemporaryDirectory()
+        self.wal_file = os.path.join(self.temp_dir.name, "vanity.wal")
+        self.port = get_free_port()
+        self.server_handle = ServerHandle(
+            ports=[self.port],
+            no_db_persist=True,
+            no_wal=False,
+            working_dir=self.temp_dir.name,
+        )
+        self.server_handle.start()
+
+    def tearDown(self) -> None:
+        self.server_handle.stop()
+        self.temp_dir.cleanup()
+
+    def test_wal_torn_record(self):
+        """
+        Test that a torn record at the end of the WAL is dropped,
+        and that records written after recovery are kept.
+        """
+        with make_client(self.port) as client:
+            response = client.str_set("test_wal_torn_record", "value")
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.stop()
+        with open(self.wal_file, "ab") as wal:
+            wal.write(b"\x40\x00\x00\x00torn")
+        self.server_handle.start()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_torn_record")
+            self.assertEqual(response.value, "value")
+            response = client.str_set("test_wal_torn_record_after", "value_after")
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.restart()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_torn_record")
+            self.assertEqual(response.value, "value")
+            response = client.get("test_wal_torn_record_after")
+            self.assertEqual(response.value, "value_after")
+
+    def test_wal_corrupted_record(self):
+        """
+        Test that recovery stops at a record whose checksum does not match.
+        """
+        with make_client(self.port) as client:
+            response = client.str_set("test_wal_corrupted_record", "value")
+            self.assertTrue(response.is_ok())
+            response = client.str_set("test_wal_corrupted_record", "corrupted")
+            self.assertTrue(response.is_ok())
+
+        self.server_handle.stop()
+        with open(self.wal_file, "r+b") as wal:
+            wal.seek(-1, os.SEEK_END)
+            last = wal.read(1)
+            wal.seek(-1, os.SEEK_END)
+            wal.write(bytes([last[0] ^ 0xFF]))
+        self.server_handle.start()
+
+        with make_client(self.port) as client:
+            response = client.get("test_wal_corrupted_record")
+            self.assertEqual(response.value, "value")
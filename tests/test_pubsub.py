@@ -1,3 +1,6 @@
+import socket
+import struct
+import time
 import unittest
 
 from client import ServerHandle
@@ -361,3 +364,180 @@ class TestPubSub(unittest.TestCase):
         self.assertTrue(response.is_ok())
         self.assertTrue(response.type_is_array())
         self.assertEqual(response.value, [])
+
+    def test_psubscribe(self):
+        """
+        Test that a pattern subscription receives messages to every matching channel.
+        """
+        response = self.client.psubscribe("orders.eu.*")
+        self.assertTrue(response.is_ok())
+        self.assertEqual(response.value, 1)
+
+        self._publish("orders.us.1", "skipped")
+        self._publish("orders.eu.1", "first")
+        self._publish("orders.eu.2", "second")
+
+        response = self.client.read_async()
+        self.assertEqual(response.data.channel, "orders.eu.1")
+        self.assertEqual(response.data.message, "first")
+
+        response = self.client.read_async()
+        self.assertEqual(response.data.channel, "orders.eu.2")
+        self.assertEqual(response.data.message, "second")
+
+    def test_psubscribe_glob(self):
+        """
+        Test that ? matches any one character and * matches any sequence.
+        """
+        response = self.client.psubscribe("orders.?u.*.paid")
+        self.assertTrue(response.is_ok())
+
+        self._publish("orders.eu.1", "skipped")
+        self._publish("orders.us.1.paid", "skipped")
+        self._publish("orders.eu.1.2.paid", "paid")
+
+        response = self.client.read_async()
+        self.assertEqual(response.data.channel, "orders.eu.1.2.paid")
+        self.assertEqual(response.data.message, "paid")
+
+    def test_psubscribe_many_wildcards(self):
+        """
+        Test that a pattern with many *s matches a long channel quickly.
+        """
+        self.assertTrue(self.client.psubscribe("*a*a*a*a*a*a*a*a*b").is_ok())
+
+        self._publish("a" * 64, "skipped")
+        self._publish("a" * 64 + "b", "matched")
+
+        response = self.client.read_async()
+        self.assertEqual(response.data.channel, "a" * 64 + "b")
+        self.assertEqual(response.data.message, "matched")
+
+    def test_psubscribe_once_per_message(self):
+        """
+        Test that a client with several matching subscriptions gets a message once.
+        """
+        self.assertTrue(self.client.subscribe("orders.eu.1").is_ok())
+        self.assertTrue(self.client.psubscribe("orders.*").is_ok())
+        self.assertTrue(self.client.psubscribe("orders.eu.*").is_ok())
+
+        self._publish("orders.eu.1", "once")
+        self._publish("orders.eu.2", "twice")
+
+        self.assertEqual(self.client.read_async().data.message, "once")
+        self.assertEqual(self.client.read_async().data.message, "twice")
+
+    def test_psubscribed(self):
+        """
+        Test the patterns subscribed to.
+        """
+        self.assertTrue(self.client.psubscribe("orders.*").is_ok())
+        response = self.client.psubscribed()
+        self.assertTrue(response.is_ok())
+        self.assertEqual(response.value, ["orders.*"])
+
+    def test_punsubscribe(self):
+        """
+        Test that a pattern subscription can be removed.
+        """
+        self.assertTrue(self.client.psubscribe("orders.*").is_ok())
+        response = self.client.punsubscribe("orders.*")
+        self.assertTrue(response.is_ok())
+        self.assertEqual(response.value, 0)
+
+        self.assertTrue(self.client.subscribe("control").is_ok())
+        self._publish("orders.eu.1", "skipped")
+        self._publish("control", "received")
+
+        response = self.client.read_async()
+        self.assertEqual(response.data.channel, "control")
+
+
+class TestPubSubOutputLimit(unittest.TestCase):
+    """
+    Test the output limit of pubsub clients.
+    """
+
+    def setUp(self) -> None:
+        self.port = get_free_port()
+        self.server_handle = ServerHandle(ports=[self.port], output_limits={"pubsub": "256k:128k"})
+        self.server_handle.start()
+        self.client = make_client(self.port)
+
+    def tearDown(self) -> None:
+        self.client.close()
+        self.server_handle.stop()
+
+    def test_client_output(self):
+        """
+        Test that the output waiting for each client is reported.
+        """
+        host, port = self.client.sock.sock.getsockname()
+        response = self.client.client_output()
+        self.assertTrue(response.is_ok())
+        self.assertEqual(response.value[f"{host}:{port}"], "0")
+
+    def test_slow_subscriber_disconnected(self):
+        """
+        Test that a subscriber that does not read is disconnected once over its hard limit.
+        """
+        response = self.client.subscribe("test")
+        self.assertTrue(response.is_ok())
+
+        with make_client(self.port) as client:
+            message = "m" * (256 * 1024)
+            for _ in range(64):
+                self.assertTrue(client.publish("test", message).is_ok())
+
+            # the subscriber gets what was written before it was disconnected, then EOF
+            sock = self.client.sock.sock
+            sock.settimeout(5)
+            while sock.recv(1024 * 1024):
+                pass
+
+
+class TestPubSubSoftLimit(unittest.TestCase):
+    """
+    Test the soft output limit of pubsub clients.
+    """
+
+    def setUp(self) -> None:
+        self.port = get_free_port()
+        self.server_handle = ServerHandle(ports=[self.port], output_limits={"pubsub": "0:128k"})
+        self.server_handle.start()
+        self.client = make_client(self.port)
+
+    def tearDown(self) -> None:
+        self.client.close()
+        self.server_handle.stop()
+
+    def test_paused_subscriber_reset(self):
+        """
+        Test that a subscriber that resets its connection while paused is removed.
+        """
+        with make_client(self.port) as subscriber:
+            self.assertTrue(subscriber.subscribe("test").is_ok())
+
+            message = "m" * (256 * 1024)
+            for _ in range(64):
+                self.assertTrue(self.client.publish("test", message).is_ok())
+
+            # a request while over the soft limit pauses the subscriber
+            subscriber.send_command("SUBSCRIBED")
+            time.sleep(0.1)
+
+            # closing with unread data resets the connection
+            sock = subscriber.sock.sock
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+
+        for _ in range(16):
+            self.assertTrue(self.client.publish("test", message).is_ok())
+
+        host, port = self.client.sock.sock.getsockname()
+        for _ in range(50):
+            response = self.client.client_output()
+            self.assertTrue(response.is_ok())
+            if list(response.value) == [f"{host}:{port}"]:
+                break
+            time.sleep(0.1)
+        self.assertEqual(list(response.value), [f"{host}:{port}"])
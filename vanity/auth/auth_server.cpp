@@ -7,48 +7,24 @@
 
 namespace vanity {
 
-// write an auth_info to the output stream
+// an auth_info is written as its hash, then its auth level
 template<>
-void serializer::write(std::ofstream& out, const auth_info& value)
+struct serializer::serial<auth_info>
 {
-	write(out, value.hash);
-	write(out, value.auth);
-}
-
-// read an auth_info from the input stream
-template<>
-auth_info serializer::read(std::ifstream& in)
-{
-	auth_info value;
-	value.hash = read<std::string>(in);
-	value.auth = read<client_auth>(in);
-	return value;
-}
-
-// write a std::unordered_map<std::string, auth_info> to the output stream
-template<>
-void serializer::write(std::ofstream& out, const std::unordered_map<std::string, auth_info>& value)
-{
-	write(out, value.size());
-	for (const auto& [key, val] : value) {
-		write(out, key);
-		write(out, val);
+	template<Output Out>
+	static void write(Out& out, const auth_info& value) {
+		serializer::write(out, value.hash);
+		serializer::write(out, value.auth);
 	}
-}
 
-// read a std::unordered_map<std::string, auth_info> from the input stream
-template<>
-std::unordered_map<std::string, auth_info> serializer::read(std::ifstream& in)
-{
-	std::unordered_map<std::string, auth_info> value;
-	auto size = read<std::streamsize>(in);
-	for (size_t i = 0; i < size; ++i) {
-		auto key = read<std::string>(in);
-		auto val = read<auth_info>(in);
-		value.emplace(std::move(key), std::move(val));
+	template<Input In>
+	static auth_info read(In& in) {
+		auth_info value;
+		value.hash = serializer::read<std::string>(in);
+		value.auth = serializer::read<client_auth>(in);
+		return value;
 	}
-	return value;
-}
+};
 
 AuthServer::AuthServer(std::optional<std::filesystem::path> users_db) noexcept
 		: m_users_db{std::move(users_db)}
@@ -68,7 +44,10 @@ void AuthServer::persist_logins() {
 	auto tmp {m_users_db.value()};
 	tmp.replace_filename("tmp." + tmp.filename().string());
 	std::ofstream out{tmp, std::ios::binary};
-	serializer::write(out, m_logins);
+	{
+		serializer::BufferWriter writer{out};
+		serializer::write(writer, m_logins);
+	}
 	out.close();
 	std::filesystem::rename(tmp, m_users_db.value());
 
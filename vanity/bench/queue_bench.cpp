@@ -0,0 +1,56 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "utils/mpmc_queue.h"
+#include "utils/queue.h"
+
+
+// the number of elements passed through the queue in each run
+static constexpr size_t M_ELEMENTS = 1 << 20;
+
+// pass M_ELEMENTS through a queue with as many producers as consumers
+// returns the number of elements per second
+template<typename Q>
+static double run(size_t threads) {
+	Q queue;
+	auto half = threads / 2;
+	auto per_thread = M_ELEMENTS / half;
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads);
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < half; ++i) {
+		workers.emplace_back([&queue, per_thread] {
+			for (size_t j = 0; j < per_thread; ++j)
+				queue.push(static_cast<int>(j));
+		});
+		workers.emplace_back([&queue, per_thread] {
+			for (size_t j = 0; j < per_thread; ++j)
+				queue.get();
+		});
+	}
+
+	for (auto& worker : workers)
+		worker.join();
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return static_cast<double>(per_thread * half) / elapsed.count();
+}
+
+// compare Queue and MpmcQueue for 4 to 64 threads, half producing and half consuming
+int main() {
+	std::printf("%8s %16s %16s %8s\n", "threads", "Queue (ops/s)", "MpmcQueue (ops/s)", "speedup");
+	for (size_t threads = 4; threads <= 64; threads *= 2) {
+		auto locked = run<vanity::Queue<int>>(threads);
+		auto lock_free = run<vanity::MpmcQueue<int>>(threads);
+		std::printf("%8zu %16.0f %16.0f %7.2fx\n", threads, locked, lock_free, lock_free / locked);
+	}
+	return 0;
+}
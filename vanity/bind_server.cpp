@@ -15,6 +15,7 @@ BindServer::BindServer(std::string host, const std::vector<uint16_t>& ports, uin
 void BindServer::start() {
 	std::vector<uint16_t> ports {m_ports.begin(), m_ports.end()};
 	ports.push_back(m_cluster_port);
+	std::lock_guard lock{m_listeners_mutex};
 	m_listeners.reserve(ports.size());
 
 	for (auto& port : ports)
@@ -22,10 +23,12 @@ void BindServer::start() {
 }
 
 void BindServer::stop() {
+	std::lock_guard lock{m_listeners_mutex};
 	m_listeners.clear();
 }
 
 std::pair<std::string, uint16_t> BindServer::cluster_addr() const {
+	std::lock_guard lock{m_listeners_mutex};
 	return m_listeners.find({m_host, m_cluster_port})->second->get_host_and_port();
 }
 
@@ -33,6 +36,7 @@ void BindServer::request_bind(Client &client, const std::string &host, int64_t p
 	if (not validate_port(port))
 		return send(client, error("invalid port"));
 
+	std::lock_guard lock{m_listeners_mutex};
 	if (m_listeners.contains({host, port}))
 		return send(client, error("already bound to port"));
 
@@ -44,15 +48,20 @@ void BindServer::request_unbind(Client &client, const std::string &host, int64_t
 	if (not validate_port(port))
 		return send(client, error("invalid port"));
 
+	std::lock_guard lock{m_listeners_mutex};
 	if (m_listeners.size() == 1)
 		return send(client, error("cannot unbind last port"));
 
 	if (port == m_cluster_port and host == m_host)
 		return send(client, error("cannot unbind cluster port"));
 
-	if (m_listeners.erase({host, port}) == 0)
+	auto it = m_listeners.find({host, port});
+	if (it == m_listeners.end())
 		return send(client, error("was not bound to port"));
 
+	epoll_remove(*it->second);
+	m_listeners.erase(it);
+
 	send(client, ok());
 }
 
@@ -61,7 +70,7 @@ bool BindServer::validate_port(int64_t port) {
 }
 
 void BindServer::bind(const std::string &host, uint16_t port) {
-	auto it = m_listeners.insert({{host, port}, std::make_unique<SocketListener>(host.c_str(), port)}).first;
+	auto it = m_listeners.emplace(std::make_pair(host, port), std::make_unique<SocketListener>(host.c_str(), port)).first;
 	epoll_add(*it->second);
 
 	logger().info("Listening on " + host + ":" + std::to_string(port));
@@ -36,6 +36,9 @@ private:
 		boost_hash::hash<std::string, uint16_t>
 	> m_listeners;
 
+	// mutex for m_listeners
+	mutable std::mutex m_listeners_mutex;
+
 	// the host to bind to
 	std::string m_host;
 
@@ -70,6 +73,7 @@ protected:
 private:
 	// bind to a host and port
 	// requires that the host and port are not already bound
+	// assumes m_listeners_mutex is locked
 	void bind(const std::string& host, uint16_t port);
 };
 
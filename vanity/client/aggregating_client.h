@@ -33,6 +33,11 @@ public:
 		m_response.append(sendable);
 	}
 
+	// write the shared response to the aggregate instead of the client
+	void write_shared(WriteManager& manager, const Sendable::shared_data_t& response) override {
+		m_response.append(Sendable::body_of(response));
+	}
+
 	// write the aggregate response to the client
 	void perform_write(WriteManager& manager) {
 		client().write(manager, m_response.move());
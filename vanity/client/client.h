@@ -29,6 +29,9 @@ public:
 
 	// write a response to the client
 	virtual void write(WriteManager& manager, Sendable&& response) = 0;
+
+	// write a response shared with other clients to the client
+	virtual void write_shared(WriteManager& manager, const Sendable::shared_data_t& response) = 0;
 };
 
 } // namespace vanity
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "read_manager.h"
+#include "write_manager.h"
 
 
 namespace vanity {
@@ -19,7 +20,7 @@ class TcpClient;
 /*
  * A ClientManager is an interface for managing clients
  */
-class ClientManager : public virtual ReadManager
+class ClientManager : public virtual ReadManager, public virtual WriteManager
 {
 public:
 	using handle_callback_t = std::function<void(const std::string&)>;
@@ -31,6 +32,12 @@ public:
 	// remove a client
 	virtual void remove_client(TcpClient& client) = 0;
 
+	// stop reading from a client until it is resumed
+	virtual void pause_client(TcpClient& client) = 0;
+
+	// start reading from a paused client again
+	virtual void resume_client(TcpClient& client) = 0;
+
 	// get a callback for when a message is received
 	virtual handle_callback_t handle_callback(TcpClient& client) = 0;
 };
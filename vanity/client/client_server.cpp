@@ -31,6 +31,9 @@ public:
 	}
 };
 
+ClientServer::ClientServer(const output_limits_t& output_limits)
+	: m_output_limits{output_limits} { }
+
 void ClientServer::read_handler_ready(SocketReadHandler *handler) {
 	if (auto client = dynamic_cast<socket::ClientReadHandler*>(handler))
 		client->ready(as_client_manager());
@@ -47,17 +50,51 @@ ReadManager &ClientServer::as_read_manager() {
 }
 
 TcpClient& ClientServer::add_client(TcpClient &&client) {
-	auto& ptr = *m_clients.emplace(std::make_unique<TcpClient>(std::move(client))).first;
-	epoll_add(*ptr);
-	return *ptr;
+	auto ptr = std::make_unique<TcpClient>(std::move(client));
+	auto& ref = *ptr;
+	ref.set_output_limits(m_output_limits);
+	{
+		std::lock_guard lock{m_clients_mutex};
+		m_clients.emplace(std::move(ptr));
+	}
+	epoll_add(ref);
+	return ref;
 }
 
 void ClientServer::remove_client(TcpClient &client) {
 	pre_client_delete(client);
 	epoll_remove(client);
+
+	std::lock_guard lock{m_clients_mutex};
 	m_clients.erase(bad_ptr{&client});
 }
 
+void ClientServer::pause_client(TcpClient &client) {
+	epoll_pause(client);
+}
+
+void ClientServer::resume_client(TcpClient &client) {
+	epoll_resume(client);
+}
+
+void ClientServer::request_client_output(Client &client) {
+	db::hash_t output;
+	{
+		std::lock_guard lock{m_clients_mutex};
+		for (const auto& tcp_client : m_clients) {
+			try {
+				auto [host, port] = tcp_client->remote_addr();
+				auto addr = host + ":" + std::to_string(port);
+				output.emplace(std::move(addr), std::to_string(tcp_client->output_pending()));
+			}
+			catch (const SocketError&) {
+				// the client has disconnected, and is about to be removed
+			}
+		}
+	}
+	send(client, ok(output));
+}
+
 auto ClientServer::handle_callback(TcpClient& client) -> handle_callback_t {
 	return [this, &client](const auto& msg) {
 		handle(msg, client);
@@ -68,7 +105,12 @@ void ClientServer::send(Client &client, Sendable&& sendable) {
 	client.write(*this, sendable.move());
 }
 
+void ClientServer::send_shared(Client &client, const Sendable::shared_data_t& data) {
+	client.write_shared(*this, data);
+}
+
 void ClientServer::stop() {
+	std::lock_guard lock{m_clients_mutex};
 	m_clients.clear();
 }
 
@@ -5,10 +5,14 @@
 #ifndef VANITY_CLIENT_SERVER_H
 #define VANITY_CLIENT_SERVER_H
 
+#include <mutex>
 #include <unordered_set>
 
 #include "abstract_server.h"
+#include "client/output_limits.h"
 #include "client/tcp_client.h"
+#include "request/request_handler.h"
+#include "response/response_server.h"
 #include "socket/epoll_server.h"
 
 
@@ -20,12 +24,20 @@ namespace vanity {
 class ClientServer:
 	public virtual AbstractServer,
 	public virtual ClientManager,
+	public virtual RequestHandler,
+	public virtual ResponseServer,
 	public virtual socket::EpollServer
 {
 private:
 	// the current set of clients
 	std::unordered_set<std::unique_ptr<TcpClient>> m_clients;
 
+	// the output limits of the clients
+	output_limits_t m_output_limits;
+
+	// mutex for m_clients
+	std::mutex m_clients_mutex;
+
 	// cast this to a ClientManager
 	ClientManager& as_client_manager();
 
@@ -36,18 +48,36 @@ private:
 	void read_handler_ready(SocketReadHandler *handler) override;
 
 public:
+	// create a client server with the default output limits
+	ClientServer() = default;
+
+	// create a client server with these output limits
+	explicit ClientServer(const output_limits_t& output_limits);
+
 	// add a new client
 	TcpClient& add_client(TcpClient&& client) override;
 
 	// remove a client
 	void remove_client(TcpClient& client) override;
 
+	// stop reading from a client until it is resumed
+	void pause_client(TcpClient& client) override;
+
+	// start reading from a paused client again
+	void resume_client(TcpClient& client) override;
+
+	// a client_output request was received from a client
+	void request_client_output(Client& client) override;
+
 	// get a callback for when a message is received
 	handle_callback_t handle_callback(TcpClient& client) override;
 
 	// send a message to a client
 	void send(Client& client, Sendable&& sendable) override;
 
+	// send a message shared with other clients to a client
+	void send_shared(Client& client, const Sendable::shared_data_t& data);
+
 protected:
 	// stop the server
 	// this will remove all clients
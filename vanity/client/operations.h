@@ -6,6 +6,7 @@
 #define VANITY_OPERATIONS_H
 
 #include "session_info.h"
+#include "utils/string_trie.h"
 
 namespace vanity {
 
@@ -18,6 +19,7 @@ enum class operation_t{
 
 	BIND,
 	UNBIND,
+	CLIENT_OUTPUT,
 
 	ADD_USER,
 	EDIT_USER,
@@ -39,6 +41,9 @@ enum class operation_t{
 	SUBSCRIBED,
 	UNSUBSCRIBE,
 	UNSUBSCRIBE_ALL,
+	PSUBSCRIBE,
+	PSUBSCRIBED,
+	PUNSUBSCRIBE,
 
 	DEL,
 	TYPE,
@@ -114,7 +119,8 @@ enum class operation_t{
 	PEER_AUTH,
 };
 
-const std::initializer_list<std::pair<operation_t, std::string>> OPERATION_T_STRINGS {
+// the strings that represent the operations
+inline constexpr auto OPERATION_T_STRINGS = std::to_array<std::pair<operation_t, std::string_view>>({
 	{operation_t::EXIT,               "EXIT"},
 	{operation_t::TERMINATE,          "TERMINATE"},
 	{operation_t::PING,               "PING"},
@@ -122,6 +128,7 @@ const std::initializer_list<std::pair<operation_t, std::string>> OPERATION_T_STR
 
 	{operation_t::BIND,               "BIND"},
 	{operation_t::UNBIND,             "UNBIND"},
+	{operation_t::CLIENT_OUTPUT,      "CLIENT_OUTPUT"},
 
 	{operation_t::AUTH_LEVEL,         "AUTH_LEVEL"},
 	{operation_t::AUTH,               "AUTH"},
@@ -143,6 +150,9 @@ const std::initializer_list<std::pair<operation_t, std::string>> OPERATION_T_STR
 	{operation_t::SUBSCRIBE,          "SUBSCRIBE"},
 	{operation_t::UNSUBSCRIBE_ALL,    "UNSUBSCRIBE_ALL"},
 	{operation_t::UNSUBSCRIBE,        "UNSUBSCRIBE"},
+	{operation_t::PSUBSCRIBED,        "PSUBSCRIBED"},
+	{operation_t::PSUBSCRIBE,         "PSUBSCRIBE"},
+	{operation_t::PUNSUBSCRIBE,       "PUNSUBSCRIBE"},
 
 	{operation_t::DEL,                "DEL"},
 	{operation_t::TYPE,               "TYPE"},
@@ -216,7 +226,10 @@ const std::initializer_list<std::pair<operation_t, std::string>> OPERATION_T_STR
 	{operation_t::PEERS,              "PEERS"},
 	{operation_t::PEER_IDS,           "PEER_IDS"},
 	{operation_t::PEER_AUTH,          "PEER_AUTH"},
-};
+});
+
+// finds the operation at the start of a request
+inline constexpr StringTrie<operation_t, trie_size(OPERATION_T_STRINGS)> OPERATION_T_TRIE {OPERATION_T_STRINGS};
 
 // check if an operation is permitted for an unknown client
 inline bool unknown_is_permitted(operation_t operation)
@@ -238,6 +251,7 @@ inline bool unknown_is_permitted(operation_t operation)
 
 		case operation_t::BIND:
 		case operation_t::UNBIND:
+		case operation_t::CLIENT_OUTPUT:
 
 		case operation_t::ADD_USER:
 		case operation_t::EDIT_USER:
@@ -257,6 +271,9 @@ inline bool unknown_is_permitted(operation_t operation)
 		case operation_t::SUBSCRIBED:
 		case operation_t::UNSUBSCRIBE:
 		case operation_t::UNSUBSCRIBE_ALL:
+		case operation_t::PSUBSCRIBE:
+		case operation_t::PSUBSCRIBED:
+		case operation_t::PUNSUBSCRIBE:
 
 		case operation_t::DEL:
 		case operation_t::TYPE:
@@ -361,6 +378,9 @@ inline bool user_is_permitted(operation_t operation)
 		case operation_t::SUBSCRIBED:
 		case operation_t::UNSUBSCRIBE:
 		case operation_t::UNSUBSCRIBE_ALL:
+		case operation_t::PSUBSCRIBE:
+		case operation_t::PSUBSCRIBED:
+		case operation_t::PUNSUBSCRIBE:
 
 		case operation_t::DEL:
 		case operation_t::TYPE:
@@ -430,6 +450,7 @@ inline bool user_is_permitted(operation_t operation)
 
 		case operation_t::BIND:
 		case operation_t::UNBIND:
+		case operation_t::CLIENT_OUTPUT:
 
 		case operation_t::RESET:
 
@@ -537,6 +558,7 @@ inline bool peer_is_permitted(operation_t operation)
 
 		case operation_t::BIND:
 		case operation_t::UNBIND:
+		case operation_t::CLIENT_OUTPUT:
 
 		case operation_t::AUTH:
 		case operation_t::CHANGE_PASSWORD:
@@ -555,6 +577,9 @@ inline bool peer_is_permitted(operation_t operation)
 		case operation_t::SUBSCRIBED:
 		case operation_t::UNSUBSCRIBE:
 		case operation_t::UNSUBSCRIBE_ALL:
+		case operation_t::PSUBSCRIBE:
+		case operation_t::PSUBSCRIBED:
+		case operation_t::PUNSUBSCRIBE:
 
 		case operation_t::CLUSTER_JOIN:
 		case operation_t::CLUSTER_KEY:
@@ -582,6 +607,7 @@ inline bool admin_is_permitted(operation_t operation)
 
 		case operation_t::BIND:
 		case operation_t::UNBIND:
+		case operation_t::CLIENT_OUTPUT:
 
 		case operation_t::ADD_USER:
 		case operation_t::EDIT_USER:
@@ -602,6 +628,9 @@ inline bool admin_is_permitted(operation_t operation)
 		case operation_t::SUBSCRIBED:
 		case operation_t::UNSUBSCRIBE:
 		case operation_t::UNSUBSCRIBE_ALL:
+		case operation_t::PSUBSCRIBE:
+		case operation_t::PSUBSCRIBED:
+		case operation_t::PUNSUBSCRIBE:
 
 		case operation_t::DEL:
 		case operation_t::TYPE:
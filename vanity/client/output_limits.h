@@ -0,0 +1,77 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_OUTPUT_LIMITS_H
+#define VANITY_OUTPUT_LIMITS_H
+
+#include <cstddef>
+
+#include "session_info.h"
+
+
+namespace vanity {
+
+// the kinds of clients, each with their own output limits
+enum class client_class {
+	NORMAL,
+	PUBSUB,
+	PEER,
+};
+
+// the class of a client with the given session info
+inline client_class class_of(const session_info& info) {
+	if (std::holds_alternative<peer_data_t>(info.session_data))
+		return client_class::PEER;
+
+	auto user_data = std::get_if<user_data_t>(&info.session_data);
+	if (user_data and not (user_data->channels.empty() and user_data->patterns.empty()))
+		return client_class::PUBSUB;
+
+	return client_class::NORMAL;
+}
+
+/*
+ * An output_limit_t bounds the bytes waiting to be written to a client
+ *
+ * A client over its soft limit is not read from until its output
+ * drains back below it, a client over its hard limit is disconnected
+ * A limit of 0 means no limit
+ */
+struct output_limit_t {
+	// disconnect the client above this
+	size_t hard = 0;
+
+	// stop reading from the client above this
+	size_t soft = 0;
+};
+
+// the output limits of each client class
+struct output_limits_t {
+	static constexpr size_t MiB = 1024 * 1024;
+
+	// limits for normal clients
+	output_limit_t normal {0, 8 * MiB};
+
+	// limits for clients subscribed to a channel
+	output_limit_t pubsub {32 * MiB, 8 * MiB};
+
+	// limits for peers in a cluster
+	output_limit_t peer {256 * MiB, 64 * MiB};
+
+	// the limits of a client class
+	const output_limit_t& operator[](client_class cls) const {
+		switch (cls) {
+			case client_class::PUBSUB:
+				return pubsub;
+			case client_class::PEER:
+				return peer;
+			default:
+				return normal;
+		}
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_OUTPUT_LIMITS_H
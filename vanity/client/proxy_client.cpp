@@ -20,6 +20,10 @@ void ProxyClient::write(WriteManager& manager, Sendable &&sendable) {
 	m_client.write(manager, std::move(sendable));
 }
 
+void ProxyClient::write_shared(WriteManager& manager, const Sendable::shared_data_t& response) {
+	m_client.write_shared(manager, response);
+}
+
 Client &ProxyClient::client() const {
 	return m_client;
 }
@@ -33,6 +33,9 @@ public:
 	// write a sendable to the client
 	void write(WriteManager& manager, Sendable&& sendable) override;
 
+	// write a shared response to the client
+	void write_shared(WriteManager& manager, const Sendable::shared_data_t& response) override;
+
 protected:
 	// get a reference to the underlying client
 	Client& client() const;
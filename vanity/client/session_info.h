@@ -39,6 +39,9 @@ struct user_data_t {
 	// the pubsub channels the client is subscribed to
 	channels_t channels;
 
+	// the pubsub channel patterns the client is subscribed to
+	channels_t patterns;
+
 	// the client's username
 	std::string username;
 
@@ -14,13 +14,61 @@ TcpClient::TcpClient(TcpClient &&other) noexcept
 	: m_socket(std::move(other.m_socket)), m_writer(m_socket) {}
 
 void TcpClient::ready(ClientManager& manager) {
-	auto callback = manager.handle_callback(*this);
+	auto handle = manager.handle_callback(*this);
+	auto callback = [this, &handle](const std::string& msg) {
+		handle(msg);
+		// stop at a message that closed the client
+		return not m_closed;
+	};
+
+	// hold back the responses to everything read now
+	// and write them together once it has all been handled
+	// shared responses, like published messages, are not held back
+	m_writer.cork();
 	if (not m_closed)
 		if (not m_reader.read(m_socket, callback))
 			m_closed = true;
+	m_writer.uncork(manager);
 
 	if (m_closed)
-		manager.remove_client(*this);
+		return manager.remove_client(*this);
+
+	// the messages may have changed what kind of client this is
+	m_class = class_of(m_session_info);
+	enforce_hard_limit();
+	enforce_soft_limit(manager);
+}
+
+output_limit_t TcpClient::output_limit() const {
+	if (not m_output_limits)
+		return {};
+
+	return (*m_output_limits)[m_class];
+}
+
+void TcpClient::enforce_hard_limit() {
+	auto hard = output_limit().hard;
+	if (hard == 0 or m_writer.pending() <= hard)
+		return;
+
+	// the read epoll sees the shutdown, and the client is removed from there
+	m_writer.close();
+	m_socket.shutdown();
+}
+
+void TcpClient::enforce_soft_limit(ClientManager& manager) {
+	auto soft = output_limit().soft;
+	if (soft == 0 or m_writer.pending() <= soft)
+		return;
+
+	manager.pause_client(*this);
+	auto resume = [this, &manager]() {
+		manager.resume_client(*this);
+	};
+
+	// the output may have drained while pausing
+	if (not m_writer.notify_below(soft, resume))
+		resume();
 }
 
 bool TcpClient::has_perm(operation_t op) const {
@@ -33,6 +81,12 @@ struct session_info &TcpClient::session_info() {
 
 void TcpClient::write(WriteManager& manager, Sendable &&sendable) {
 	m_writer.write(manager, sendable.extract_data());
+	enforce_hard_limit();
+}
+
+void TcpClient::write_shared(WriteManager& manager, const Sendable::shared_data_t& response) {
+	m_writer.write(manager, response);
+	enforce_hard_limit();
 }
 
 int TcpClient::socket_fd() const {
@@ -43,6 +97,18 @@ void TcpClient::close() {
 	m_closed = true;
 }
 
+void TcpClient::set_output_limits(const output_limits_t& limits) {
+	m_output_limits = &limits;
+}
+
+size_t TcpClient::output_pending() const {
+	return m_writer.pending();
+}
+
+std::pair<std::string, uint16_t> TcpClient::remote_addr() const {
+	return m_socket.get_remote_addr();
+}
+
 std::pair<std::string, uint16_t> TcpClient::local_addr() const {
 	return m_socket.get_local_addr();
 }
@@ -5,7 +5,10 @@
 #ifndef VANITY_TCP_CLIENT_H
 #define VANITY_TCP_CLIENT_H
 
+#include <atomic>
+
 #include "client.h"
+#include "output_limits.h"
 #include "socket/client_read_handler.h"
 #include "socket/socket_reader.h"
 #include "socket/socket_writer.h"
@@ -38,6 +41,21 @@ private:
 	// whether the client has been closed
 	bool m_closed = false;
 
+	// the output limits of each client class, if any
+	const output_limits_t* m_output_limits = nullptr;
+
+	// the class of the client as of the last messages it sent
+	std::atomic<client_class> m_class = client_class::NORMAL;
+
+	// the output limit of the client's current class
+	output_limit_t output_limit() const;
+
+	// disconnect the client if its output is over the hard limit
+	void enforce_hard_limit();
+
+	// stop reading from the client until its output is under the soft limit
+	void enforce_soft_limit(ClientManager& manager);
+
 public:
 	// create a client
 	explicit TcpClient(Socket&& socket);
@@ -60,12 +78,24 @@ public:
 	// write a sendable to the client
 	void write(WriteManager& manager, Sendable&& sendable) override;
 
+	// write a shared response to the client, even while its responses are held back
+	void write_shared(WriteManager& manager, const Sendable::shared_data_t& response) override;
+
 	// get the socket file descriptor
 	int socket_fd() const override;
 
 	// close the client
 	void close();
 
+	// apply these output limits to the client
+	void set_output_limits(const output_limits_t& limits);
+
+	// the number of bytes waiting to be written to the client
+	size_t output_pending() const;
+
+	// return this client's remote socket address
+	std::pair<std::string, uint16_t> remote_addr() const;
+
 	// return this client's local socket address
 	std::pair<std::string, uint16_t> local_addr() const;
 };
@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include "utils/string_trie.h"
+
 namespace vanity {
 
 // all the possible operations that a peer can request
@@ -23,7 +25,7 @@ enum class peer_op_t : uint {
 };
 
 // the strings that represent the operations
-const std::initializer_list<std::pair<peer_op_t, std::string>> PEER_OP_STRINGS {
+inline constexpr auto PEER_OP_STRINGS = std::to_array<std::pair<peer_op_t, std::string_view>>({
 	{peer_op_t::PING,               "PING"},
 	{peer_op_t::EXIT,               "EXIT"},
 
@@ -31,7 +33,10 @@ const std::initializer_list<std::pair<peer_op_t, std::string>> PEER_OP_STRINGS {
 	{peer_op_t::PEERS,              "PEERS"},
 
 	{peer_op_t::ASK_EVICT,          "ASK_EVICT"},
-};
+});
+
+// finds the operation at the start of a peer request
+inline constexpr StringTrie<peer_op_t, trie_size(PEER_OP_STRINGS)> PEER_OP_TRIE {PEER_OP_STRINGS};
 
 // all the possible async operations that a peer can send
 enum class async_op_t : uint {
@@ -41,9 +46,12 @@ enum class async_op_t : uint {
 };
 
 // the strings that represent the async operations
-const std::initializer_list<std::pair<async_op_t, std::string>> ASYNC_OP_STRINGS {
+inline constexpr auto ASYNC_OP_STRINGS = std::to_array<std::pair<async_op_t, std::string_view>>({
 	{async_op_t::PULSE,             "PULSE"},
-};
+});
+
+// finds the async operation at the start of a peer request
+inline constexpr StringTrie<async_op_t, trie_size(ASYNC_OP_STRINGS)> ASYNC_OP_TRIE {ASYNC_OP_STRINGS};
 
 // the type of the identifier of a message
 using msg_id_t = int64_t;
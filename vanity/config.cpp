@@ -2,6 +2,8 @@
 // Created by kingsli on 1/14/24.
 //
 
+#include <algorithm>
+
 #include "config.h"
 
 namespace vanity {
@@ -28,6 +30,8 @@ Config::Config(const Arguments &args) {
 	extract_auth_file(args);
 	extract_lock_file(args);
 	extract_journal_file(args);
+
+	extract_output_limits(args);
 }
 
 void Config::extract_working_dir(const Arguments& args) {
@@ -108,6 +112,25 @@ void Config::extract_auth_file(const Arguments& args) {
 void Config::extract_wal_file(const Arguments &args) {
 	if (working_dir and not args.has("no_wal"))
 		wal_file = *working_dir / WAL_FILE;
+
+	wal_fsync_policy = extract_wal_fsync_policy(args);
+}
+
+wal::fsync_policy_t Config::extract_wal_fsync_policy(const Arguments &args) {
+	if (not args.has_kwarg("wal_fsync"))
+		return DEFAULT_WAL_FSYNC_POLICY;
+
+	auto policy = args.get_kwarg("wal_fsync");
+	to_lower(policy);
+
+	if (policy == "always")
+		return wal::fsync_policy_t::always;
+	else if (policy == "everysec")
+		return wal::fsync_policy_t::everysec;
+	else if (policy == "os")
+		return wal::fsync_policy_t::os;
+	else
+		throw std::invalid_argument("unknown WAL fsync policy: " + policy);
 }
 
 void Config::extract_journal_file(const Arguments &) {
@@ -134,6 +157,50 @@ void Config::extract_cluster_port(const Arguments &args) {
 		cluster_port = get_default_cluster_port();
 }
 
+void Config::extract_output_limits(const Arguments &args) {
+	if (args.has_kwarg("output_limit_normal"))
+		output_limits.normal = extract_output_limit(args.get_kwarg("output_limit_normal"));
+
+	if (args.has_kwarg("output_limit_pubsub"))
+		output_limits.pubsub = extract_output_limit(args.get_kwarg("output_limit_pubsub"));
+
+	if (args.has_kwarg("output_limit_peer"))
+		output_limits.peer = extract_output_limit(args.get_kwarg("output_limit_peer"));
+}
+
+output_limit_t Config::extract_output_limit(const std::string &limit) {
+	auto colon = limit.find(':');
+	if (colon == std::string::npos)
+		throw std::invalid_argument("output limit must be <hard>:<soft>, got: " + limit);
+
+	return {
+		extract_size(limit.substr(0, colon)),
+		extract_size(limit.substr(colon + 1))
+	};
+}
+
+size_t Config::extract_size(std::string size) {
+	to_lower(size);
+
+	size_t multiplier = 1;
+	if (size.ends_with('k'))
+		multiplier = 1024;
+	else if (size.ends_with('m'))
+		multiplier = 1024 * 1024;
+	else if (size.ends_with('g'))
+		multiplier = 1024 * 1024 * 1024;
+
+	if (multiplier != 1)
+		size.pop_back();
+
+	size_t pos;
+	auto value = std::stoull(size, &pos);
+	if (pos != size.size())
+		throw std::invalid_argument("invalid size: " + size);
+
+	return value * multiplier;
+}
+
 uint16_t Config::get_default_cluster_port() {
 	auto port = ports.back();
 	ports.pop_back();
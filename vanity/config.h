@@ -12,6 +12,8 @@
 #include <vector>
 
 #include "arguments.h"
+#include "client/output_limits.h"
+#include "db/wal/fsync_policy_t.h"
 #include "utils/logger.h"
 
 namespace vanity {
@@ -52,6 +54,9 @@ private:
 	// extract the wal file
 	void extract_wal_file(const Arguments& args);
 
+	// extract and returns the WAL fsync policy from the arguments
+	static wal::fsync_policy_t extract_wal_fsync_policy(const Arguments& args);
+
 	// extract the journal file
 	void extract_journal_file(const Arguments&);
 
@@ -64,12 +69,22 @@ private:
 	// extract the cluster port
 	void extract_cluster_port(const Arguments& args);
 
+	// extract the output limits of each client class
+	void extract_output_limits(const Arguments& args);
+
+	// extract one output limit, formatted as <hard>:<soft>
+	static output_limit_t extract_output_limit(const std::string& limit);
+
+	// extract a size in bytes, with an optional k, m or g suffix
+	static size_t extract_size(std::string size);
+
 	// get the default cluster port
 	// this pops the last port from the ports vector
 	uint16_t get_default_cluster_port();
 
 public:
 	constexpr static auto DEFAULT_LOG_LEVEL = LogLevel::INFO;
+	constexpr static auto DEFAULT_WAL_FSYNC_POLICY = wal::fsync_policy_t::everysec;
 	constexpr static auto DEFAULT_PORTS = {9955, 19955};
 	constexpr static auto DEFAULT_HOST = "localhost";
 	constexpr static auto DEFAULT_HOME_DIR = ".vanity";
@@ -92,6 +107,8 @@ public:
 	uint16_t cluster_port;
 	std::vector<uint16_t> ports;
 	LogLevel log_level = DEFAULT_LOG_LEVEL;
+	wal::fsync_policy_t wal_fsync_policy = DEFAULT_WAL_FSYNC_POLICY;
+	output_limits_t output_limits;
 
 	Config(const Arguments& args);
 };
@@ -5,7 +5,9 @@
 #ifndef VANITY_BASE_MAP_H
 #define VANITY_BASE_MAP_H
 
+#include "sharded_map.h"
 #include "types.h"
+#include "value.h"
 
 namespace vanity::db {
 
@@ -16,10 +18,14 @@ class BaseMap
 {
 protected:
 	using key_type = db_key_type;
+	using key_view_type = db_key_view_type;
 	using data_type = db_data_type;
+	// values are stored compactly, and handed out as a data_type
+	using value_type = Value;
 
-	// the key value store
-	std::unordered_map<key_type, data_type> m_data;
+	// the key value store, and each key's expiry time
+	// split into shards, so each shard can be locked separately
+	ShardedMap<key_type, value_type, string_hash> m_data;
 };
 
 } // namespace vanity::db
@@ -0,0 +1,164 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include <algorithm>
+
+#include "compact_hash.h"
+
+
+namespace vanity::db {
+
+auto CompactHash::find(const compact_type &compact, std::string_view key) -> compact_type::const_iterator {
+	return std::find_if(compact.begin(), compact.end(), [key](const auto& pair) {
+		return pair.first.size() == key.size() and pair.first == key;
+	});
+}
+
+void CompactHash::convert() {
+	auto& compact = std::get<compact_type>(m_data);
+	table_type table;
+	table.reserve(compact.size() * 2);
+	for (auto& [key, value] : compact)
+		table.emplace(std::move(key), std::move(value));
+
+	m_data = std::move(table);
+}
+
+
+CompactHash::const_iterator::const_iterator(compact_type::const_iterator it) : m_it{it} {}
+
+CompactHash::const_iterator::const_iterator(table_type::const_iterator it) : m_it{it} {}
+
+auto CompactHash::const_iterator::operator*() const -> reference {
+	return std::visit([](const auto& it) { return reference{it->first, it->second}; }, m_it);
+}
+
+auto CompactHash::const_iterator::operator++() -> const_iterator& {
+	std::visit([](auto& it) { ++it; }, m_it);
+	return *this;
+}
+
+auto CompactHash::const_iterator::operator++(int) -> const_iterator {
+	auto copy = *this;
+	++*this;
+	return copy;
+}
+
+
+CompactHash::CompactHash(std::initializer_list<std::pair<std::string, std::string>> pairs) {
+	for (const auto& [key, value] : pairs)
+		insert_or_assign(key, value);
+}
+
+size_t CompactHash::size() const {
+	return std::visit([](const auto& data) { return data.size(); }, m_data);
+}
+
+bool CompactHash::empty() const {
+	return size() == 0;
+}
+
+bool CompactHash::is_compact() const {
+	return std::holds_alternative<compact_type>(m_data);
+}
+
+auto CompactHash::begin() const -> const_iterator {
+	return std::visit([](const auto& data) { return const_iterator{data.begin()}; }, m_data);
+}
+
+auto CompactHash::end() const -> const_iterator {
+	return std::visit([](const auto& data) { return const_iterator{data.end()}; }, m_data);
+}
+
+const std::string *CompactHash::find(std::string_view key) const {
+	if (auto compact = std::get_if<compact_type>(&m_data)) {
+		auto it = find(*compact, key);
+		return it == compact->end() ? nullptr : &it->second;
+	}
+
+	auto& table = std::get<table_type>(m_data);
+	auto it = table.find(key);
+	return it == table.end() ? nullptr : &it->second;
+}
+
+std::string *CompactHash::find(std::string_view key) {
+	return const_cast<std::string*>(std::as_const(*this).find(key));
+}
+
+bool CompactHash::contains(std::string_view key) const {
+	return find(key) != nullptr;
+}
+
+bool CompactHash::emplace(std::string key, std::string value) {
+	if (contains(key))
+		return false;
+
+	insert_or_assign(std::move(key), std::move(value));
+	return true;
+}
+
+bool CompactHash::insert_or_assign(std::string key, std::string value) {
+	if (auto existing = find(key)) {
+		*existing = std::move(value);
+		return false;
+	}
+
+	if (auto compact = std::get_if<compact_type>(&m_data)) {
+		if (compact->size() < M_MAX_COMPACT) {
+			compact->emplace_back(std::move(key), std::move(value));
+			return true;
+		}
+
+		convert();
+	}
+
+	std::get<table_type>(m_data).emplace(std::move(key), std::move(value));
+	return true;
+}
+
+size_t CompactHash::erase(std::string_view key) {
+	if (auto compact = std::get_if<compact_type>(&m_data)) {
+		auto it = find(*compact, key);
+		if (it == compact->end())
+			return 0;
+
+		// order does not matter, so fill the gap with the last pair
+		auto& slot = (*compact)[it - compact->begin()];
+		if (&slot != &compact->back())
+			slot = std::move(compact->back());
+		compact->pop_back();
+		return 1;
+	}
+
+	auto& table = std::get<table_type>(m_data);
+	auto it = table.find(key);
+	if (it == table.end())
+		return 0;
+
+	table.erase(it);
+	return 1;
+}
+
+void CompactHash::reserve(size_t size) {
+	if (size > M_MAX_COMPACT and is_compact())
+		convert();
+
+	if (auto compact = std::get_if<compact_type>(&m_data))
+		compact->reserve(size);
+	else
+		std::get<table_type>(m_data).reserve(size);
+}
+
+void CompactHash::clear() {
+	m_data = compact_type{};
+}
+
+bool CompactHash::operator==(const CompactHash &other) const {
+	return size() == other.size() and std::all_of(begin(), end(), [&other](const auto& pair) {
+		auto value = other.find(pair.first);
+		return value and *value == pair.second;
+	});
+}
+
+} // namespace vanity::db
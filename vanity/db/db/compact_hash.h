@@ -0,0 +1,145 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_COMPACT_HASH_H
+#define VANITY_COMPACT_HASH_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "utils/hash.h"
+
+
+namespace vanity::db {
+
+/*
+ * A CompactHash is a map of strings to strings that is stored
+ * compactly while it is small
+ *
+ * Up to M_MAX_COMPACT pairs are kept in a flat vector, and found by
+ * scanning it, comparing key sizes before contents. Past that, the hash
+ * converts to a hash table for good, so hashes that shrink again do
+ * not convert back and forth
+ */
+class CompactHash
+{
+private:
+	// the most pairs the compact encoding holds
+	static constexpr size_t M_MAX_COMPACT = 64;
+
+	using compact_type = std::vector<std::pair<std::string, std::string>>;
+	using table_type = std::unordered_map<std::string, std::string, string_hash, std::equal_to<>>;
+
+	// the pairs, in either encoding
+	std::variant<compact_type, table_type> m_data;
+
+	// the position of a key in the compact encoding, or its end
+	static compact_type::const_iterator find(const compact_type& compact, std::string_view key);
+
+	// convert to the hash table encoding
+	void convert();
+
+public:
+	/*
+	 * A const_iterator walks the pairs of a CompactHash,
+	 * yielding references to each key and value
+	 */
+	class const_iterator
+	{
+	private:
+		// the position in the encoding
+		std::variant<compact_type::const_iterator, table_type::const_iterator> m_it;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<std::string, std::string>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::pair<const std::string&, const std::string&>;
+
+		const_iterator() = default;
+
+		// an iterator at a position in the compact encoding
+		explicit const_iterator(compact_type::const_iterator it);
+
+		// an iterator at a position in the hash table encoding
+		explicit const_iterator(table_type::const_iterator it);
+
+		// the key and value
+		reference operator*() const;
+
+		// move to the next pair
+		const_iterator& operator++();
+
+		// move to the next pair
+		const_iterator operator++(int);
+
+		// whether two iterators are at the same pair
+		bool operator==(const const_iterator& other) const = default;
+	};
+
+	using key_type = std::string;
+	using mapped_type = std::string;
+	using size_type = size_t;
+	using iterator = const_iterator;
+
+	// create an empty hash
+	CompactHash() = default;
+
+	// create a hash of some pairs
+	CompactHash(std::initializer_list<std::pair<std::string, std::string>> pairs);
+
+	// the number of pairs
+	size_t size() const;
+
+	// whether there are no pairs
+	bool empty() const;
+
+	// whether the hash is in the compact encoding
+	bool is_compact() const;
+
+	// the first pair
+	const_iterator begin() const;
+
+	// past the last pair
+	const_iterator end() const;
+
+	// the value of a key, or nullptr if it is not in the hash
+	const std::string* find(std::string_view key) const;
+
+	// the value of a key, or nullptr if it is not in the hash
+	std::string* find(std::string_view key);
+
+	// whether a key is in the hash
+	bool contains(std::string_view key) const;
+
+	// add a pair, if the key is not already in the hash
+	// returns whether it was added
+	bool emplace(std::string key, std::string value);
+
+	// add a pair, replacing the value if the key is already in the hash
+	// returns whether the key is new
+	bool insert_or_assign(std::string key, std::string value);
+
+	// remove a key
+	// returns the number of pairs removed
+	size_t erase(std::string_view key);
+
+	// make room for some number of pairs
+	void reserve(size_t size);
+
+	// remove all pairs
+	void clear();
+
+	// whether two hashes have the same pairs
+	bool operator==(const CompactHash& other) const;
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_COMPACT_HASH_H
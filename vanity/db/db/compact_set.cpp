@@ -0,0 +1,240 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include <algorithm>
+
+#include "compact_set.h"
+
+
+namespace vanity::db {
+
+auto CompactSet::find(const compact_type &compact, std::string_view value) -> compact_type::const_iterator {
+	return std::find_if(compact.begin(), compact.end(), [value](const std::string& element) {
+		return element.size() == value.size() and element == value;
+	});
+}
+
+void CompactSet::convert_from_intset() {
+	auto& ints = std::get<IntSet>(m_data);
+	std::vector<std::string> values;
+	values.reserve(ints.size() + 1);
+	for (auto value : ints)
+		values.push_back(std::to_string(value));
+
+	if (values.size() < M_MAX_COMPACT) {
+		m_data = std::move(values);
+		return;
+	}
+
+	table_type table;
+	table.reserve(values.size() * 2);
+	for (auto& value : values)
+		table.insert(std::move(value));
+
+	m_data = std::move(table);
+}
+
+void CompactSet::convert() {
+	auto& compact = std::get<compact_type>(m_data);
+	table_type table;
+	table.reserve(compact.size() * 2);
+	for (auto& value : compact)
+		table.insert(std::move(value));
+
+	m_data = std::move(table);
+}
+
+
+CompactSet::const_iterator::const_iterator(IntSet::const_iterator it) : m_it{it} {}
+
+CompactSet::const_iterator::const_iterator(compact_type::const_iterator it) : m_it{it} {}
+
+CompactSet::const_iterator::const_iterator(table_type::const_iterator it) : m_it{it} {}
+
+const std::string &CompactSet::const_iterator::operator*() const {
+	if (auto ints = std::get_if<IntSet::const_iterator>(&m_it)) {
+		m_formatted = std::to_string(**ints);
+		return m_formatted;
+	}
+
+	if (auto compact = std::get_if<compact_type::const_iterator>(&m_it))
+		return **compact;
+
+	return *std::get<table_type::const_iterator>(m_it);
+}
+
+const std::string *CompactSet::const_iterator::operator->() const {
+	return &**this;
+}
+
+auto CompactSet::const_iterator::operator++() -> const_iterator& {
+	std::visit([](auto& it) { ++it; }, m_it);
+	return *this;
+}
+
+auto CompactSet::const_iterator::operator++(int) -> const_iterator {
+	auto copy = *this;
+	++*this;
+	return copy;
+}
+
+bool CompactSet::const_iterator::operator==(const const_iterator &other) const {
+	return m_it == other.m_it;
+}
+
+
+CompactSet::CompactSet(std::initializer_list<std::string> values) {
+	for (const auto& value : values)
+		insert(value);
+}
+
+CompactSet::CompactSet(IntSet values) : m_data{std::move(values)} {
+	if (std::get<IntSet>(m_data).size() > M_MAX_INTSET)
+		convert_from_intset();
+}
+
+size_t CompactSet::size() const {
+	return std::visit([](const auto& data) { return data.size(); }, m_data);
+}
+
+bool CompactSet::empty() const {
+	return size() == 0;
+}
+
+bool CompactSet::is_compact() const {
+	return std::holds_alternative<compact_type>(m_data);
+}
+
+const IntSet *CompactSet::intset() const {
+	return std::get_if<IntSet>(&m_data);
+}
+
+auto CompactSet::begin() const -> const_iterator {
+	return std::visit([](const auto& data) { return const_iterator{data.begin()}; }, m_data);
+}
+
+auto CompactSet::end() const -> const_iterator {
+	return std::visit([](const auto& data) { return const_iterator{data.end()}; }, m_data);
+}
+
+bool CompactSet::contains(std::string_view value) const {
+	if (auto ints = std::get_if<IntSet>(&m_data)) {
+		auto number = IntSet::parse(value);
+		return number and ints->contains(*number);
+	}
+
+	if (auto compact = std::get_if<compact_type>(&m_data))
+		return find(*compact, value) != compact->end();
+
+	return std::get<table_type>(m_data).contains(value);
+}
+
+bool CompactSet::insert(std::string value) {
+	if (auto ints = std::get_if<IntSet>(&m_data)) {
+		auto number = IntSet::parse(value);
+		if (number and (ints->size() < M_MAX_INTSET or ints->contains(*number)))
+			return ints->insert(*number);
+
+		convert_from_intset();
+	}
+
+	if (auto compact = std::get_if<compact_type>(&m_data)) {
+		if (find(*compact, value) != compact->end())
+			return false;
+
+		if (compact->size() < M_MAX_COMPACT) {
+			compact->push_back(std::move(value));
+			return true;
+		}
+
+		convert();
+	}
+
+	return std::get<table_type>(m_data).insert(std::move(value)).second;
+}
+
+bool CompactSet::emplace(std::string value) {
+	return insert(std::move(value));
+}
+
+size_t CompactSet::erase(std::string_view value) {
+	if (auto ints = std::get_if<IntSet>(&m_data)) {
+		auto number = IntSet::parse(value);
+		return number ? ints->erase(*number) : 0;
+	}
+
+	if (auto compact = std::get_if<compact_type>(&m_data)) {
+		auto it = find(*compact, value);
+		if (it == compact->end())
+			return 0;
+
+		// order does not matter, so fill the gap with the last element
+		auto& slot = (*compact)[it - compact->begin()];
+		if (&slot != &compact->back())
+			slot = std::move(compact->back());
+		compact->pop_back();
+		return 1;
+	}
+
+	auto& table = std::get<table_type>(m_data);
+	auto it = table.find(value);
+	if (it == table.end())
+		return 0;
+
+	table.erase(it);
+	return 1;
+}
+
+void CompactSet::merge(CompactSet &&other) {
+	if (empty()) {
+		*this = std::move(other);
+		return;
+	}
+
+	if (intset() and other.intset()) {
+		*this = CompactSet{IntSet::set_union(*intset(), *other.intset())};
+	}
+	else if (other.intset()) {
+		for (const auto& value : other)
+			insert(value);
+	}
+	else if (auto compact = std::get_if<compact_type>(&other.m_data)) {
+		for (auto& value : *compact)
+			insert(std::move(value));
+	}
+	else {
+		auto& table = std::get<table_type>(other.m_data);
+		reserve(size() + table.size());
+		while (not table.empty())
+			insert(std::move(table.extract(table.begin()).value()));
+	}
+
+	other.clear();
+}
+
+void CompactSet::reserve(size_t size) {
+	// whether an intset stays one depends on what is added
+	if (intset())
+		return;
+
+	if (size > M_MAX_COMPACT and is_compact())
+		convert();
+
+	if (auto compact = std::get_if<compact_type>(&m_data))
+		compact->reserve(size);
+	else
+		std::get<table_type>(m_data).reserve(size);
+}
+
+void CompactSet::clear() {
+	m_data = IntSet{};
+}
+
+bool CompactSet::operator==(const CompactSet &other) const {
+	return size() == other.size() and std::all_of(begin(), end(), [&other](const std::string& value) {
+		return other.contains(value);
+	});
+}
+
+} // namespace vanity::db
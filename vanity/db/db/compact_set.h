@@ -0,0 +1,173 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_COMPACT_SET_H
+#define VANITY_COMPACT_SET_H
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "intset.h"
+#include "utils/hash.h"
+
+
+namespace vanity::db {
+
+/*
+ * A CompactSet is a set of strings that is stored
+ * compactly while it is small or all numbers
+ *
+ * While every element is the decimal form of an integer, and there are
+ * at most M_MAX_INTSET of them, the set is an IntSet. Otherwise, up to
+ * M_MAX_COMPACT elements are kept in a flat vector, and found by
+ * scanning it, comparing sizes before contents. Past that, the set
+ * converts to a hash table for good, so sets that shrink again do
+ * not convert back and forth
+ */
+class CompactSet
+{
+private:
+	// the most elements the intset encoding holds
+	static constexpr size_t M_MAX_INTSET = 8192;
+
+	// the most elements the compact encoding holds
+	static constexpr size_t M_MAX_COMPACT = 64;
+
+	using compact_type = std::vector<std::string>;
+	using table_type = std::unordered_set<std::string, string_hash, std::equal_to<>>;
+
+	// the elements, in one of the encodings
+	std::variant<IntSet, compact_type, table_type> m_data;
+
+	// the position of an element in the compact encoding, or its end
+	static compact_type::const_iterator find(const compact_type& compact, std::string_view value);
+
+	// convert from the intset encoding to one that holds strings,
+	// with room for one more element
+	void convert_from_intset();
+
+	// convert to the hash table encoding
+	void convert();
+
+public:
+	/*
+	 * A const_iterator walks the elements of a CompactSet
+	 * An element of an intset is formatted when it is read, so a reference
+	 * to it is only valid until the iterator moves
+	 */
+	class const_iterator
+	{
+	private:
+		// the position in the encoding
+		std::variant<IntSet::const_iterator, compact_type::const_iterator, table_type::const_iterator> m_it;
+
+		// the formatted element of an intset
+		mutable std::string m_formatted;
+
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::string;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const std::string*;
+		using reference = const std::string&;
+
+		const_iterator() = default;
+
+		// an iterator at a position in the intset encoding
+		explicit const_iterator(IntSet::const_iterator it);
+
+		// an iterator at a position in the compact encoding
+		explicit const_iterator(compact_type::const_iterator it);
+
+		// an iterator at a position in the hash table encoding
+		explicit const_iterator(table_type::const_iterator it);
+
+		// the element
+		const std::string& operator*() const;
+
+		// the element
+		const std::string* operator->() const;
+
+		// move to the next element
+		const_iterator& operator++();
+
+		// move to the next element
+		const_iterator operator++(int);
+
+		// whether two iterators are at the same element
+		bool operator==(const const_iterator& other) const;
+	};
+
+	using value_type = std::string;
+	using size_type = size_t;
+	using iterator = const_iterator;
+
+	// create an empty set
+	CompactSet() = default;
+
+	// create a set of some strings
+	CompactSet(std::initializer_list<std::string> values);
+
+	// create a set of the decimal forms of some integers
+	explicit CompactSet(IntSet values);
+
+	// create a set of the strings in a range
+	template<typename It>
+	CompactSet(It first, It last) {
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	// the number of elements
+	size_t size() const;
+
+	// whether there are no elements
+	bool empty() const;
+
+	// whether the set is in the compact encoding
+	bool is_compact() const;
+
+	// the integers in the set, if it is in the intset encoding
+	const IntSet* intset() const;
+
+	// the first element
+	const_iterator begin() const;
+
+	// past the last element
+	const_iterator end() const;
+
+	// whether a value is in the set
+	bool contains(std::string_view value) const;
+
+	// add a value
+	// returns whether it was not already in the set
+	bool insert(std::string value);
+
+	// add a value
+	// returns whether it was not already in the set
+	bool emplace(std::string value);
+
+	// remove a value
+	// returns the number of values removed
+	size_t erase(std::string_view value);
+
+	// move the elements of another set into this one
+	void merge(CompactSet&& other);
+
+	// make room for some number of elements
+	void reserve(size_t size);
+
+	// remove all elements
+	void clear();
+
+	// whether two sets have the same elements
+	bool operator==(const CompactSet& other) const;
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_COMPACT_SET_H
@@ -17,25 +17,66 @@ Database &Database::operator=(Database &&other) noexcept {
 Database::Database(Database &&other) noexcept
 	: BaseDatabase(std::move(other)) {}
 
-void Database::persist(std::ofstream &out) {
-	serializer::write(out, m_index);
-	serializer::write(out, m_data);
-	serializer::write(out, m_expiry_times);
-}
+void Database::persist_shard(serializer::BufferWriter &out, const shard_type& shard, const preserved_keys& preserved) {
+	auto unchanged = [&preserved](const key_type& key) {
+		return preserved.empty() or not preserved.contains(key);
+	};
+
+	// the live keys that did not change, then the preserved ones
+	auto size = shard.size();
+	auto expiring = shard.expiring();
+	for (const auto& [key, entry] : preserved) {
+		if (shard.contains(key)) {
+			size -= 1;
+			expiring -= shard.expiry(key) != nullptr;
+		}
+		if (entry) {
+			size += 1;
+			expiring += entry->expiry.has_value();
+		}
+	}
+
+	serializer::write(out, size);
+	for (const auto& [key, value] : shard) {
+		if (unchanged(key)) {
+			serializer::write(out, key);
+			serializer::write(out, value);
+		}
+	}
+	for (const auto& [key, entry] : preserved) {
+		if (entry) {
+			serializer::write(out, key);
+			serializer::write(out, entry->value);
+		}
+	}
 
-Database Database::from(std::ifstream &in) {
-	auto index = serializer::read<m_index_type>(in);
-	Database db {index};
+	// then the expiry times, as a map of keys to times
+	serializer::write(out, expiring);
+	for (auto it = shard.begin(); it != shard.end(); ++it) {
+		auto expiry_time = it.expiry();
+		if (expiry_time and unchanged(it->first)) {
+			serializer::write(out, it->first);
+			serializer::write(out, *expiry_time);
+		}
+	}
+	for (const auto& [key, entry] : preserved) {
+		if (entry and entry->expiry) {
+			serializer::write(out, key);
+			serializer::write(out, *entry->expiry);
+		}
+	}
+}
 
+void Database::load_shard(serializer::SpanReader &in) {
 	auto size = serializer::read<size_t>(in);
 	for (size_t i = 0; i < size; ++i)
-		db.m_data.insert(serializer::read<db_key_type, db_data_type>(in));
+		m_data.insert(serializer::read<db_key_type, Value>(in));
 
 	size = serializer::read<size_t>(in);
-	for (size_t i = 0; i < size; ++i)
-		db.m_expiry_times.insert(serializer::read<db_key_type, time_t>(in));
-
-	return db;
+	for (size_t i = 0; i < size; ++i) {
+		auto [key, expiry_time] = serializer::read<db_key_type, time_t>(in);
+		add_expiry(key, expiry_time);
+	}
 }
 
 } // namespace vanity::db
\ No newline at end of file
@@ -5,11 +5,15 @@
 #ifndef VANITY_DATABASE_H
 #define VANITY_DATABASE_H
 
+#include <optional>
+#include <unordered_map>
+
 #include "general_database.h"
 #include "hash_database.h"
 #include "primitive_database.h"
 #include "list_database.h"
 #include "set_database.h"
+#include "utils/serializer.h"
 
 
 namespace vanity::db {
@@ -30,6 +34,29 @@ protected:
 	// the index of this database
 	m_index_type m_index = 0;
 
+	// a shard of the keyspace
+	using shard_type = decltype(m_data)::map_type;
+
+	// a key as it was when a snapshot began
+	struct preserved_key {
+		// the value
+		value_type value;
+
+		// the expiry time, if any
+		std::optional<time_t> expiry;
+	};
+
+	// keys as they were when a snapshot began,
+	// nullopt for keys that did not exist then
+	using preserved_keys = std::unordered_map<key_type, std::optional<preserved_key>, string_hash, std::equal_to<>>;
+
+	// persist the keys of a shard, with their expiry times,
+	// as they were before the keys in preserved changed
+	static void persist_shard(serializer::BufferWriter &out, const shard_type& shard, const preserved_keys& preserved);
+
+	// load keys persisted by persist_shard(), with their expiry times
+	void load_shard(serializer::SpanReader &in);
+
 public:
 	// create a new database
 	explicit Database(m_index_type index);
@@ -43,12 +70,6 @@ public:
 
 	// move assignment
 	Database& operator=(Database&& other) noexcept;
-
-	// persist the database to a file stream
-	void persist(std::ofstream &out);
-
-	// load the database from a file stream
-	static Database from(std::ifstream &in);
 };
 
 } // namespace vanity::db
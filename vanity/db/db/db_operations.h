@@ -86,7 +86,8 @@ enum class db_op_t : uint8_t {
 };
 
 // check if a db_op_t should be written to the WAL
-inline bool should_wal(db_op_t op)
+// only operations that modify the database are
+constexpr bool should_wal(db_op_t op)
 {
 	switch (op) {
 		case db_op_t::has:
@@ -172,6 +173,10 @@ inline bool should_wal(db_op_t op)
 	}
 }
 
+// true if db_op_t op should be written to the WAL, at compile time
+template<db_op_t op>
+inline constexpr bool should_wal_v = should_wal(op);
+
 } // namespace vanity::db
 
 #endif // VANITY_DB_OPERATIONS_H
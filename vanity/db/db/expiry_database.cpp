@@ -3,77 +3,131 @@
 //
 
 #include <algorithm>
+#include <limits>
 #include <random>
 #include <ranges>
+#include <unordered_set>
 
 #include "expiry_database.h"
+#include "utils/cached_clock.h"
 
 
 namespace vanity::db {
 
+thread_local bool ExpiryDatabase::t_expiry_deferred = false;
+
 ExpiryDatabase::ExpiryDatabase() = default;
 
-void ExpiryDatabase::expire(const key_type& key) {
+ExpiryDatabase::ExpiryDeferral::ExpiryDeferral() : m_previous{t_expiry_deferred} {
+	t_expiry_deferred = true;
+}
+
+ExpiryDatabase::ExpiryDeferral::~ExpiryDeferral() {
+	t_expiry_deferred = m_previous;
+}
+
+void ExpiryDatabase::expire(key_view_type key) {
 	pre_expire(key);
 	_do_expire(key);
 }
 
-void ExpiryDatabase::_do_expire(const key_type &key) {
+void ExpiryDatabase::_do_expire(key_view_type key) {
 	m_data.erase(key);
 	clear_expiry(key);
 }
 
-bool ExpiryDatabase::is_expired(const key_type &key) {
+bool ExpiryDatabase::is_expired(key_view_type key) {
 	if (not m_expiry_enabled)
 		return false;
 
-	if (not m_expiry_times.contains(key))
-		return false;
-
-	return std::chrono::system_clock::now() > m_expiry_times[key];
+	auto expiry_time = m_data.expiry(key);
+	return expiry_time and CachedClock::now() > *expiry_time;
 }
 
-bool ExpiryDatabase::erase_if_expired(const key_type &key) {
-	if (not is_expired(key))
+bool ExpiryDatabase::erase_if_expired(key_view_type key) {
+	if (t_expiry_deferred or not is_expired(key))
 		return false;
 
 	expire(key);
 	return true;
 }
 
-void ExpiryDatabase::clear_expiry(const key_type &key) {
-	m_expiry_times.erase(key);
+void ExpiryDatabase::clear_expiry(key_view_type key) {
+	m_data.clear_expiry(key);
 }
 
 void ExpiryDatabase::set_expiry(const key_type &key, time_t expiry_time) {
-	if (m_data.contains(key))
-		m_expiry_times[key] = expiry_time;
+	add_expiry(key, expiry_time);
+}
+
+void ExpiryDatabase::add_expiry(const key_type &key, time_t expiry_time) {
+	// an entry due by the old expiry time is moved to the new one when it comes up
+	auto previous = m_data.expiry(key);
+	auto armed = previous and *previous <= expiry_time;
+	if (not m_data.set_expiry(key, expiry_time) or armed)
+		return;
+
+	auto shard = shard_of(key);
+	auto& wheel = m_expiry_wheels[shard];
+	wheel.insert(key, expiry_time);
+
+	// entries whose expiry time was cleared, re-armed or brought forward wait
+	// until they are due to be dropped or moved, so rebuild the wheel once they
+	// outnumber the rest
+	if (wheel.size() > 2 * m_data.shard(shard).expiring() + M_MIN_WHEEL_REBUILD)
+		rebuild_wheel(shard);
 }
 
-std::optional<time_t> ExpiryDatabase::get_expiry(const key_type &key) {
+void ExpiryDatabase::rebuild_wheel(size_t shard) {
+	auto& wheel = m_expiry_wheels[shard];
+	auto entries = wheel.take_all();
+
+	// every expiring key has an entry, so keep the first one of each, due at its expiry time
+	// the keys are only moved out of the entries once they have all been looked at
+	std::vector<bool> keep(entries.size());
+	std::unordered_set<key_view_type> kept;
+	for (size_t i = 0; i < entries.size(); ++i) {
+		auto expiry_time = m_data.expiry(entries[i].value);
+		if (not expiry_time or not kept.insert(entries[i].value).second)
+			continue;
+
+		entries[i].due = *expiry_time;
+		keep[i] = true;
+	}
+
+	for (size_t i = 0; i < entries.size(); ++i)
+		if (keep[i])
+			wheel.insert(std::move(entries[i].value), entries[i].due);
+}
+
+std::optional<time_t> ExpiryDatabase::get_expiry(key_view_type key) {
 	erase_if_expired(key);
-	if (not m_expiry_times.contains(key))
-		return std::nullopt;
+	if (auto expiry_time = m_data.expiry(key))
+		return *expiry_time;
 
-	return m_expiry_times[key];
+	return std::nullopt;
 }
 
 void ExpiryDatabase::clear_all_expiry() {
-	m_expiry_times.clear();
+	m_data.clear_all_expiry();
+	for (auto& wheel: m_expiry_wheels)
+		wheel.clear();
 }
 
 void ExpiryDatabase::shallow_purge() {
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
+	thread_local std::random_device rd;
+	thread_local std::mt19937 gen(rd());
 
-	while (not m_expiry_times.empty())
+	while (m_data.expiring() > 0)
 	{
-		auto size = std::min(M_MAX_SAMPLE_SIZE, m_expiry_times.size());
+		auto size = std::min(M_MAX_SAMPLE_SIZE, m_data.expiring());
 		std::vector<key_type> keys;
 		keys.reserve(size);
 
-		auto all_keys = m_expiry_times | std::views::keys;
-		std::ranges::sample(all_keys, back_inserter(keys), size, gen);
+		auto expiring_keys = m_data
+			| std::views::filter([this](const auto& entry) { return m_data.expiry(entry.first) != nullptr; })
+			| std::views::transform([](const auto& entry) -> const key_type& { return entry.first; });
+		std::ranges::sample(expiring_keys, back_inserter(keys), size, gen);
 
 		size_t expired_count = 0;
 		for (auto& key: keys)
@@ -86,27 +140,65 @@ void ExpiryDatabase::shallow_purge() {
 }
 
 void ExpiryDatabase::deep_purge() {
-	std::vector<key_type> expired_keys;
-	for (auto& key: std::views::keys(m_expiry_times))
-		if (is_expired(key))
-			expired_keys.push_back(key);
+	for (size_t shard = 0; shard < M_NUM_SHARDS; ++shard)
+		purge_expired(shard, std::numeric_limits<size_t>::max());
+}
+
+bool ExpiryDatabase::purge_expired(size_t shard, size_t limit) {
+	if (not m_expiry_enabled)
+		return false;
+
+	auto& wheel = m_expiry_wheels[shard];
+	wheel.advance(CachedClock::now());
+
+	// not yet past the expiry time, or due later than the entry was
+	std::vector<TimingWheel<key_type>::entry> not_yet;
+
+	// whether any entry was expired, dropped or moved
+	bool progressed = false;
+	for (auto& entry: wheel.take_due(limit)) {
+		// the expiry time was cleared, or brought forward and given its own entry
+		auto expiry_time = m_data.expiry(entry.value);
+		if (not expiry_time or *expiry_time < entry.due) {
+			progressed = true;
+			continue;
+		}
+
+		// the expiry time was pushed back, so the entry came up early,
+		// or cleared and set again, so the key now has another entry too
+		if (*expiry_time > entry.due) {
+			entry.due = *expiry_time;
+			not_yet.push_back(std::move(entry));
+			progressed = true;
+		}
+		else if (is_expired(entry.value)) {
+			expire(entry.value);
+			progressed = true;
+		}
+		else
+			not_yet.push_back(std::move(entry));
+	}
+
+	// entries due later in this tick are put back behind the rest, and a
+	// slice of only those would take the same ones again, so stop there
+	auto more = progressed and wheel.has_due();
+	wheel.put_back(std::move(not_yet));
 
-	for (auto& key: expired_keys)
-		expire(key);
+	return more;
 }
 
 void ExpiryDatabase::expiry_enabled(bool enable) {
 	m_expiry_enabled = enable;
 }
 
-void ExpiryDatabase::force_expire(const key_type &key) {
+void ExpiryDatabase::force_expire(key_view_type key) {
 	_do_expire(key);
 }
 
-auto ExpiryDatabase::expiry_aware_get(const key_type &key) -> std::optional<const data_type> {
+auto ExpiryDatabase::expiry_aware_get(key_view_type key) -> std::optional<const data_type> {
 	erase_if_expired(key);
-	if (m_data.contains(key))
-		return m_data.at(key);
+	if (auto value = m_data.find(key))
+		return value->data();
 	return std::nullopt;
 }
 
@@ -8,6 +8,7 @@
 #include <functional>
 
 #include "base_map.h"
+#include "utils/timing_wheel.h"
 
 
 namespace vanity::db {
@@ -18,8 +19,13 @@ namespace vanity::db {
 class ExpiryDatabase: public BaseMap
 {
 protected:
-	// the expiry times for the keys
-	std::unordered_map<key_type, time_t> m_expiry_times;
+	// the keys with expiry times, indexed by when they expire, one wheel per shard
+	// an expiring key has an entry due no later than its expiry time: pushing
+	// the expiry time back leaves the entry in place to be moved when it is due,
+	// and clearing it leaves a stale entry that is skipped when it is due,
+	// unless the key is given an expiry time again, when both entries stay live
+	// stale entries are bounded: the wheel is rebuilt past twice the expiring keys
+	std::array<TimingWheel<key_type>, M_NUM_SHARDS> m_expiry_wheels;
 
 private:
 	// whether key expiring should actually happen
@@ -34,11 +40,17 @@ private:
 	// for shallow purge to stop
 	static constexpr double M_MIN_EXPIRED_PERCENTAGE = 0.25;
 
+	// minimum number of skipped entries in a wheel before it is rebuilt
+	static constexpr size_t M_MIN_WHEEL_REBUILD = 1024;
+
 	// expire a key
-	void expire(const key_type& key);
+	void expire(key_view_type key);
 
 	// perform the actual key erasure
-	void _do_expire(const key_type& key);
+	void _do_expire(key_view_type key);
+
+	// whether erase_if_expired should leave expired keys in place on this thread
+	static thread_local bool t_expiry_deferred;
 
 public:
 	// create a new database
@@ -57,14 +69,14 @@ public:
 	// reset/clear the expiry time for a key
 	// this should be called after every operation
 	// that sets or resets the value for a key
-	void clear_expiry(const key_type &key);
+	void clear_expiry(key_view_type key);
 
 	// set the expiry time for a key
 	void set_expiry(const key_type &key, time_t expiry_time);
 
 	// get the expiry time for a key
 	// returns std::nullopt if the key has no expiry time
-	std::optional<time_t> get_expiry(const key_type &key);
+	std::optional<time_t> get_expiry(key_view_type key);
 
 	// clear all expiry times
 	void clear_all_expiry();
@@ -84,9 +96,15 @@ public:
 	// this deletes all expired keys in the database
 	// this is a deep purge, and is guaranteed to delete
 	// all expired keys in the database
-	// should not be called often
+	// it only visits keys that are due, so it costs time in
+	// the number of expired keys, not the number of keys
 	void deep_purge();
 
+	// delete up to limit expired keys in a shard
+	// returns whether there may be more expired keys in the shard,
+	// false once a call finds only keys due later in the current tick
+	bool purge_expired(size_t shard, size_t limit);
+
 	// enable or disable global expiry for this database
 	// when enabled, expiry works as normal and keys are expired
 	// when their expiry time is met
@@ -96,33 +114,66 @@ public:
 	void expiry_enabled(bool enable);
 
 protected:
+	/*
+	 * While an ExpiryDeferral is alive, erase_if_expired leaves expired
+	 * keys in place on the current thread instead of erasing them,
+	 * so read-only operations never modify the database
+	 */
+	class ExpiryDeferral
+	{
+	private:
+		// whether expiry was already deferred
+		bool m_previous;
+
+	public:
+		// defer expiry on this thread
+		ExpiryDeferral();
+
+		// no copy
+		ExpiryDeferral(const ExpiryDeferral&) = delete;
+		ExpiryDeferral& operator=(const ExpiryDeferral&) = delete;
+
+		// restore expiry on this thread
+		~ExpiryDeferral();
+	};
+
 	// get the value for a key, checking if it is expired
 	// returns the value, or std::nullopt if the key does not exist
 	// or if it is expired
-	std::optional<const data_type> expiry_aware_get(const key_type& key);
+	std::optional<const data_type> expiry_aware_get(key_view_type key);
 
 	// delete the value for a key
 	// and clear the expiry time
 	bool expiry_aware_del(const key_type& key);
 
 	// check if the key is is_expired
-	bool is_expired(const key_type &key);
+	bool is_expired(key_view_type key);
 
 	// delete key if it is expired
 	// this should be called before every operation
 	// on a key
+	// does nothing while expiry is deferred
 	// returns true if the key was deleted, false otherwise
-	bool erase_if_expired(const key_type &key);
+	bool erase_if_expired(key_view_type key);
+
+	// record the expiry time for a key that was just added
+	// to this database, as when it is loaded or moved in
+	void add_expiry(const key_type &key, time_t expiry_time);
+
+	// drop the skipped entries from a shard's wheel,
+	// leaving one entry per expiring key, due at its expiry time
+	// this only looks at the wheel's entries, not the shard's keys
+	void rebuild_wheel(size_t shard);
 
 	// manually trigger a key to be expired
 	// this bypasses all checks and will remove the key
 	// even if the expiry time isn't passed or if
 	// expiry has been otherwise disabled
 	// will not trigger the on_expire callback
-	void force_expire(const key_type& key);
+	void force_expire(key_view_type key);
 
 	// function called before a key is expired
-	virtual void pre_expire(const key_type& key) { }
+	virtual void pre_expire(key_view_type) { }
 };
 
 } // namespace vanity::db
@@ -16,12 +16,12 @@ GeneralDatabase &GeneralDatabase::operator=(GeneralDatabase &&other) noexcept {
 	return *this;
 }
 
-bool GeneralDatabase::has(const key_type& key) {
+bool GeneralDatabase::has(key_view_type key) {
 	erase_if_expired(key);
 	return m_data.contains(key);
 }
 
-auto GeneralDatabase::get(const key_type& key) -> std::optional<const data_type> {
+auto GeneralDatabase::get(key_view_type key) -> std::optional<const data_type> {
 	return expiry_aware_get(key);
 }
 
@@ -34,7 +34,7 @@ bool GeneralDatabase::del(const key_type& key) {
 	return expiry_aware_del(key);
 }
 
-std::optional<int> GeneralDatabase::type(const key_type &key) {
+std::optional<int> GeneralDatabase::type(key_view_type key) {
 	erase_if_expired(key);
 	if (m_data.contains(key))
 		return m_data.at(key).index();
@@ -59,7 +59,9 @@ bool GeneralDatabase::copy_to(const key_type &from, const key_type &to) {
 	if (from == to)
 		return true;
 
-	m_data[to] = m_data.at(from);
+	// inserting may move the entry, so copy it out first
+	auto value = m_data.at(from);
+	m_data[to] = std::move(value);
 	clear_expiry(to);
 	return true;
 }
@@ -72,9 +74,11 @@ bool GeneralDatabase::move_to(const key_type &from, const key_type &to) {
 	if (from == to)
 		return true;
 
-	m_data[to] = std::move(m_data.at(from));
-	if (m_expiry_times.contains(from))
-		m_expiry_times[to] = m_expiry_times.at(from);
+	// inserting may move the entry, so move it out first
+	auto value = std::move(m_data.at(from));
+	m_data[to] = std::move(value);
+	if (auto expiry_time = m_data.expiry(from))
+		add_expiry(to, *expiry_time);
 
 	del(from);
 	return true;
@@ -102,8 +106,8 @@ bool GeneralDatabase::move_to_db(const key_type &from, GeneralDatabase &to) {
 		return true;
 
 	to.m_data[from] = std::move(m_data.at(from));
-	if (m_expiry_times.contains(from))
-		to.m_expiry_times[from] = m_expiry_times.at(from);
+	if (auto expiry_time = m_data.expiry(from))
+		to.add_expiry(from, *expiry_time);
 
 	del(from);
 	return true;
@@ -33,13 +33,13 @@ public:
 	void reset();
 
 	// check if the key exists
-	bool has(const key_type& key);
+	bool has(key_view_type key);
 
 	// get the value for a key
-	std::optional<const data_type> get(const key_type& key);
+	std::optional<const data_type> get(key_view_type key);
 
 	// get the type of key as an index
-	std::optional<int> type(const key_type& key);
+	std::optional<int> type(key_view_type key);
 
 	// delete the value for a key
 	bool del(const key_type& key);
@@ -21,74 +21,76 @@ void HashDatabase::hash_set(const key_type &key, hash_t values) {
 	clear_expiry(key);
 }
 
-std::variant<hash_t, HashError> HashDatabase::hash_all(const key_type &key) {
+std::variant<hash_t, HashError> HashDatabase::hash_all(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return hash_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	return std::get<hash_t>(value);
+	return value.get<hash_t>();
 }
 
-std::variant<string_t, HashError> HashDatabase::hash_get(const key_type &key, const string_t &hash_key) {
+std::variant<string_t, HashError> HashDatabase::hash_get(key_view_type key, std::string_view hash_key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return HashError::BadKey;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
-	if (not hash.contains(hash_key))
+	auto& hash = value.get<hash_t>();
+	auto hash_value = hash.find(hash_key);
+	if (not hash_value)
 		return HashError::BadKey;
 
-	return hash.at(hash_key);
+	return *hash_value;
 }
 
-std::variant<bool, HashError> HashDatabase::hash_contains(const key_type &key, const string_t &hash_key) {
+std::variant<bool, HashError> HashDatabase::hash_contains(key_view_type key, std::string_view hash_key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return false;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	return hash.contains(hash_key);
 }
 
-std::variant<size_t, HashError> HashDatabase::hash_len(const key_type &key) {
+std::variant<size_t, HashError> HashDatabase::hash_len(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	return hash.size();
 }
 
-std::variant<size_t, HashError> HashDatabase::hash_key_len(const key_type &key, const string_t &hash_key) {
+std::variant<size_t, HashError> HashDatabase::hash_key_len(key_view_type key, std::string_view hash_key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return HashError::BadKey;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
-	if (not hash.contains(hash_key))
+	auto& hash = value.get<hash_t>();
+	auto hash_value = hash.find(hash_key);
+	if (not hash_value)
 		return HashError::BadKey;
 
-	return hash.at(hash_key).size();
+	return hash_value->size();
 }
 
 std::variant<size_t, HashError> HashDatabase::hash_remove(const key_type &key, const std::vector<string_t> &hash_keys) {
@@ -97,10 +99,10 @@ std::variant<size_t, HashError> HashDatabase::hash_remove(const key_type &key, c
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	size_t size = hash.size();
 	for (const auto& hash_key : hash_keys)
 		hash.erase(hash_key);
@@ -111,16 +113,16 @@ std::variant<size_t, HashError> HashDatabase::hash_remove(const key_type &key, c
 	return size - hash.size();
 }
 
-std::variant<std::vector<string_t>, HashError> HashDatabase::hash_keys(const key_type &key) {
+std::variant<std::vector<string_t>, HashError> HashDatabase::hash_keys(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return std::vector<string_t>{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	std::vector<string_t> keys;
 	keys.reserve(hash.size());
 	for (const auto& [k, _] : hash)
@@ -129,16 +131,16 @@ std::variant<std::vector<string_t>, HashError> HashDatabase::hash_keys(const key
 	return keys;
 }
 
-std::variant<std::vector<string_t>, HashError> HashDatabase::hash_values(const key_type &key) {
+std::variant<std::vector<string_t>, HashError> HashDatabase::hash_values(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return std::vector<string_t>{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	std::vector<string_t> values;
 	values.reserve(hash.size());
 	for (const auto& [_, v] : hash)
@@ -153,39 +155,36 @@ std::variant<size_t, HashError> HashDatabase::hash_update(const key_type &key, h
 		m_data[key] = {};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	size_t size = hash.size();
-	for (auto it = values.begin(); it != values.end(); ++it)
-		if (hash.contains(it->first))
-			hash[it->first] = it->second;
-		else
-			hash.insert(values.extract(it));
+	for (const auto& [hash_key, hash_value] : values)
+		hash.insert_or_assign(hash_key, hash_value);
 
 	return hash.size() - size;
 }
 
 std::variant<std::vector<std::optional<string_t>>, HashError>
-HashDatabase::hash_many_get(const key_type &key, const std::vector<string_t> &hash_keys) {
+HashDatabase::hash_many_get(key_view_type key, const std::vector<string_t> &hash_keys) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return std::vector<std::optional<string_t>>{hash_keys.size(), std::nullopt};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<hash_t>(value))
+	if (not value.holds<hash_t>())
 		return HashError::NotHash;
 
-	auto& hash = std::get<hash_t>(value);
+	auto& hash = value.get<hash_t>();
 	std::vector<std::optional<string_t>> values;
 	values.reserve(hash_keys.size());
 
 	for (const auto& hash_key : hash_keys)
-		if (not hash.contains(hash_key))
-			values.emplace_back(std::nullopt);
+		if (auto hash_value = hash.find(hash_key))
+			values.emplace_back(*hash_value);
 		else
-			values.emplace_back(hash.at(hash_key));
+			values.emplace_back(std::nullopt);
 
 	return values;
 }
@@ -40,30 +40,30 @@ public:
 	// get all elements from a hash key
 	// returns the elements,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<hash_t, HashError> hash_all(const key_type &key);
+	std::variant<hash_t, HashError> hash_all(key_view_type key);
 
 	// get the value of a hash key
 	// returns the value,
 	// or HashError::NotHash if the value is not a hash
 	// or HashError::BadKey if key does not exist
 	// or hash_key does not exist in the hash
-	std::variant<string_t, HashError> hash_get(const key_type &key, const string_t& hash_key);
+	std::variant<string_t, HashError> hash_get(key_view_type key, std::string_view hash_key);
 
 	// check if a hash key contains a value
 	// returns true if the value exists,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<bool, HashError> hash_contains(const key_type &key, const string_t& hash_key);
+	std::variant<bool, HashError> hash_contains(key_view_type key, std::string_view hash_key);
 
 	// get the length of a hash
 	// returns the length, 0 if value does not exist or is empty,
 	// or HashError::NotHash if the value exists and is not a hash
-	std::variant<size_t, HashError> hash_len(const key_type &key);
+	std::variant<size_t, HashError> hash_len(key_view_type key);
 
 	// get the length of a hash key
 	// returns the length, 0 if value does not exist or is empty,
 	// or HashError::NotHash if the value exists and is not a hash
 	// or HashError::BadKey if the hash_key does not exist in the hash
-	std::variant<size_t, HashError> hash_key_len(const key_type &key, const string_t& hash_key);
+	std::variant<size_t, HashError> hash_key_len(key_view_type key, std::string_view hash_key);
 
 	// remove elements from a hash key
 	// return the number of elements removed,
@@ -73,12 +73,12 @@ public:
 	// get all keys from a hash key
 	// returns the keys,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<std::vector<string_t>, HashError> hash_keys(const key_type &key);
+	std::variant<std::vector<string_t>, HashError> hash_keys(key_view_type key);
 
 	// get all values from a hash key
 	// returns the values,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<std::vector<string_t>, HashError> hash_values(const key_type &key);
+	std::variant<std::vector<string_t>, HashError> hash_values(key_view_type key);
 
 	// update the contents of a hash
 	// returns the number of elements added,
@@ -89,7 +89,7 @@ public:
 	// returns the values,
 	// or HashError::NotHash if the value is not a hash
 	std::variant<std::vector<std::optional<string_t>>, HashError>
-	hash_many_get(const key_type &key, const std::vector<string_t>& hash_keys);
+	hash_many_get(key_view_type key, const std::vector<string_t>& hash_keys);
 };
 
 } // namespace vanity::db
@@ -0,0 +1,182 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+#include "intset.h"
+
+
+namespace vanity::db {
+
+void IntSet::widen_for(int64_t value) {
+	auto widen = [this]<typename To>(auto& from) {
+		std::vector<To> wider(from.begin(), from.end());
+		m_data = std::move(wider);
+	};
+
+	if (auto narrow = std::get_if<std::vector<int16_t>>(&m_data)) {
+		if (value >= std::numeric_limits<int16_t>::min() and value <= std::numeric_limits<int16_t>::max())
+			return;
+
+		if (value >= std::numeric_limits<int32_t>::min() and value <= std::numeric_limits<int32_t>::max())
+			widen.operator()<int32_t>(*narrow);
+		else
+			widen.operator()<int64_t>(*narrow);
+	}
+	else if (auto medium = std::get_if<std::vector<int32_t>>(&m_data)) {
+		if (value >= std::numeric_limits<int32_t>::min() and value <= std::numeric_limits<int32_t>::max())
+			return;
+
+		widen.operator()<int64_t>(*medium);
+	}
+}
+
+IntSet IntSet::from_sorted(const std::vector<int64_t> &values) {
+	IntSet set;
+	if (not values.empty()) {
+		set.widen_for(values.front());
+		set.widen_for(values.back());
+	}
+
+	std::visit([&values](auto& data) {
+		data.assign(values.begin(), values.end());
+	}, set.m_data);
+	return set;
+}
+
+
+IntSet::const_iterator::const_iterator(const IntSet *set, size_t index) : m_set{set}, m_index{index} {}
+
+int64_t IntSet::const_iterator::operator*() const {
+	return m_set->at(m_index);
+}
+
+auto IntSet::const_iterator::operator++() -> const_iterator& {
+	++m_index;
+	return *this;
+}
+
+auto IntSet::const_iterator::operator++(int) -> const_iterator {
+	auto copy = *this;
+	++*this;
+	return copy;
+}
+
+
+std::optional<int64_t> IntSet::parse(std::string_view value) {
+	auto digits = value.starts_with('-') ? value.substr(1) : value;
+	if (digits.empty() or (digits.front() == '0' and value.size() > 1))
+		return std::nullopt;
+
+	int64_t result = 0;
+	auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+	if (ec != std::errc{} or end != value.data() + value.size())
+		return std::nullopt;
+
+	return result;
+}
+
+size_t IntSet::size() const {
+	return std::visit([](const auto& data) { return data.size(); }, m_data);
+}
+
+bool IntSet::empty() const {
+	return size() == 0;
+}
+
+size_t IntSet::width() const {
+	return std::visit([](const auto& data) { return sizeof(data[0]); }, m_data);
+}
+
+int64_t IntSet::at(size_t index) const {
+	return std::visit([index](const auto& data) -> int64_t { return data[index]; }, m_data);
+}
+
+auto IntSet::begin() const -> const_iterator {
+	return {this, 0};
+}
+
+auto IntSet::end() const -> const_iterator {
+	return {this, size()};
+}
+
+bool IntSet::contains(int64_t value) const {
+	return std::visit([value](const auto& data) {
+		return std::binary_search(data.begin(), data.end(), value);
+	}, m_data);
+}
+
+bool IntSet::insert(int64_t value) {
+	widen_for(value);
+	return std::visit([value](auto& data) {
+		auto it = std::lower_bound(data.begin(), data.end(), value);
+		if (it != data.end() and *it == value)
+			return false;
+
+		data.insert(it, static_cast<typename std::decay_t<decltype(data)>::value_type>(value));
+		return true;
+	}, m_data);
+}
+
+size_t IntSet::erase(int64_t value) {
+	return std::visit([value](auto& data) -> size_t {
+		auto it = std::lower_bound(data.begin(), data.end(), value);
+		if (it == data.end() or *it != value)
+			return 0;
+
+		data.erase(it);
+		return 1;
+	}, m_data);
+}
+
+void IntSet::clear() {
+	m_data = std::vector<int16_t>{};
+}
+
+IntSet IntSet::set_union(const IntSet &a, const IntSet &b) {
+	std::vector<int64_t> result;
+	result.reserve(a.size() + b.size());
+	std::visit([&result](const auto& a, const auto& b) {
+		std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+	}, a.m_data, b.m_data);
+	return from_sorted(result);
+}
+
+IntSet IntSet::set_intersection(const IntSet &a, const IntSet &b) {
+	if (a.size() > b.size())
+		return set_intersection(b, a);
+
+	std::vector<int64_t> result;
+	result.reserve(a.size());
+	std::visit([&result](const auto& small, const auto& large) {
+		if (large.size() / M_SEARCH_RATIO < small.size()) {
+			std::set_intersection(small.begin(), small.end(), large.begin(), large.end(), std::back_inserter(result));
+			return;
+		}
+
+		// walking the large array would mostly skip, search it instead
+		auto from = large.begin();
+		for (auto value : small) {
+			from = std::lower_bound(from, large.end(), value);
+			if (from == large.end())
+				break;
+			if (*from == value)
+				result.push_back(value);
+		}
+	}, a.m_data, b.m_data);
+	return from_sorted(result);
+}
+
+IntSet IntSet::set_difference(const IntSet &a, const IntSet &b) {
+	std::vector<int64_t> result;
+	result.reserve(a.size());
+	std::visit([&result](const auto& a, const auto& b) {
+		std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+	}, a.m_data, b.m_data);
+	return from_sorted(result);
+}
+
+} // namespace vanity::db
@@ -0,0 +1,134 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_INTSET_H
+#define VANITY_INTSET_H
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+
+namespace vanity::db {
+
+/*
+ * An IntSet is a set of integers stored as a sorted array
+ *
+ * The array uses the narrowest of 16, 32 or 64 bit elements that fits
+ * every member, and widens when a member that does not fit is added.
+ * It never narrows again. Lookups are binary searches, and the set
+ * operations walk two sorted arrays together instead of probing a hash
+ * table per element.
+ */
+class IntSet
+{
+private:
+	// an intersection binary searches the larger array, instead of
+	// walking it, when it is this many times larger than the other
+	static constexpr size_t M_SEARCH_RATIO = 32;
+
+	using data_type = std::variant<std::vector<int16_t>, std::vector<int32_t>, std::vector<int64_t>>;
+
+	// the sorted members
+	data_type m_data;
+
+	// widen the array so that it can hold a value
+	void widen_for(int64_t value);
+
+	// a set of sorted, distinct values in the narrowest array that fits them
+	static IntSet from_sorted(const std::vector<int64_t>& values);
+
+public:
+	/*
+	 * A const_iterator walks an IntSet in ascending order
+	 */
+	class const_iterator
+	{
+	private:
+		// the set
+		const IntSet* m_set = nullptr;
+
+		// the index of the member
+		size_t m_index = 0;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = int64_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = int64_t;
+
+		const_iterator() = default;
+
+		// an iterator at an index of a set
+		const_iterator(const IntSet* set, size_t index);
+
+		// the member
+		int64_t operator*() const;
+
+		// move to the next member
+		const_iterator& operator++();
+
+		// move to the next member
+		const_iterator operator++(int);
+
+		// whether two iterators are at the same member
+		bool operator==(const const_iterator& other) const = default;
+	};
+
+	// the integer a string is the canonical decimal form of, if any
+	// "12" and "-3" are, "012", "+3", "-0" and "1.0" are not
+	static std::optional<int64_t> parse(std::string_view value);
+
+	// create an empty set
+	IntSet() = default;
+
+	// the number of members
+	size_t size() const;
+
+	// whether there are no members
+	bool empty() const;
+
+	// the number of bytes each member takes
+	size_t width() const;
+
+	// the member at an index, in ascending order
+	int64_t at(size_t index) const;
+
+	// the smallest member
+	const_iterator begin() const;
+
+	// past the largest member
+	const_iterator end() const;
+
+	// whether a value is in the set
+	bool contains(int64_t value) const;
+
+	// add a value
+	// returns whether it was not already in the set
+	bool insert(int64_t value);
+
+	// remove a value
+	// returns the number of values removed
+	size_t erase(int64_t value);
+
+	// remove all members
+	void clear();
+
+	// the members in either set
+	static IntSet set_union(const IntSet& a, const IntSet& b);
+
+	// the members in both sets
+	static IntSet set_intersection(const IntSet& a, const IntSet& b);
+
+	// the members of a that are not in b
+	static IntSet set_difference(const IntSet& a, const IntSet& b);
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_INTSET_H
@@ -0,0 +1,557 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_KEY_TABLE_H
+#define VANITY_KEY_TABLE_H
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+namespace vanity::db {
+
+/*
+ * A KeyTable is an open-addressing hash table that keeps a key, its
+ * value and its expiry time together in one slot
+ *
+ * Slots are probed eight at a time: each slot has a control byte that
+ * is either empty, deleted, or seven bits of the key's hash, so a probe
+ * compares a group of control bytes at once and only compares keys
+ * whose bits match.
+ *
+ * Growing does not move every entry at once. The full array is kept
+ * as the old array, a new one is allocated, and each insert or erase
+ * moves the entries of at most M_MIGRATE_STEP old slots to the new
+ * array, so no single operation pays for a whole rehash. Lookups check
+ * both arrays until the old one is drained.
+ *
+ * Entries in the old array move when they are migrated, so a reference
+ * to a value is only valid until the next insert or erase
+ *
+ * With a transparent Hash, keys can be looked up by any
+ * type the hash and std::equal_to<> accept, without a conversion
+ */
+template<typename K, typename V, typename Hash = std::hash<K>>
+class KeyTable
+{
+public:
+	using time_point = std::chrono::system_clock::time_point;
+
+	/*
+	 * An entry is a key and its value
+	 * The key must not be changed through an iterator
+	 */
+	struct entry
+	{
+		K first;
+		V second;
+	};
+
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = entry;
+	using size_type = size_t;
+
+private:
+	// the number of slots probed together
+	static constexpr size_t M_GROUP_SIZE = 8;
+
+	// the fewest slots an array has
+	static constexpr size_t M_MIN_CAPACITY = 16;
+
+	// the most old slots an insert or erase migrates
+	static constexpr size_t M_MIGRATE_STEP = 64;
+
+	// control bytes
+	static constexpr int8_t M_EMPTY = -128;
+	static constexpr int8_t M_DELETED = -2;
+
+	// bytes of a group, for matching all of them at once
+	static constexpr uint64_t M_LSBS = 0x0101010101010101;
+	static constexpr uint64_t M_MSBS = 0x8080808080808080;
+
+	// the expiry time of a key with none
+	static constexpr time_point M_NO_EXPIRY = time_point::max();
+
+	// a key, its value, and its expiry time
+	struct slot
+	{
+		entry kv;
+		time_point expiry = M_NO_EXPIRY;
+	};
+
+	/*
+	 * An array is a power of two slots and their control bytes
+	 */
+	struct array
+	{
+		// the number of slots
+		size_t capacity = 0;
+
+		// the number of full slots
+		size_t size = 0;
+
+		// the number of deleted slots
+		size_t tombstones = 0;
+
+		// a control byte per slot
+		std::unique_ptr<int8_t[]> ctrl;
+
+		// the slots, constructed only where the control byte is full
+		slot* slots = nullptr;
+
+		array() = default;
+
+		explicit array(size_t capacity)
+			: capacity{capacity}, ctrl{new int8_t[capacity]}, slots{std::allocator<slot>{}.allocate(capacity)} {
+			std::fill_n(ctrl.get(), capacity, M_EMPTY);
+		}
+
+		array(array&& other) noexcept
+			: capacity{std::exchange(other.capacity, 0)}, size{std::exchange(other.size, 0)},
+			  tombstones{std::exchange(other.tombstones, 0)}, ctrl{std::move(other.ctrl)},
+			  slots{std::exchange(other.slots, nullptr)} {}
+
+		array& operator=(array&& other) noexcept {
+			array moved {std::move(other)};
+			std::swap(capacity, moved.capacity);
+			std::swap(size, moved.size);
+			std::swap(tombstones, moved.tombstones);
+			std::swap(ctrl, moved.ctrl);
+			std::swap(slots, moved.slots);
+			return *this;
+		}
+
+		~array() {
+			for (size_t i = 0; i < capacity; ++i)
+				if (full(i))
+					std::destroy_at(&slots[i]);
+			if (slots)
+				std::allocator<slot>{}.deallocate(slots, capacity);
+		}
+
+		// whether a slot holds an entry
+		bool full(size_t index) const {
+			return ctrl[index] >= 0;
+		}
+	};
+
+	// where new entries go
+	array m_table;
+
+	// the array being migrated to m_table, with no capacity when there is none
+	array m_old;
+
+	// the number of slots of m_old already migrated
+	size_t m_migrated = 0;
+
+	// the number of keys with an expiry time
+	size_t m_expiring = 0;
+
+	// the group a hash starts probing at
+	static size_t h1(size_t hash) {
+		return hash >> 7;
+	}
+
+	// the control byte for a hash
+	// from the top bits, since the low bits pick the shard
+	static int8_t h2(size_t hash) {
+		return static_cast<int8_t>(hash >> (std::numeric_limits<size_t>::digits - 7));
+	}
+
+	// the control bytes of a group
+	static uint64_t load_group(const int8_t* ctrl) {
+		uint64_t group = 0;
+		for (size_t i = 0; i < M_GROUP_SIZE; ++i)
+			group |= static_cast<uint64_t>(static_cast<uint8_t>(ctrl[i])) << (8 * i);
+		return group;
+	}
+
+	// the high bit of each byte of a group equal to a control byte
+	// may rarely include a byte that is not, so keys are still compared
+	static uint64_t match(uint64_t group, int8_t h2) {
+		auto x = group ^ (M_LSBS * static_cast<uint8_t>(h2));
+		return (x - M_LSBS) & ~x & M_MSBS;
+	}
+
+	// the high bit of each empty byte of a group
+	static uint64_t match_empty(uint64_t group) {
+		return group & ~(group << 6) & M_MSBS;
+	}
+
+	// the high bit of each empty or deleted byte of a group
+	static uint64_t match_free(uint64_t group) {
+		return group & ~(group << 7) & M_MSBS;
+	}
+
+	// the slot of the lowest byte in a match
+	static size_t lowest(uint64_t mask) {
+		return static_cast<size_t>(std::countr_zero(mask)) / 8;
+	}
+
+	// the slot of a key in an array, or capacity if it is not there
+	template<typename Q>
+	static size_t find_in(const array& a, const Q& key, size_t hash) {
+		if (a.capacity == 0)
+			return a.capacity;
+
+		auto groups = a.capacity / M_GROUP_SIZE;
+		auto group = h1(hash) & (groups - 1);
+		for (size_t step = 1;; ++step) {
+			auto ctrl = load_group(&a.ctrl[group * M_GROUP_SIZE]);
+			for (auto mask = match(ctrl, h2(hash)); mask; mask &= mask - 1) {
+				auto index = group * M_GROUP_SIZE + lowest(mask);
+				if (std::equal_to<>{}(a.slots[index].kv.first, key))
+					return index;
+			}
+
+			if (match_empty(ctrl))
+				return a.capacity;
+
+			// triangular steps visit every group of a power of two
+			group = (group + step) & (groups - 1);
+		}
+	}
+
+	// the first free slot for a hash in an array, marked full
+	// the array must have a free slot
+	static size_t claim_in(array& a, size_t hash) {
+		auto groups = a.capacity / M_GROUP_SIZE;
+		auto group = h1(hash) & (groups - 1);
+		for (size_t step = 1;; ++step) {
+			if (auto mask = match_free(load_group(&a.ctrl[group * M_GROUP_SIZE]))) {
+				auto index = group * M_GROUP_SIZE + lowest(mask);
+				if (a.ctrl[index] == M_DELETED)
+					--a.tombstones;
+				a.ctrl[index] = h2(hash);
+				++a.size;
+				return index;
+			}
+
+			group = (group + step) & (groups - 1);
+		}
+	}
+
+	// the slot of a key in either array, or nullptr
+	template<typename Q>
+	slot* find_slot(const Q& key) const {
+		auto hash = Hash{}(key);
+		auto index = find_in(m_table, key, hash);
+		if (index < m_table.capacity)
+			return &m_table.slots[index];
+
+		index = find_in(m_old, key, hash);
+		if (index < m_old.capacity)
+			return &m_old.slots[index];
+
+		return nullptr;
+	}
+
+	// move the entries of up to limit old slots to m_table
+	void migrate(size_t limit) {
+		for (; limit > 0 and m_migrated < m_old.capacity; --limit, ++m_migrated) {
+			if (not m_old.full(m_migrated))
+				continue;
+
+			auto& from = m_old.slots[m_migrated];
+			auto index = claim_in(m_table, Hash{}(from.kv.first));
+			std::construct_at(&m_table.slots[index], std::move(from));
+			std::destroy_at(&from);
+
+			// deleted rather than empty, so probes for later keys go past it
+			m_old.ctrl[m_migrated] = M_DELETED;
+			--m_old.size;
+		}
+
+		if (m_old.capacity > 0 and m_migrated == m_old.capacity)
+			m_old = array{};
+	}
+
+	// make room in m_table for one more entry
+	void reserve_one() {
+		if ((m_table.size + m_table.tombstones + 1) * 8 <= m_table.capacity * 7)
+			return;
+
+		// the new array is sized so it cannot fill up before this finishes,
+		// but finish anyway rather than assume it
+		migrate(m_old.capacity);
+
+		// at least twice the entries plus those inserted while migrating,
+		// so the new array is at most half full when the old one is drained
+		auto needed = 2 * (m_table.size + 1 + m_table.capacity / M_MIGRATE_STEP + 1);
+		m_old = std::move(m_table);
+		m_migrated = 0;
+		m_table = array{std::bit_ceil(std::max(M_MIN_CAPACITY, needed))};
+	}
+
+	// construct an entry in m_table, where its key is not in either array
+	template<typename... Args>
+	V& emplace_new(size_t hash, Args&&... args) {
+		reserve_one();
+		auto index = claim_in(m_table, hash);
+		std::construct_at(&m_table.slots[index], slot{entry{std::forward<Args>(args)...}});
+		return m_table.slots[index].kv.second;
+	}
+
+	/*
+	 * An iterator over the entries of the new array, then the old one
+	 */
+	template<bool Const>
+	class basic_iterator
+	{
+	private:
+		using owner_ptr = std::conditional_t<Const, const KeyTable*, KeyTable*>;
+
+		// the table being iterated
+		owner_ptr m_owner = nullptr;
+
+		// the slot, counting through the new array and then the old one
+		size_t m_index = 0;
+
+		// the slot at the index
+		slot& current() const {
+			auto& t = m_owner->m_table;
+			if (m_index < t.capacity)
+				return t.slots[m_index];
+			return m_owner->m_old.slots[m_index - t.capacity];
+		}
+
+		// whether the slot at the index is full
+		bool full() const {
+			auto& t = m_owner->m_table;
+			if (m_index < t.capacity)
+				return t.full(m_index);
+			return m_owner->m_old.full(m_index - t.capacity);
+		}
+
+		// the number of slots in both arrays
+		size_t total() const {
+			return m_owner->m_table.capacity + m_owner->m_old.capacity;
+		}
+
+		// move to the next full slot, if the current one is not
+		void skip_empty() {
+			while (m_index < total() and not full())
+				++m_index;
+		}
+
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = entry;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, const entry&, entry&>;
+		using pointer = std::conditional_t<Const, const entry*, entry*>;
+
+		basic_iterator() = default;
+
+		// create an iterator at the first full slot from an index
+		basic_iterator(owner_ptr owner, size_t index) : m_owner{owner}, m_index{index} {
+			skip_empty();
+		}
+
+		// a non-const iterator converts to a const iterator
+		operator basic_iterator<true>() const requires (not Const) {
+			return {m_owner, m_index};
+		}
+
+		reference operator*() const {
+			return current().kv;
+		}
+
+		pointer operator->() const {
+			return &current().kv;
+		}
+
+		// the expiry time of the entry, or nullptr if it has none
+		const time_point* expiry() const {
+			auto& s = current();
+			return s.expiry == M_NO_EXPIRY ? nullptr : &s.expiry;
+		}
+
+		basic_iterator& operator++() {
+			++m_index;
+			skip_empty();
+			return *this;
+		}
+
+		basic_iterator operator++(int) {
+			auto ret = *this;
+			++*this;
+			return ret;
+		}
+
+		bool operator==(const basic_iterator& other) const {
+			return m_index == other.m_index;
+		}
+	};
+
+public:
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	KeyTable() = default;
+
+	// no copy
+	KeyTable(const KeyTable&) = delete;
+	KeyTable& operator=(const KeyTable&) = delete;
+
+	KeyTable(KeyTable&& other) noexcept = default;
+	KeyTable& operator=(KeyTable&& other) noexcept = default;
+
+	// get the value for a key, or nullptr if it does not exist
+	template<typename Q>
+	V* find(const Q& key) {
+		auto s = find_slot(key);
+		return s ? &s->kv.second : nullptr;
+	}
+
+	// get the value for a key, or nullptr if it does not exist
+	template<typename Q>
+	const V* find(const Q& key) const {
+		auto s = find_slot(key);
+		return s ? &s->kv.second : nullptr;
+	}
+
+	// check if a key exists
+	template<typename Q>
+	bool contains(const Q& key) const {
+		return find_slot(key) != nullptr;
+	}
+
+	// get the value for a key, default-inserting it if it does not exist
+	V& operator[](const K& key) {
+		migrate(M_MIGRATE_STEP);
+		if (auto value = find(key))
+			return *value;
+
+		return emplace_new(Hash{}(key), key, V{});
+	}
+
+	// insert a key and value if the key does not exist
+	bool insert(K key, V value) {
+		migrate(M_MIGRATE_STEP);
+		if (contains(key))
+			return false;
+
+		auto hash = Hash{}(key);
+		emplace_new(hash, std::move(key), std::move(value));
+		return true;
+	}
+
+	// erase a key, returning the number of elements erased
+	template<typename Q>
+	size_type erase(const Q& key) {
+		auto hash = Hash{}(key);
+		for (auto a : {&m_table, &m_old}) {
+			auto index = find_in(*a, key, hash);
+			if (index == a->capacity)
+				continue;
+
+			if (a->slots[index].expiry != M_NO_EXPIRY)
+				--m_expiring;
+			std::destroy_at(&a->slots[index]);
+			a->ctrl[index] = M_DELETED;
+			++a->tombstones;
+			--a->size;
+
+			// the key may be a view of a migrated entry, so migrate after
+			migrate(M_MIGRATE_STEP);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	// get the expiry time of a key, or nullptr if it has none
+	template<typename Q>
+	const time_point* expiry(const Q& key) const {
+		auto s = find_slot(key);
+		return s and s->expiry != M_NO_EXPIRY ? &s->expiry : nullptr;
+	}
+
+	// set the expiry time of a key
+	// returns false, and does nothing, if the key does not exist
+	template<typename Q>
+	bool set_expiry(const Q& key, time_point expiry) {
+		auto s = find_slot(key);
+		if (not s)
+			return false;
+
+		if (s->expiry == M_NO_EXPIRY)
+			++m_expiring;
+		s->expiry = expiry;
+		return true;
+	}
+
+	// clear the expiry time of a key, if it has one
+	template<typename Q>
+	void clear_expiry(const Q& key) {
+		auto s = find_slot(key);
+		if (s and s->expiry != M_NO_EXPIRY) {
+			s->expiry = M_NO_EXPIRY;
+			--m_expiring;
+		}
+	}
+
+	// clear the expiry times of all keys
+	void clear_all_expiry() {
+		for (auto a : {&m_table, &m_old})
+			for (size_t i = 0; i < a->capacity; ++i)
+				if (a->full(i))
+					a->slots[i].expiry = M_NO_EXPIRY;
+		m_expiring = 0;
+	}
+
+	// the number of keys with an expiry time
+	size_type expiring() const {
+		return m_expiring;
+	}
+
+	// the number of entries
+	size_type size() const {
+		return m_table.size + m_old.size;
+	}
+
+	// check if there are no entries
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// erase all entries
+	void clear() {
+		m_table = array{};
+		m_old = array{};
+		m_migrated = 0;
+		m_expiring = 0;
+	}
+
+	iterator begin() {
+		return {this, 0};
+	}
+
+	iterator end() {
+		return {this, m_table.capacity + m_old.capacity};
+	}
+
+	const_iterator begin() const {
+		return {this, 0};
+	}
+
+	const_iterator end() const {
+		return {this, m_table.capacity + m_old.capacity};
+	}
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_KEY_TABLE_H
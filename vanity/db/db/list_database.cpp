@@ -17,40 +17,40 @@ ListDatabase &ListDatabase::operator=(ListDatabase &&other) noexcept {
 }
 
 std::variant<size_t, ListErrorKind>
-ListDatabase::list_len(const key_type &key) {
+ListDatabase::list_len(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (std::holds_alternative<list_t>(value))
-		return std::get<list_t>(value).size();
+	if (value.holds<list_t>())
+		return value.get<list_t>().size();
 	else
 		return ListErrorKind::NotList;
 }
 
 std::variant<std::string, ListErrorKind>
-ListDatabase::list_get(const key_type &key, int64_t index) {
+ListDatabase::list_get(key_view_type key, int64_t index) {
 	erase_if_expired(key);
 
-	auto it_or_error = iterator_or_error(key, index);
-	if (std::holds_alternative<ListErrorKind>(it_or_error))
-		return std::get<ListErrorKind>(it_or_error);
+	auto pos_or_error = position_or_error(key, index);
+	if (std::holds_alternative<ListErrorKind>(pos_or_error))
+		return std::get<ListErrorKind>(pos_or_error);
 
-	return *std::get<list_t::iterator>(it_or_error);
+	auto [list, pos] = std::get<std::pair<list_t*, size_t>>(pos_or_error);
+	return list->at(pos);
 }
 
 std::variant<string_t, ListErrorKind>
 ListDatabase::list_set(const key_type &key, int64_t index, std::string value) {
 	erase_if_expired(key);
 
-	auto it_or_error = iterator_or_error(key, index);
-	if (std::holds_alternative<ListErrorKind>(it_or_error))
-		return std::get<ListErrorKind>(it_or_error);
+	auto pos_or_error = position_or_error(key, index);
+	if (std::holds_alternative<ListErrorKind>(pos_or_error))
+		return std::get<ListErrorKind>(pos_or_error);
 
-	auto& it = std::get<list_t::iterator>(it_or_error);
-	std::swap(*it, value);
-	return value;
+	auto [list, pos] = std::get<std::pair<list_t*, size_t>>(pos_or_error);
+	return list->set(pos, value);
 }
 
 std::variant<size_t, ListErrorKind>
@@ -63,12 +63,12 @@ ListDatabase::list_push_left(const key_type &key, list_t values) {
 		m_data[key] = list_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
-	auto& list = std::get<list_t>(value);
-	values.reverse();
-	list.splice(list.begin(), std::move(values));
+	auto& list = value.get<list_t>();
+	for (auto v : values)
+		list.push_front(v);
 	return list.size();
 }
 
@@ -78,15 +78,18 @@ ListDatabase::list_push_right(const key_type &key, list_t values) {
 	if (values.empty())
 		return 0ull;
 
-	if (not m_data.contains(key))
-		m_data[key] = list_t{};
+	if (not m_data.contains(key)) {
+		m_data[key] = std::move(values);
+		return m_data.at(key).get<list_t>().size();
+	}
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
-	auto& list = std::get<list_t>(value);
-	list.splice(list.end(), std::move(values));
+	auto& list = value.get<list_t>();
+	for (auto v : values)
+		list.push_back(v);
 	return list.size();
 }
 
@@ -97,16 +100,11 @@ ListDatabase::list_pop_left(const key_type &key, int64_t n) {
 		return list_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
-	auto& list = std::get<list_t>(value);
-	auto it = iterator_or_end(list, n);
-	if (it == list.end() and n < 0)
-		return list_t{}; // overflow on negative n
-
-	list_t result;
-	result.splice(result.begin(), list, list.begin(), it);
+	auto& list = value.get<list_t>();
+	auto result = list.pop_front(pop_count(list.size(), n));
 	if (list.empty())
 		expiry_aware_del(key);
 
@@ -120,16 +118,11 @@ ListDatabase::list_pop_right(const key_type &key, int64_t n) {
 		return list_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
-	auto& list = std::get<list_t>(value);
-	auto rit = reverse_iterator_or_rend(list, n);
-	if (rit == list.rend() and n < 0)
-		return list_t{}; // overflow on negative n
-
-	list_t result;
-	result.splice(result.begin(), list, rit.base(), list.end());
+	auto& list = value.get<list_t>();
+	auto result = list.pop_back(pop_count(list.size(), n));
 	if (list.empty())
 		expiry_aware_del(key);
 
@@ -137,21 +130,21 @@ ListDatabase::list_pop_right(const key_type &key, int64_t n) {
 }
 
 std::variant<list_t, ListErrorKind>
-ListDatabase::list_range(const key_type &key, int64_t start, int64_t end) {
+ListDatabase::list_range(key_view_type key, int64_t start, int64_t end) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return list_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
 	if (is_invalid_range(start, end))
 		return list_t{};
 
-	auto& list = std::get<list_t>(value);
-	auto [it, end_it] = iterator_pair_inclusive(list, start, end);
-	return list_t{it, end_it};
+	auto& list = value.get<list_t>();
+	auto [first, last] = range_inclusive(list.size(), start, end);
+	return list.range(first, last);
 }
 
 std::variant<size_t, ListErrorKind>
@@ -161,18 +154,22 @@ ListDatabase::list_trim(const key_type &key, int64_t start, int64_t end) {
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
 	if (is_invalid_range(start, end))
 		return 0ull;
 
-	auto& list = std::get<list_t>(value);
-	auto [it, end_it] = iterator_pair_inclusive(list, start, end);
+	auto& list = value.get<list_t>();
+	auto [first, last] = range_inclusive(list.size(), start, end);
 	auto size = list.size();
 
-	list.erase(list.begin(), it);
-	list.erase(end_it, list.end());
+	if (first < last) {
+		list.erase_back(size - last);
+		list.erase_front(first);
+	} else {
+		list.clear();
+	}
 
 	auto ret = size - list.size();
 	if (list.empty())
@@ -188,111 +185,65 @@ ListDatabase::list_remove(const key_type &key, const std::string &element, int64
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
-	auto& list = std::get<list_t>(value);
-	auto size = list.size();
-
-	if (count > 0) {
-		auto it = list.begin();
-		auto end_it = list.end();
-		for (int64_t i = 0; i < count and it != end_it;)
-			if (*it == element)
-				it = list.erase(it), ++i;
-			else
-				++it;
-	} else if (count < 0) {
-		auto it = list.rbegin();
-		auto end_it = list.rend();
-		for (int64_t i = 0; i > count and it != end_it;)
-			if (*it == element)
-				it = std::make_reverse_iterator(list.erase((++it).base())), --i;
-			else
-				++it;
-	} else {
-		auto it = list.begin();
-		auto end_it = list.end();
-		for (; it != end_it;)
-			if (*it == element)
-				it = list.erase(it);
-			else
-				++it;
-	}
-
-	auto ret = size - list.size();
+	auto& list = value.get<list_t>();
+	auto ret = list.remove(element, count);
 	if (list.empty())
 		expiry_aware_del(key);
 
 	return ret;
 };
 
-std::variant<list_t::iterator, ListErrorKind>
-ListDatabase::iterator_or_error(const key_type &key, int64_t index) {
+std::variant<std::pair<list_t*, size_t>, ListErrorKind>
+ListDatabase::position_or_error(key_view_type key, int64_t index) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return ListErrorKind::OutOfRange;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<list_t>(value))
+	if (not value.holds<list_t>())
 		return ListErrorKind::NotList;
 
-	auto& list = std::get<list_t>(value);
-	auto it = iterator_or_end(list, index);
-	if (it == list.end())
+	auto& list = value.get<list_t>();
+	auto pos = position(list.size(), index);
+	if (not pos)
 		return ListErrorKind::OutOfRange;
-	return it;
+	return std::pair{&list, *pos};
 }
 
-list_t::iterator
-ListDatabase::iterator_or_end(list_t& list, int64_t index) {
-	const int64_t size = list.size();
-	int64_t idx = index;
-
-	if (idx >= size or idx < -size)
-		return list.end();
-
-	if (idx < 0)
-		idx += size;
+std::optional<size_t> ListDatabase::position(size_t size, int64_t index) {
+	const auto ssize = static_cast<int64_t>(size);
+	if (index >= ssize or index < -ssize)
+		return std::nullopt;
 
-	auto it = list.begin();
-	std::advance(it, idx);
-	return it;
+	return index < 0 ? index + ssize : index;
 }
 
-list_t::reverse_iterator
-ListDatabase::reverse_iterator_or_rend(list_t &list, int64_t index) {
-	const int64_t size = list.size();
-	int64_t idx = index;
-
-	if (idx >= size or idx < -size)
-		return list.rend();
-
-	if (idx < 0)
-		idx += size;
-
-	auto it = list.rbegin();
-	std::advance(it, idx);
-	return it;
+size_t ListDatabase::pop_count(size_t size, int64_t n) {
+	if (auto pos = position(size, n))
+		return *pos;
+	return n < 0 ? 0 : size;
 }
 
-std::pair<list_t::iterator, list_t::iterator>
-ListDatabase::iterator_pair_inclusive(list_t &list, int64_t start, int64_t end) {
-	auto it = iterator_or_end(list, start);
-	if (it == list.end() and start < 0)
-		it = list.begin(); // overflow on negative start, start at the beginning
+std::pair<size_t, size_t>
+ListDatabase::range_inclusive(size_t size, int64_t start, int64_t end) {
+	auto first = position(size, start);
+	if (not first)
+		first = start < 0 ? 0 : size; // overflow on negative start, start at the beginning
 
-	auto end_it = iterator_or_end(list, end);
-	if (end_it == list.end() and end < 0)
-		end_it = list.begin(); // overflow on negative end, empty list
-	else if (end_it != list.end())
-		++end_it; // end is inclusive
+	auto last = position(size, end);
+	if (last)
+		++*last; // end is inclusive
+	else
+		last = end < 0 ? 0 : size; // overflow on negative end, empty list
 
-	return {it, end_it};
+	return {*first, *last};
 }
 
 bool ListDatabase::is_invalid_range(int64_t start, int64_t end) {
 	return (start > 0 and end > 0 and start > end) or (start < 0 and end < 0 and start > end);
 }
 
-} // namespace vanity::db
\ No newline at end of file
+} // namespace vanity::db
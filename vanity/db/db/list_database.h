@@ -38,12 +38,12 @@ public:
 	// get the length of a list key
 	// returns the length, 0 if value does not exist or is empty,
 	// or ListErrorKind::NotList if the value exists and is not a list
-	std::variant<size_t, ListErrorKind> list_len(const key_type &key);
+	std::variant<size_t, ListErrorKind> list_len(key_view_type key);
 
 	// get the value for a list key at a given index
 	// returns the value, or ListErrorKind::NotList if the value is not a list
 	// or ListErrorKind::OutOfRange if the index is out of range or if value does not exist
-	std::variant<std::string, ListErrorKind> list_get(const key_type &key, int64_t index);
+	std::variant<std::string, ListErrorKind> list_get(key_view_type key, int64_t index);
 
 	// set the value for a list key at a given index
 	// returns the old value if the value was set, or ListErrorKind::NotList if the value is not a list
@@ -73,7 +73,7 @@ public:
 	// get the value for a range of a list key inclusively
 	// returns the values, or ListErrorKind::NotList if the value is not a list
 	// returns an empty list if the range is out of bounds or invalid
-	std::variant<list_t, ListErrorKind> list_range(const key_type &key, int64_t start, int64_t end);
+	std::variant<list_t, ListErrorKind> list_range(key_view_type key, int64_t start, int64_t end);
 
 	// trim the list stored at key, so that it will
 	// contain only the specified range of elements (inclusively)
@@ -88,24 +88,24 @@ public:
 	std::variant<size_t, ListErrorKind> list_remove(const key_type &key, const std::string& element, int64_t count);
 
 private:
-	// get the iterator for a list key at a given index
-	// returns the iterator, or ListErrorKind::NotList if the value is not a list
+	// get the list for a list key, and the position of a given index in it
+	// returns the list and position, or ListErrorKind::NotList if the value is not a list
 	// or ListErrorKind::OutOfRange if the index is out of range or if value does not exist
 	// index can be negative to get the element from the end of the list
-	std::variant<list_t::iterator, ListErrorKind> iterator_or_error(const key_type &key, int64_t index);
+	std::variant<std::pair<list_t*, size_t>, ListErrorKind> position_or_error(key_view_type key, int64_t index);
 
-	// get the iterator for a given list at a given index
-	// returns the iterator, or the end iterator if the index is out of range
+	// get the position of a given index in a list of some size
+	// returns the position, or std::nullopt if the index is out of range
 	// index can be negative to get the element from the end of the list
-	static list_t::iterator iterator_or_end(list_t &list, int64_t index);
+	static std::optional<size_t> position(size_t size, int64_t index);
 
-	// get the reverse iterator for a given list at a given index
-	// returns the iterator, or the rend iterator if the index is out of range
-	// index can be negative to get the element from the end of the list
-	static list_t::reverse_iterator reverse_iterator_or_rend(list_t &list, int64_t index);
+	// get the number of elements to pop from an end of a list of some size
+	// a positive n past the end pops the whole list, a negative n past the end pops nothing
+	static size_t pop_count(size_t size, int64_t n);
 
-	// get a pair of iterators for a given list at given indexes inclusively
-	static std::pair<list_t::iterator, list_t::iterator> iterator_pair_inclusive(list_t &list, int64_t start, int64_t end);
+	// get the positions of a range of a list of some size, given inclusively
+	// returns the start and the position after the end
+	static std::pair<size_t, size_t> range_inclusive(size_t size, int64_t start, int64_t end);
 
 	// check if a pair of integers form an invalid range
 	static bool is_invalid_range(int64_t start, int64_t end);
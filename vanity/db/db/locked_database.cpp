@@ -5,7 +5,11 @@
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "HidingNonVirtualFunction"
 
+#include <algorithm>
+#include <limits>
+
 #include "locked_database.h"
+#include "utils/cached_clock.h"
 
 namespace vanity::db {
 
@@ -20,69 +24,301 @@ LockedDatabase &LockedDatabase::operator=(Database &&other) noexcept {
 	return *this;
 }
 
-LockedDatabase LockedDatabase::from(std::ifstream &in, logger_type &wal_logger) {
-	return LockedDatabase{Database::from(in), wal_logger};
+void LockedDatabase::load_from(std::shared_ptr<const MappedFile> file, std::span<const shard_extent> extents) {
+	auto data = file->data();
+	auto shard_data = [&](const shard_extent& extent) {
+		if (extent.offset > data.size() or extent.size > data.size() - extent.offset)
+			throw std::runtime_error("Snapshot shard out of bounds");
+		return data.subspan(extent.offset, extent.size);
+	};
+
+	// keys would not be in the shards they were written from
+	if (extents.size() != M_NUM_SHARDS) {
+		for (auto& extent : extents) {
+			serializer::SpanReader in {shard_data(extent)};
+			Database::load_shard(in);
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i) {
+		shard_data(extents[i]);
+		m_load_extents[i] = extents[i];
+		m_unloaded[i] = true;
+	}
+
+	m_load_file = std::move(file);
+	m_loading = true;
+}
+
+void LockedDatabase::load_unversioned(serializer::SpanReader &in) {
+	if (serializer::read<uint>(in) != m_index)
+		throw std::runtime_error("Database file is corrupted: bad database index");
+
+	Database::load_shard(in);
 }
 
-void LockedDatabase::persist(std::ofstream &out) {
-	std::lock_guard lock{m_mutex};
-	Database::persist(out);
+void LockedDatabase::load_all(std::stop_token stop) {
+	if (not m_loading)
+		return;
+
+	auto will_need = [this](size_t shard) {
+		if (shard < M_NUM_SHARDS and m_unloaded[shard])
+			m_load_file->will_need(m_load_extents[shard].offset, m_load_extents[shard].size);
+	};
+
+	will_need(0);
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i) {
+		if (stop.stop_requested())
+			return;
+
+		// read the next shard ahead while this one is parsed
+		will_need(i + 1);
+		load_shards(shard_set{}.set(i));
+	}
+
+	// nothing reads the file once every shard is loaded
+	m_loading = false;
+	m_load_file.reset();
 }
 
+void LockedDatabase::load_shards(shard_set shards) {
+	if (not m_loading)
+		return;
 
-std::lock_guard<LockedDatabase::lock_type> LockedDatabase::lock() {
-	return std::lock_guard{m_mutex};
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i) {
+		if (shards[i] and m_unloaded[i]) {
+			std::lock_guard lock{m_mutexes[i]};
+			load_shard_locked(i);
+		}
+	}
 }
 
-auto LockedDatabase::mutex() -> lock_type & {
-	return m_mutex;
+void LockedDatabase::load_shard_locked(size_t shard) {
+	if (not m_unloaded[shard])
+		return;
+
+	auto& extent = m_load_extents[shard];
+	serializer::SpanReader in {m_load_file->data().subspan(extent.offset, extent.size)};
+	Database::load_shard(in);
+	m_unloaded[shard] = false;
 }
 
+void LockedDatabase::drop_unloaded() {
+	for (auto& unloaded : m_unloaded)
+		unloaded = false;
+}
 
-template<typename ...Args>
-inline void LockedDatabase::wal_log(trn_id_t trn_id, db_op_t op, const Args &... args) {
-	if (should_wal(op))
-		m_wal_logger.wal_db_op(m_index, trn_id, op, args...);
+void LockedDatabase::begin_snapshot() {
+	m_snapshot_pending.fill(true);
+	m_snapshotting = true;
 }
 
+shard_extents LockedDatabase::persist(serializer::BufferWriter &out) {
+	shard_extents extents {};
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i) {
+		uint64_t offset = out.position();
 
-void LockedDatabase::wal_redo_db_op(trn_id_t trn_id, db_op_t op, serializer::ReadHandle& reader, get_db_func_t& get_db) {
-	switch (op) {
-		case db_op_t::has:
-		case db_op_t::get:
-		case db_op_t::type:
-		case db_op_t::keys:
-
-		case db_op_t::get_expiry:
-
-		case db_op_t::str_len:
-		case db_op_t::many_get:
-
-		case db_op_t::list_len:
-		case db_op_t::list_get:
-		case db_op_t::list_range:
-
-		case db_op_t::set_all:
-		case db_op_t::set_len:
-		case db_op_t::set_contains:
-		case db_op_t::set_union:
-		case db_op_t::set_union_len:
-		case db_op_t::set_intersection:
-		case db_op_t::set_intersection_len:
-		case db_op_t::set_difference:
-		case db_op_t::set_difference_len:
-
-		case db_op_t::hash_all:
-		case db_op_t::hash_get:
-		case db_op_t::hash_contains:
-		case db_op_t::hash_len:
-		case db_op_t::hash_key_len:
-		case db_op_t::hash_keys:
-		case db_op_t::hash_values:
-		case db_op_t::hash_many_get:
-			throw std::runtime_error("unexpected db_op_t");
+		// readers only share the lock, they do not touch the snapshot
+		ShardLock lock{*this, shard_set{}.set(i), true};
+		auto& aside = m_snapshot_tables[i];
+		Database::persist_shard(out, aside ? *aside : m_data.shard(i), m_snapshot_keys[i]);
+		m_snapshot_pending[i] = false;
+		m_snapshot_keys[i] = {};
+		aside.reset();
+
+		extents[i] = {offset, out.position() - offset};
+	}
+
+	m_snapshotting = false;
+	return extents;
+}
+
+template<typename ...Keys>
+inline void LockedDatabase::preserve(const Keys &... keys) {
+	if (m_snapshotting)
+		(preserve_keys(keys), ...);
+}
+
+void LockedDatabase::preserve_keys(key_view_type key) {
+	auto shard = shard_of(key);
+	if (not m_snapshot_pending[shard] or m_snapshot_tables[shard])
+		return;
+
+	auto& preserved = m_snapshot_keys[shard];
+	if (preserved.contains(key))
+		return;
+
+	std::optional<preserved_key> entry;
+	if (auto value = m_data.find(key)) {
+		auto expiry_time = m_data.expiry(key);
+		entry = preserved_key{*value, expiry_time ? std::optional{*expiry_time} : std::nullopt};
+	}
+	preserved.emplace(key, std::move(entry));
+}
+
+void LockedDatabase::preserve_keys(const std::vector<key_type> &keys) {
+	for (auto& key : keys)
+		preserve_keys(key);
+}
+
+void LockedDatabase::preserve_expiring(shard_set shards) {
+	if (not m_snapshotting)
+		return;
+
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i) {
+		if (not shards[i])
+			continue;
+
+		auto& shard = m_data.shard(i);
+		for (auto it = shard.begin(); it != shard.end(); ++it)
+			if (it.expiry())
+				preserve_keys(it->first);
+	}
+}
+
+void LockedDatabase::set_aside(shard_set shards) {
+	if (not m_snapshotting)
+		return;
+
+	// the keys preserved so far still apply on top of the table
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i)
+		if (shards[i] and m_snapshot_pending[i] and not m_snapshot_tables[i])
+			m_snapshot_tables[i] = std::exchange(m_data.shard(i), {});
+}
+
+
+LockedDatabase::ShardLock::ShardLock(LockedDatabase &db, shard_set shards, bool shared, bool load)
+	: m_db{db}, m_shards{shards}, m_shared{shared} {
+	if (load)
+		m_db.load_shards(m_shards);
+
+	for (size_t i = 0; i < M_NUM_SHARDS; ++i) {
+		if (not m_shards[i])
+			continue;
+
+		if (m_shared)
+			m_db.m_mutexes[i].lock_shared();
+		else
+			m_db.m_mutexes[i].lock();
+	}
+}
+
+LockedDatabase::ShardLock::~ShardLock() {
+	for (size_t i = M_NUM_SHARDS; i > 0; --i) {
+		if (not m_shards[i - 1])
+			continue;
 
+		if (m_shared)
+			m_db.m_mutexes[i - 1].unlock_shared();
+		else
+			m_db.m_mutexes[i - 1].unlock();
+	}
+}
+
+auto LockedDatabase::lock_all() -> ShardLock {
+	return lock_shards(shard_set{}.set());
+}
+
+auto LockedDatabase::mutex(key_view_type key) -> lock_type & {
+	return m_mutexes[shard_of(key)];
+}
+
+auto LockedDatabase::shards_of(key_view_type key) -> shard_set {
+	return shard_set{}.set(shard_of(key));
+}
+
+auto LockedDatabase::shards_of(const std::vector<key_type> &keys) -> shard_set {
+	shard_set shards;
+	for (auto& key : keys)
+		shards.set(shard_of(key));
+	return shards;
+}
+
+auto LockedDatabase::lock_shards(shard_set shards) -> ShardLock {
+	return ShardLock{*this, shards};
+}
+
+bool LockedDatabase::any_expired(key_view_type key) {
+	return Database::is_expired(key);
+}
+
+bool LockedDatabase::any_expired(const std::vector<key_type> &keys) {
+	return std::ranges::any_of(keys, [this](auto& key) { return Database::is_expired(key); });
+}
+
+
+template<db_op_t op, typename ...Args>
+inline auto LockedDatabase::wal_log(trn_id_t trn_id, const Args &... args) -> logger_type::durability_future {
+	static_assert(should_wal_v<op>, "read-only operations are not logged");
+	return m_wal_logger.wal_db_op(m_index, trn_id, op, args...);
+}
+
+template<typename Op, typename ...Keys>
+inline auto LockedDatabase::read_op(Op op, const Keys &... keys) {
+	auto shards = (shards_of(keys) | ...);
+	{
+		ShardLock lock{*this, shards, true};
+		if (not (any_expired(keys) or ...)) {
+			ExpiryDeferral deferral;
+			return op();
+		}
+	}
+
+	ShardLock lock{*this, shards};
+	preserve(keys...);
+	return op();
+}
 
+template<db_op_t op_t, typename Op, typename ...Args>
+inline auto LockedDatabase::write_shards_op(shard_set shards, Op op, trn_id_t trn_id, const Args &... args) {
+	logger_type::durability_future durable;
+	if constexpr (std::is_void_v<std::invoke_result_t<Op>>) {
+		{
+			ShardLock lock{*this, shards};
+			durable = wal_log<op_t>(trn_id, args...);
+			op();
+		}
+		durable.get();
+	}
+	else {
+		auto result = [&] {
+			ShardLock lock{*this, shards};
+			durable = wal_log<op_t>(trn_id, args...);
+			return op();
+		}();
+		durable.get();
+		return result;
+	}
+}
+
+template<db_op_t op_t, typename ...Keys, typename Op, typename ...Args>
+inline auto LockedDatabase::write_op(std::tuple<const Keys&...> keys, Op op, trn_id_t trn_id, const Args &... args) {
+	return std::apply([&](const auto&... key) {
+		return write_shards_op<op_t>((shards_of(key) | ...), [&] {
+			preserve(key...);
+			return op();
+		}, trn_id, args...);
+	}, keys);
+}
+
+template<db_op_t op_t, typename Op, typename ...Args>
+inline auto LockedDatabase::write_all_op(Op op, trn_id_t trn_id, const Args &... args) {
+	return write_shards_op<op_t>(shard_set{}.set(), op, trn_id, args...);
+}
+
+template<typename Op, typename ...Keys>
+inline void LockedDatabase::redo_op(Op op, const Keys &... keys) {
+	ShardLock lock{*this, (shards_of(keys) | ...)};
+	op();
+}
+
+
+void LockedDatabase::wal_redo_db_op(trn_id_t trn_id, db_op_t op, serializer::ReadHandle<serializer::SpanReader>& reader, get_db_func_t& get_db) {
+	if (not should_wal(op))
+		throw std::runtime_error("unexpected db_op_t");
+
+	switch (op) {
 		case db_op_t::begin: {
 			// TODO: begin
 			break;
@@ -98,159 +334,171 @@ void LockedDatabase::wal_redo_db_op(trn_id_t trn_id, db_op_t op, serializer::Rea
 		}
 
 		case db_op_t::reset: {
+			// the shards not loaded yet would only be erased
+			ShardLock lock{*this, shard_set{}.set(), false, false};
+			drop_unloaded();
 			Database::reset();
 			break;
 		}
 		case db_op_t::del: {
-			Database::del(reader.read<key_type>());
+			auto key = reader.read<key_type>();
+			redo_op([&] { Database::del(key); }, key);
 			break;
 		}
 		case db_op_t::copy_to: {
 			auto [from, to] = reader.read<key_type, key_type>();
-			Database::copy_to(from, to);
+			redo_op([&] { Database::copy_to(from, to); }, from, to);
 			break;
 		}
 		case db_op_t::move_to: {
 			auto [from, to] = reader.read<key_type, key_type>();
-			Database::move_to(from, to);
+			redo_op([&] { Database::move_to(from, to); }, from, to);
 			break;
 		}
 		case db_op_t::copy_to_db: {
 			auto [from, to] = reader.read<key_type, m_index_type>();
-			 Database::copy_to_db(from, get_db(to));
+			// records across databases are redone alone, so the other one is only loaded
+			auto& to_db = get_db(to);
+			to_db.load_shards(shards_of(from));
+			redo_op([&] { Database::copy_to_db(from, to_db); }, from);
 			break;
 		}
 		case db_op_t::move_to_db: {
 			auto [from, to] = reader.read<key_type, m_index_type>();
-			 Database::move_to_db(from, get_db(to));
+			// records across databases are redone alone, so the other one is only loaded
+			auto& to_db = get_db(to);
+			to_db.load_shards(shards_of(from));
+			redo_op([&] { Database::move_to_db(from, to_db); }, from);
 			break;
 		}
 
 		case db_op_t::set_expiry: {
 			auto [key, expiry_time] = reader.read<key_type, time_t>();
-			Database::set_expiry(key, expiry_time);
+			redo_op([&] { Database::set_expiry(key, expiry_time); }, key);
 			break;
 		}
 		case db_op_t::clear_expiry: {
-			Database::clear_expiry(reader.read<key_type>());
+			auto key = reader.read<key_type>();
+			redo_op([&] { Database::clear_expiry(key); }, key);
 			break;
 		}
 		case db_op_t::clear_all_expiry: {
+			ShardLock lock{*this, shard_set{}.set()};
 			Database::clear_all_expiry();
 			break;
 		}
 
 		case db_op_t::str_set: {
 			auto [key, value] = reader.read<key_type, std::string>();
-			Database::str_set(key, value);
+			redo_op([&] { Database::str_set(key, value); }, key);
 			break;
 		}
 		case db_op_t::int_set: {
 			auto [key, value] = reader.read<key_type, int_t>();
-			Database::int_set(key, value);
+			redo_op([&] { Database::int_set(key, value); }, key);
 			break;
 		}
 		case db_op_t::float_set: {
 			auto [key, value] = reader.read<key_type, float_t>();
-			Database::float_set(key, value);
+			redo_op([&] { Database::float_set(key, value); }, key);
 			break;
 		}
 		case db_op_t::incr_int: {
 			auto [key, value] = reader.read<key_type, int_t>();
-			Database::incr_int(key, value);
+			redo_op([&] { Database::incr_int(key, value); }, key);
 			break;
 		}
 		case db_op_t::incr_float: {
 			auto [key, value] = reader.read<key_type, float_t>();
-			Database::incr_float(key, value);
+			redo_op([&] { Database::incr_float(key, value); }, key);
 			break;
 		}
 
 		case db_op_t::list_set: {
 			auto [key, index, value] = reader.read<key_type, int64_t, std::string>();
-			Database::list_set(key, index, value);
+			redo_op([&] { Database::list_set(key, index, value); }, key);
 			break;
 		}
 		case db_op_t::list_push_left: {
 			auto [key, values] = reader.read<key_type, list_t>();
-			Database::list_push_left(key, values);
+			redo_op([&] { Database::list_push_left(key, values); }, key);
 			break;
 		}
 		case db_op_t::list_push_right: {
 			auto [key, values] = reader.read<key_type, list_t>();
-			Database::list_push_right(key, values);
+			redo_op([&] { Database::list_push_right(key, values); }, key);
 			break;
 		}
 		case db_op_t::list_pop_left: {
 			auto [key, n] = reader.read<key_type, int64_t>();
-			Database::list_pop_left(key, n);
+			redo_op([&] { Database::list_pop_left(key, n); }, key);
 			break;
 		}
 		case db_op_t::list_pop_right: {
 			auto [key, n] = reader.read<key_type, int64_t>();
-			Database::list_pop_right(key, n);
+			redo_op([&] { Database::list_pop_right(key, n); }, key);
 			break;
 		}
 		case db_op_t::list_trim: {
 			auto [key, start, end] = reader.read<key_type, int64_t, int64_t>();
-			Database::list_trim(key, start, end);
+			redo_op([&] { Database::list_trim(key, start, end); }, key);
 			break;
 		}
 		case db_op_t::list_remove: {
 			auto [key, element, count] = reader.read<key_type, std::string, int64_t>();
-			Database::list_remove(key, element, count);
+			redo_op([&] { Database::list_remove(key, element, count); }, key);
 			break;
 		}
 
 		case db_op_t::set_add: {
 			auto [key, values] = reader.read<key_type, set_t>();
-			Database::set_add(key, values);
+			redo_op([&] { Database::set_add(key, values); }, key);
 			break;
 		}
 		case db_op_t::set_remove: {
 			auto [key, count] = reader.read<key_type, size_t>();
-			Database::set_remove(key, count);
+			redo_op([&] { Database::set_remove(key, count); }, key);
 			break;
 		}
 		case db_op_t::set_discard: {
 			auto [key, values] = reader.read<key_type, set_t>();
-			Database::set_discard(key, values);
+			redo_op([&] { Database::set_discard(key, values); }, key);
 			break;
 		}
 		case db_op_t::set_move: {
 			auto [source, dest, value] = reader.read<key_type, key_type, std::string>();
-			Database::set_move(source, dest, value);
+			redo_op([&] { Database::set_move(source, dest, value); }, source, dest);
 			break;
 		}
 		case db_op_t::set_union_into: {
 			auto [dest, keys] = reader.read<key_type, std::vector<key_type>>();
-			Database::set_union_into(dest, keys);
+			redo_op([&] { Database::set_union_into(dest, keys); }, dest, keys);
 			break;
 		}
 		case db_op_t::set_intersection_into: {
 			auto [dest, keys] = reader.read<key_type, std::vector<key_type>>();
-			Database::set_intersection_into(dest, keys);
+			redo_op([&] { Database::set_intersection_into(dest, keys); }, dest, keys);
 			break;
 		}
 		case db_op_t::set_difference_into: {
 			auto [dest, key1, key2] = reader.read<key_type, key_type, key_type>();
-			Database::set_difference_into(dest, key1, key2);
+			redo_op([&] { Database::set_difference_into(dest, key1, key2); }, dest, key1, key2);
 			break;
 		}
 
 		case db_op_t::hash_set: {
 			auto [key, values] = reader.read<key_type, hash_t>();
-			Database::hash_set(key, values);
+			redo_op([&] { Database::hash_set(key, values); }, key);
 			break;
 		}
 		case db_op_t::hash_remove: {
 			auto [key, hash_keys] = reader.read<key_type, std::vector<string_t>>();
-			Database::hash_remove(key, hash_keys);
+			redo_op([&] { Database::hash_remove(key, hash_keys); }, key);
 			break;
 		}
 		case db_op_t::hash_update: {
 			auto [key, values] = reader.read<key_type, hash_t>();
-			Database::hash_update(key, values);
+			redo_op([&] { Database::hash_update(key, values); }, key);
 			break;
 		}
 
@@ -260,413 +508,366 @@ void LockedDatabase::wal_redo_db_op(trn_id_t trn_id, db_op_t op, serializer::Rea
 }
 
 void LockedDatabase::wal_redo_expiry(const key_type &key) {
-	Database::force_expire(key);
+	redo_op([&] { Database::force_expire(key); }, key);
 }
 
 trn_id_t LockedDatabase::begin(trn_id_t trn) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn, db_op_t::begin);
-	// TODO: begin
+	write_all_op<db_op_t::begin>([] {
+		// TODO: begin
+	}, trn);
 	return trn;
 }
 
 void LockedDatabase::commit(trn_id_t trn_id) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::commit);
-	// TODO: commit
+	write_all_op<db_op_t::commit>([] {
+		// TODO: commit
+	}, trn_id);
 }
 
 void LockedDatabase::discard(trn_id_t trn_id) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::discard);
-	// TODO: discard
+	write_all_op<db_op_t::discard>([] {
+		// TODO: discard
+	}, trn_id);
 }
 
 
 void LockedDatabase::reset(trn_id_t trn_id) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::reset);
-	Database::reset();
+	logger_type::durability_future durable;
+	{
+		// as in wal_redo_db_op(), the shards not loaded yet would only be erased
+		ShardLock lock{*this, shard_set{}.set(), false, false};
+		durable = wal_log<db_op_t::reset>(trn_id);
+		set_aside(shard_set{}.set());
+		drop_unloaded();
+		Database::reset();
+	}
+	durable.get();
 }
 
-bool LockedDatabase::has(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::has, key);
-	return Database::has(key);
+bool LockedDatabase::has(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::has(key); }, key);
 }
 
 bool LockedDatabase::del(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::del, key);
-	return Database::del(key);
+	return write_op<db_op_t::del>(std::tie(key), [&] { return Database::del(key); }, trn_id, key);
 }
 
-std::optional<Database::data_type> LockedDatabase::get(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::get, key);
-	return Database::get(key);
+std::optional<Database::data_type> LockedDatabase::get(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::get(key); }, key);
 }
 
-std::optional<int> LockedDatabase::type(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::type, key);
-	return Database::type(key);
+std::optional<int> LockedDatabase::type(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::type(key); }, key);
 }
 
-std::vector<Database::key_type> LockedDatabase::keys(trn_id_t trn_id) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::keys);
+std::vector<Database::key_type> LockedDatabase::keys(trn_id_t) {
+	auto lock {lock_all()};
 	return Database::keys();
 }
 
 bool LockedDatabase::copy_to(trn_id_t trn_id, const key_type &from, const key_type &to) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::copy_to, from, to);
-	return Database::copy_to(from, to);
+	return write_op<db_op_t::copy_to>(std::tie(from, to), [&] { return Database::copy_to(from, to); }, trn_id, from, to);
 }
 
 bool LockedDatabase::move_to(trn_id_t trn_id, const key_type &from, const key_type &to) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::move_to, from, to);
-	return Database::move_to(from, to);
+	return write_op<db_op_t::move_to>(std::tie(from, to), [&] { return Database::move_to(from, to); }, trn_id, from, to);
 }
 
 bool LockedDatabase::copy_to_db(trn_id_t trn_id, const key_type &from, LockedDatabase &to) {
-	std::scoped_lock lock{m_mutex, to.m_mutex};
-	wal_log(trn_id, db_op_t::copy_to_db, from, to.m_index);
-	return Database::copy_to_db(from, to);
+	if (this == &to)
+		return write_op<db_op_t::copy_to_db>(std::tie(from), [&] { return Database::copy_to_db(from, to); }, trn_id, from, to.m_index);
+
+	load_shards(shards_of(from));
+	to.load_shards(shards_of(from));
+	logger_type::durability_future durable;
+	bool result;
+	{
+		std::scoped_lock lock{mutex(from), to.mutex(from)};
+		preserve(from);
+		to.preserve(from);
+		durable = wal_log<db_op_t::copy_to_db>(trn_id, from, to.m_index);
+		result = Database::copy_to_db(from, to);
+	}
+	durable.get();
+	return result;
 }
 
 bool LockedDatabase::move_to_db(trn_id_t trn_id, const key_type &from, LockedDatabase &to) {
-	std::scoped_lock lock{m_mutex, to.m_mutex};
-	wal_log(trn_id, db_op_t::move_to_db, from, to.m_index);
-	return Database::move_to_db(from, to);
+	if (this == &to)
+		return write_op<db_op_t::move_to_db>(std::tie(from), [&] { return Database::move_to_db(from, to); }, trn_id, from, to.m_index);
+
+	load_shards(shards_of(from));
+	to.load_shards(shards_of(from));
+	logger_type::durability_future durable;
+	bool result;
+	{
+		std::scoped_lock lock{mutex(from), to.mutex(from)};
+		preserve(from);
+		to.preserve(from);
+		durable = wal_log<db_op_t::move_to_db>(trn_id, from, to.m_index);
+		result = Database::move_to_db(from, to);
+	}
+	durable.get();
+	return result;
 }
 
 
 void LockedDatabase::set_expiry(trn_id_t trn_id, const key_type &key, time_t expiry_time) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_expiry, key, expiry_time);
-	Database::set_expiry(key, expiry_time);
+	write_op<db_op_t::set_expiry>(std::tie(key), [&] { Database::set_expiry(key, expiry_time); }, trn_id, key, expiry_time);
 }
 
-std::optional<time_t> LockedDatabase::get_expiry(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::get_expiry, key);
-	return Database::get_expiry(key);
+std::optional<time_t> LockedDatabase::get_expiry(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::get_expiry(key); }, key);
 }
 
 void LockedDatabase::clear_expiry(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::clear_expiry, key);
-	Database::clear_expiry(key);
+	write_op<db_op_t::clear_expiry>(std::tie(key), [&] { Database::clear_expiry(key); }, trn_id, key);
 }
 
 void LockedDatabase::clear_all_expiry(trn_id_t trn_id) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::clear_all_expiry);
-	Database::clear_all_expiry();
+	write_all_op<db_op_t::clear_all_expiry>([&] {
+		preserve_expiring(shard_set{}.set());
+		Database::clear_all_expiry();
+	}, trn_id);
 }
 
 void LockedDatabase::shallow_purge() {
-	std::lock_guard lock{m_mutex};
+	// locking every shard would load the whole database,
+	// and expired keys are erased lazily anyway
+	if (m_loading)
+		return;
+
+	auto lock {lock_all()};
 	Database::shallow_purge();
 }
 
 void LockedDatabase::deep_purge() {
-	std::lock_guard lock{m_mutex};
-	Database::deep_purge();
+	for (size_t shard = 0; shard < M_NUM_SHARDS; ++shard) {
+		// the shards not loaded yet have their expired keys erased lazily
+		ShardLock lock{*this, shard_set{}.set(shard), false, false};
+		if (not m_unloaded[shard])
+			Database::purge_expired(shard, std::numeric_limits<size_t>::max());
+	}
+}
+
+void LockedDatabase::purge_expired() {
+	for (size_t shard = 0; shard < M_NUM_SHARDS; ++shard) {
+		bool more = true;
+		while (more) {
+			// as in deep_purge(), the shards not loaded yet are skipped
+			ShardLock lock{*this, shard_set{}.set(shard), false, false};
+
+			// each slice reads the clock once, later slices see keys expire
+			CachedClock::Batch batch;
+			more = not m_unloaded[shard] and Database::purge_expired(shard, M_PURGE_SLICE);
+		}
+	}
 }
 
 void LockedDatabase::expiry_enabled(bool enable) {
-	std::lock_guard lock{m_mutex};
+	// a flag for the whole database, so nothing needs loading
+	ShardLock lock{*this, shard_set{}.set(), false, false};
 	Database::expiry_enabled(enable);
 }
 
-void LockedDatabase::pre_expire(const key_type &key) {
+void LockedDatabase::pre_expire(key_view_type key) {
+	// the snapshot in progress keeps the expired key
+	preserve(key);
 	m_wal_logger.wal_expiry(key, m_index);
 }
 
 
 void LockedDatabase::str_set(trn_id_t trn_id, const key_type &key, std::string value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::str_set, key, value);
-	Database::str_set(key, std::move(value));
+	write_op<db_op_t::str_set>(std::tie(key), [&] { Database::str_set(key, std::move(value)); }, trn_id, key, value);
 }
 
 void LockedDatabase::int_set(trn_id_t trn_id, const key_type &key, int_t value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::int_set, key, value);
-	Database::int_set(key, value);
+	write_op<db_op_t::int_set>(std::tie(key), [&] { Database::int_set(key, value); }, trn_id, key, value);
 }
 
 void LockedDatabase::float_set(trn_id_t trn_id, const key_type &key, float_t value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::float_set, key, value);
-	Database::float_set(key, value);
+	write_op<db_op_t::float_set>(std::tie(key), [&] { Database::float_set(key, value); }, trn_id, key, value);
 }
 
 std::optional<int_t> LockedDatabase::incr_int(trn_id_t trn_id, const key_type &key, int_t value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::incr_int, key, value);
-	return Database::incr_int(key, value);
+	return write_op<db_op_t::incr_int>(std::tie(key), [&] { return Database::incr_int(key, value); }, trn_id, key, value);
 }
 
 std::optional<float_t> LockedDatabase::incr_float(trn_id_t trn_id, const key_type &key, float_t value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::incr_float, key, value);
-	return Database::incr_float(key, value);
+	return write_op<db_op_t::incr_float>(std::tie(key), [&] { return Database::incr_float(key, value); }, trn_id, key, value);
 }
 
-std::optional<int_t> LockedDatabase::str_len(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::str_len, key);
-	return Database::str_len(key);
+std::optional<int_t> LockedDatabase::str_len(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::str_len(key); }, key);
 }
 
-std::vector<std::optional<Database::data_type>> LockedDatabase::many_get(trn_id_t trn_id, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::many_get, keys);
-	return Database::many_get(keys);
+std::vector<std::optional<Database::data_type>> LockedDatabase::many_get(trn_id_t, const std::vector<key_type> &keys) {
+	return read_op([&] { return Database::many_get(keys); }, keys);
 }
 
 
-std::variant<size_t, ListErrorKind> LockedDatabase::list_len(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_len, key);
-	return Database::list_len(key);
+std::variant<size_t, ListErrorKind> LockedDatabase::list_len(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::list_len(key); }, key);
 }
 
-std::variant<std::string, ListErrorKind> LockedDatabase::list_get(trn_id_t trn_id, const key_type &key, int64_t index) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_get, key, index);
-	return Database::list_get(key, index);
+std::variant<std::string, ListErrorKind> LockedDatabase::list_get(trn_id_t, key_view_type key, int64_t index) {
+	return read_op([&] { return Database::list_get(key, index); }, key);
 }
 
 std::variant<string_t, ListErrorKind>
 LockedDatabase::list_set(trn_id_t trn_id, const key_type &key, int64_t index, std::string value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_set, key, index, value);
-	return Database::list_set(key, index, std::move(value));
+	return write_op<db_op_t::list_set>(std::tie(key), [&] { return Database::list_set(key, index, std::move(value)); }, trn_id, key, index, value);
 }
 
 std::variant<size_t, ListErrorKind> LockedDatabase::list_push_left(trn_id_t trn_id, const key_type &key, list_t values) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_push_left, key, values);
-	return Database::list_push_left(key, std::move(values));
+	return write_op<db_op_t::list_push_left>(std::tie(key), [&] { return Database::list_push_left(key, std::move(values)); }, trn_id, key, values);
 }
 
 std::variant<size_t, ListErrorKind> LockedDatabase::list_push_right(trn_id_t trn_id, const key_type &key, list_t values) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_push_right, key, values);
-	return Database::list_push_right(key, std::move(values));
+	return write_op<db_op_t::list_push_right>(std::tie(key), [&] { return Database::list_push_right(key, std::move(values)); }, trn_id, key, values);
 }
 
 std::variant<list_t, ListErrorKind> LockedDatabase::list_pop_left(trn_id_t trn_id, const key_type &key, int64_t n) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_pop_left, key, n);
-	return Database::list_pop_left(key, n);
+	return write_op<db_op_t::list_pop_left>(std::tie(key), [&] { return Database::list_pop_left(key, n); }, trn_id, key, n);
 }
 
 std::variant<list_t, ListErrorKind> LockedDatabase::list_pop_right(trn_id_t trn_id, const key_type &key, int64_t n) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_pop_right, key, n);
-	return Database::list_pop_right(key, n);
+	return write_op<db_op_t::list_pop_right>(std::tie(key), [&] { return Database::list_pop_right(key, n); }, trn_id, key, n);
 }
 
 std::variant<list_t, ListErrorKind>
-LockedDatabase::list_range(trn_id_t trn_id, const key_type &key, int64_t start, int64_t end) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_range, key, start, end);
-	return Database::list_range(key, start, end);
+LockedDatabase::list_range(trn_id_t, key_view_type key, int64_t start, int64_t end) {
+	return read_op([&] { return Database::list_range(key, start, end); }, key);
 }
 
 std::variant<size_t, ListErrorKind>
 LockedDatabase::list_trim(trn_id_t trn_id, const key_type &key, int64_t start, int64_t end) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_trim, key, start, end);
-	return Database::list_trim(key, start, end);
+	return write_op<db_op_t::list_trim>(std::tie(key), [&] { return Database::list_trim(key, start, end); }, trn_id, key, start, end);
 
 }
 
 std::variant<size_t, ListErrorKind>
 LockedDatabase::list_remove(trn_id_t trn_id, const key_type &key, const std::string &element, int64_t count) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::list_remove, key, element, count);
-	return Database::list_remove(key, element, count);
+	return write_op<db_op_t::list_remove>(std::tie(key), [&] { return Database::list_remove(key, element, count); }, trn_id, key, element, count);
 }
 
 
 std::optional<size_t> LockedDatabase::set_add(trn_id_t trn_id, const key_type &key, set_t values) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_add, key, values);
-	return Database::set_add(key, std::move(values));
+	return write_op<db_op_t::set_add>(std::tie(key), [&] { return Database::set_add(key, std::move(values)); }, trn_id, key, values);
 }
 
-std::optional<set_t> LockedDatabase::set_all(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_all, key);
-	return Database::set_all(key);
+std::optional<set_t> LockedDatabase::set_all(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::set_all(key); }, key);
 }
 
 std::optional<set_t> LockedDatabase::set_remove(trn_id_t trn_id, const key_type &key, size_t count) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_remove, key, count);
-	return Database::set_remove(key, count);
+	return write_op<db_op_t::set_remove>(std::tie(key), [&] { return Database::set_remove(key, count); }, trn_id, key, count);
 }
 
 std::optional<size_t> LockedDatabase::set_discard(trn_id_t trn_id, const key_type &key, const set_t &values) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_discard, key, values);
-	return Database::set_discard(key, values);
+	return write_op<db_op_t::set_discard>(std::tie(key), [&] { return Database::set_discard(key, values); }, trn_id, key, values);
 }
 
-std::optional<size_t> LockedDatabase::set_len(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_len, key);
-	return Database::set_len(key);
+std::optional<size_t> LockedDatabase::set_len(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::set_len(key); }, key);
 }
 
-std::optional<bool> LockedDatabase::set_contains(trn_id_t trn_id, const key_type &key, const std::string &value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_contains, key, value);
-	return Database::set_contains(key, value);
+std::optional<bool> LockedDatabase::set_contains(trn_id_t, key_view_type key, const std::string &value) {
+	return read_op([&] { return Database::set_contains(key, value); }, key);
 }
 
 std::optional<bool> LockedDatabase::set_move(trn_id_t trn_id, const key_type &source, const key_type &dest, const std::string &value) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_move, source, dest, value);
-	return Database::set_move(source, dest, value);
+	return write_op<db_op_t::set_move>(std::tie(source, dest), [&] { return Database::set_move(source, dest, value); }, trn_id, source, dest, value);
 }
 
-std::optional<set_t> LockedDatabase::set_union(trn_id_t trn_id, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_union, keys);
-	return Database::set_union(keys);
+std::optional<set_t> LockedDatabase::set_union(trn_id_t, const std::vector<key_type> &keys) {
+	return read_op([&] { return Database::set_union(keys); }, keys);
 }
 
 std::optional<size_t>
 LockedDatabase::set_union_into(trn_id_t trn_id, const key_type &dest, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_union_into, dest, keys);
-	return Database::set_union_into(dest, keys);
+	return write_op<db_op_t::set_union_into>(std::tie(dest, keys), [&] { return Database::set_union_into(dest, keys); }, trn_id, dest, keys);
 }
 
-std::optional<size_t> LockedDatabase::set_union_len(trn_id_t trn_id, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_union_len, keys);
-	return Database::set_union_len(keys);
+std::optional<size_t> LockedDatabase::set_union_len(trn_id_t, const std::vector<key_type> &keys) {
+	return read_op([&] { return Database::set_union_len(keys); }, keys);
 }
 
-std::optional<set_t> LockedDatabase::set_intersection(trn_id_t trn_id, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_intersection, keys);
-	return Database::set_intersection(keys);
+std::optional<set_t> LockedDatabase::set_intersection(trn_id_t, const std::vector<key_type> &keys) {
+	return read_op([&] { return Database::set_intersection(keys); }, keys);
 }
 
 std::optional<size_t>
 LockedDatabase::set_intersection_into(trn_id_t trn_id, const key_type &dest, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_intersection_into, dest, keys);
-	return Database::set_intersection_into(dest, keys);
+	return write_op<db_op_t::set_intersection_into>(std::tie(dest, keys), [&] { return Database::set_intersection_into(dest, keys); }, trn_id, dest, keys);
 }
 
-std::optional<size_t> LockedDatabase::set_intersection_len(trn_id_t trn_id, const std::vector<key_type> &keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_intersection_len, keys);
-	return Database::set_intersection_len(keys);
+std::optional<size_t> LockedDatabase::set_intersection_len(trn_id_t, const std::vector<key_type> &keys) {
+	return read_op([&] { return Database::set_intersection_len(keys); }, keys);
 }
 
 std::optional<set_t>
-LockedDatabase::set_difference(trn_id_t trn_id, const key_type &key1, const key_type &key2) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_difference, key1, key2);
-	return Database::set_difference(key1, key2);
+LockedDatabase::set_difference(trn_id_t, const key_type &key1, const key_type &key2) {
+	return read_op([&] { return Database::set_difference(key1, key2); }, key1, key2);
 }
 
 std::optional<size_t> LockedDatabase::set_difference_into(trn_id_t trn_id, const key_type &dest, const key_type &key1, const key_type &key2) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_difference_into, dest, key1, key2);
-	return Database::set_difference_into(dest, key1, key2);
+	return write_op<db_op_t::set_difference_into>(std::tie(dest, key1, key2), [&] { return Database::set_difference_into(dest, key1, key2); }, trn_id, dest, key1, key2);
 }
 
 std::optional<size_t>
-LockedDatabase::set_difference_len(trn_id_t trn_id, const key_type &key1, const key_type &key2) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::set_difference_len, key1, key2);
-	return Database::set_difference_len(key1, key2);
+LockedDatabase::set_difference_len(trn_id_t, const key_type &key1, const key_type &key2) {
+	return read_op([&] { return Database::set_difference_len(key1, key2); }, key1, key2);
 }
 
 
 void LockedDatabase::hash_set(trn_id_t trn_id, const key_type &key, hash_t values) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_set, key, values);
-	Database::hash_set(key, std::move(values));
+	write_op<db_op_t::hash_set>(std::tie(key), [&] { Database::hash_set(key, std::move(values)); }, trn_id, key, values);
 }
 
-std::variant<hash_t, HashError> LockedDatabase::hash_all(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_all, key);
-	return Database::hash_all(key);
+std::variant<hash_t, HashError> LockedDatabase::hash_all(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::hash_all(key); }, key);
 }
 
 std::variant<string_t, HashError>
-LockedDatabase::hash_get(trn_id_t trn_id, const key_type &key, const string_t &hash_key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_get, key, hash_key);
-	return Database::hash_get(key, hash_key);
+LockedDatabase::hash_get(trn_id_t, key_view_type key, std::string_view hash_key) {
+	return read_op([&] { return Database::hash_get(key, hash_key); }, key);
 }
 
 std::variant<bool, HashError>
-LockedDatabase::hash_contains(trn_id_t trn_id, const key_type &key, const string_t &hash_key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_contains, key, hash_key);
-	return Database::hash_contains(key, hash_key);
+LockedDatabase::hash_contains(trn_id_t, key_view_type key, std::string_view hash_key) {
+	return read_op([&] { return Database::hash_contains(key, hash_key); }, key);
 }
 
-std::variant<size_t, HashError> LockedDatabase::hash_len(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_len, key);
-	return Database::hash_len(key);
+std::variant<size_t, HashError> LockedDatabase::hash_len(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::hash_len(key); }, key);
 }
 
 std::variant<size_t, HashError>
-LockedDatabase::hash_key_len(trn_id_t trn_id, const key_type &key, const string_t &hash_key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_key_len, key, hash_key);
-	return Database::hash_key_len(key, hash_key);
+LockedDatabase::hash_key_len(trn_id_t, key_view_type key, std::string_view hash_key) {
+	return read_op([&] { return Database::hash_key_len(key, hash_key); }, key);
 }
 
 std::variant<size_t, HashError>
 LockedDatabase::hash_remove(trn_id_t trn_id, const key_type &key, const std::vector<string_t> &hash_keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_remove, key, hash_keys);
-	return Database::hash_remove(key, hash_keys);
+	return write_op<db_op_t::hash_remove>(std::tie(key), [&] { return Database::hash_remove(key, hash_keys); }, trn_id, key, hash_keys);
 }
 
-std::variant<std::vector<string_t>, HashError> LockedDatabase::hash_keys(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_keys, key);
-	return Database::hash_keys(key);
+std::variant<std::vector<string_t>, HashError> LockedDatabase::hash_keys(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::hash_keys(key); }, key);
 }
 
-std::variant<std::vector<string_t>, HashError> LockedDatabase::hash_values(trn_id_t trn_id, const key_type &key) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_values, key);
-	return Database::hash_values(key);
+std::variant<std::vector<string_t>, HashError> LockedDatabase::hash_values(trn_id_t, key_view_type key) {
+	return read_op([&] { return Database::hash_values(key); }, key);
 }
 
 std::variant<size_t, HashError> LockedDatabase::hash_update(trn_id_t trn_id, const key_type &key, hash_t values) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_update, key, values);
-	return Database::hash_update(key, std::move(values));
+	return write_op<db_op_t::hash_update>(std::tie(key), [&] { return Database::hash_update(key, std::move(values)); }, trn_id, key, values);
 }
 
 std::variant<std::vector<std::optional<string_t>>, HashError>
-LockedDatabase::hash_many_get(trn_id_t trn_id, const key_type &key, const std::vector<string_t> &hash_keys) {
-	std::lock_guard lock{m_mutex};
-	wal_log(trn_id, db_op_t::hash_many_get, key, hash_keys);
-	return Database::hash_many_get(key, hash_keys);
+LockedDatabase::hash_many_get(trn_id_t, key_view_type key, const std::vector<string_t> &hash_keys) {
+	return read_op([&] { return Database::hash_many_get(key, hash_keys); }, key);
 }
 
 } // namespace vanity::db
@@ -8,26 +8,132 @@
 #ifndef VANITY_LOCKED_DATABASE_H
 #define VANITY_LOCKED_DATABASE_H
 
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <stop_token>
+#include <tuple>
 
 #include "database.h"
 #include "db/wal/write_ahead_logger.h"
+#include "snapshot.h"
+#include "utils/mapped_file.h"
 
 
 namespace vanity::db {
 
 /*
- * A database that is locked by a mutex.
+ * A database that is locked by a mutex per shard of the keyspace.
+ *
+ * Single-key operations only lock the shard of their key, so operations
+ * on keys in different shards can run concurrently. Multi-key operations
+ * lock all their shards in ascending order, and whole-database operations
+ * lock every shard.
+ *
+ * Read-only operations take the shard locks shared, so reads on the same
+ * shard run concurrently. If a read finds one of its keys expired, it is
+ * promoted to an exclusive lock so the key can be erased.
+ *
+ * A snapshot is taken without stopping writes: begin_snapshot() only marks
+ * every shard as pending, then persist() writes the shards out one at a time.
+ * A write to a shard that is still pending first copies the keys it writes,
+ * as they are, unless they were copied already (copy-on-write at key
+ * granularity). persist() writes out the live keys that were not copied,
+ * then the copies, so every shard is written out as it was when the
+ * snapshot began, and writers only ever copy the keys they write.
+ *
+ * A database can be loaded lazily from a mapped snapshot file: each shard
+ * is parsed the first time it is locked, or by load_all(), so the database
+ * can be used before the whole file has been read. Redoing the WAL loads
+ * only the shards its records touch, reset() drops the shards not loaded
+ * yet, and purges skip them; keys(), clear_all_expiry() and persisting
+ * still load every shard.
  */
 class LockedDatabase : public Database
 {
 private:
-	using lock_type = std::recursive_mutex;
+	using lock_type = std::shared_mutex;
 
-	// the mutex
-	lock_type m_mutex;
+	using mutexes_type = std::array<lock_type, M_NUM_SHARDS>;
+
+	// a set of shards
+	using shard_set = std::bitset<M_NUM_SHARDS>;
+
+	// the most expired keys to delete under one shard lock
+	static constexpr size_t M_PURGE_SLICE = 128;
+
+	// the mutexes, one for each shard
+	mutexes_type m_mutexes;
+
+	// whether a snapshot is in progress
+	std::atomic<bool> m_snapshotting = false;
+
+	// whether each shard is yet to be captured by the snapshot in progress
+	// guarded by the mutex of the shard
+	std::array<bool, M_NUM_SHARDS> m_snapshot_pending {};
+
+	// the keys of each shard written since the snapshot in progress began,
+	// as they were before they were written
+	// guarded by the mutex of the shard
+	std::array<preserved_keys, M_NUM_SHARDS> m_snapshot_keys;
+
+	// shards set aside whole for the snapshot in progress,
+	// because every key in them was about to be removed
+	// guarded by the mutex of the shard
+	std::array<std::optional<shard_type>, M_NUM_SHARDS> m_snapshot_tables;
+
+	// whether any shard is not loaded yet
+	std::atomic<bool> m_loading = false;
+
+	// whether each shard is not loaded yet
+	std::array<std::atomic<bool>, M_NUM_SHARDS> m_unloaded {};
+
+	// the snapshot file shards are loaded from
+	std::shared_ptr<const MappedFile> m_load_file;
+
+	// where each shard is in m_load_file
+	shard_extents m_load_extents {};
 
 public:
+	/*
+	 * A ShardLock holds the locks on a set of shards of a LockedDatabase
+	 *
+	 * The shards are always locked in ascending order,
+	 * so two ShardLocks can never deadlock each other
+	 *
+	 * The shards are loaded before they are locked, if they are not
+	 * loaded yet, unless the lock is taken without loading. Whoever writes to the shards must preserve what
+	 * it writes for the snapshot in progress, if any
+	 */
+	class ShardLock
+	{
+	private:
+		// the database
+		LockedDatabase& m_db;
+
+		// the shards locked
+		shard_set m_shards;
+
+		// whether the shards are locked shared
+		bool m_shared;
+
+	public:
+		// lock the given shards, exclusively or shared,
+		// loading them first unless load is false
+		ShardLock(LockedDatabase& db, shard_set shards, bool shared = false, bool load = true);
+
+		// no copy
+		ShardLock(const ShardLock&) = delete;
+		ShardLock& operator=(const ShardLock&) = delete;
+
+		// unlock the shards
+		~ShardLock();
+	};
+
 	// the logger type
 	using logger_type = wal::WriteAheadLogger;
 
@@ -38,9 +144,93 @@ private:
 	using get_db_func_t = const std::function<LockedDatabase & (m_index_type)>&;
 
 	// log an operation to the WAL
+	// only operations that should_wal() can be logged
+	// returns a future that is ready when the entry is durable
 	// assumes the lock is already acquired
-	template<typename ...Args>
-	inline void wal_log(trn_id_t trn_id, db_op_t op, const Args &... args);
+	template<db_op_t op, typename ...Args>
+	inline logger_type::durability_future wal_log(trn_id_t trn_id, const Args &... args);
+
+	// the mutex for the shard a key is in
+	lock_type& mutex(key_view_type key);
+
+	// the shard a key is in
+	static shard_set shards_of(key_view_type key);
+
+	// the shards a list of keys are in
+	static shard_set shards_of(const std::vector<key_type>& keys);
+
+	// lock a set of shards
+	ShardLock lock_shards(shard_set shards);
+
+	// preserve keys, and lists of keys, for the snapshot in progress
+	// before they are written
+	// assumes their shards are locked exclusively
+	template<typename ...Keys>
+	inline void preserve(const Keys&... keys);
+
+	// preserve a key, if its shard is pending for the snapshot in progress
+	// assumes its shard is locked exclusively
+	void preserve_keys(key_view_type key);
+
+	// preserve a list of keys, as preserve_keys(key_view_type)
+	void preserve_keys(const std::vector<key_type>& keys);
+
+	// preserve every key with an expiry time in some shards
+	// assumes the shards are locked exclusively
+	void preserve_expiring(shard_set shards);
+
+	// set aside the pending shards for the snapshot in progress,
+	// when every key in them is about to be removed
+	// assumes the shards are locked exclusively
+	void set_aside(shard_set shards);
+
+	// load the shards that are not loaded yet
+	// assumes the shards are not locked
+	void load_shards(shard_set shards);
+
+	// load a shard from m_load_file, if it is not loaded yet
+	// assumes the shard is locked exclusively
+	void load_shard_locked(size_t shard);
+
+	// forget the shards not loaded yet, when every key in them is about to be removed
+	// assumes every shard is locked exclusively
+	void drop_unloaded();
+
+	// check if a key is expired
+	bool any_expired(key_view_type key);
+
+	// check if any of a list of keys is expired
+	bool any_expired(const std::vector<key_type>& keys);
+
+	// run a read-only operation on some keys or lists of keys
+	// this holds the shard locks shared and defers expiry,
+	// unless a key is expired, then it holds them exclusively
+	// so the expired keys are erased by the operation
+	template<typename Op, typename ...Keys>
+	inline auto read_op(Op op, const Keys&... keys);
+
+	// run a write operation on some shards, logging it to the WAL first
+	// the operation is logged and applied with the shards locked exclusively,
+	// then this waits for the entry to be durable after unlocking them,
+	// so an acknowledged operation survives a crash of the process
+	// throws WALError if the entry could not be written or synced
+	// the operation must preserve what it writes for the snapshot in progress
+	template<db_op_t op_t, typename Op, typename ...Args>
+	inline auto write_shards_op(shard_set shards, Op op, trn_id_t trn_id, const Args&... args);
+
+	// run a write operation on some keys and lists of keys, as write_shards_op()
+	// the keys are preserved for the snapshot in progress before it runs
+	template<db_op_t op_t, typename ...Keys, typename Op, typename ...Args>
+	inline auto write_op(std::tuple<const Keys&...> keys, Op op, trn_id_t trn_id, const Args&... args);
+
+	// run a write operation on every shard, as write_shards_op()
+	template<db_op_t op_t, typename Op, typename ...Args>
+	inline auto write_all_op(Op op, trn_id_t trn_id, const Args&... args);
+
+	// redo an operation from the WAL on some keys and lists of keys
+	// this loads and locks only the shards of the keys
+	template<typename Op, typename ...Keys>
+	inline void redo_op(Op op, const Keys&... keys);
 
 public:
 	// create a locked database
@@ -57,22 +247,37 @@ public:
 	// move assign a locked database from a database
 	LockedDatabase& operator=(Database&& other) noexcept;
 
-	// load the database from a file stream
-	static LockedDatabase from(std::ifstream &in, logger_type& wal_logger);
+	// load the database from the shards of a mapped snapshot file
+	// the shards are loaded lazily, unless they were written
+	// with a different number of shards
+	// assumes the database is not in use yet
+	void load_from(std::shared_ptr<const MappedFile> file, std::span<const shard_extent> extents);
 
-	// persist the database to a file stream
-	void persist(std::ofstream &out);
+	// load the database from a database file written before snapshots,
+	// its index then its keys in one table, all at once
+	// assumes the database is not in use yet
+	void load_unversioned(serializer::SpanReader &in);
 
+	// load all shards that are not loaded yet, until stop is requested
+	void load_all(std::stop_token stop = {});
 
-	// acquire the lock
-	std::lock_guard<lock_type> lock();
+	// begin a snapshot of the database as it is now
+	// assumes all shards are already locked
+	void begin_snapshot();
 
-	// return a reference to the mutex
-	lock_type& mutex();
+	// persist the snapshot begun by begin_snapshot()
+	// this locks one shard at a time, shared, so
+	// operations carry on while it is written
+	// returns where each shard was written
+	shard_extents persist(serializer::BufferWriter &out);
+
+
+	// lock all shards
+	ShardLock lock_all();
 
 
 	// redo a database operation
-	void wal_redo_db_op(trn_id_t trn_id, db_op_t op, serializer::ReadHandle& reader, get_db_func_t& get_db);
+	void wal_redo_db_op(trn_id_t trn_id, db_op_t op, serializer::ReadHandle<serializer::SpanReader>& reader, get_db_func_t& get_db);
 
 	// redo a key expiry operation
 	void wal_redo_expiry(const key_type &key);
@@ -91,16 +296,16 @@ public:
 	void reset(trn_id_t trn_id);
 
 	// check if the key exists
-	bool has(trn_id_t trn_id, const key_type& key);
+	bool has(trn_id_t trn_id, key_view_type key);
 
 	// delete the value for a key
 	bool del(trn_id_t trn_id, const key_type& key);
 
 	// get the value for a key
-	std::optional<data_type> get(trn_id_t trn_id, const key_type& key);
+	std::optional<data_type> get(trn_id_t trn_id, key_view_type key);
 
 	// get the type of key as an index
-	std::optional<int> type(trn_id_t trn_id, const key_type& key);
+	std::optional<int> type(trn_id_t trn_id, key_view_type key);
 
 	// get all keys in this database
 	std::vector<key_type> keys(trn_id_t trn_id);
@@ -136,7 +341,7 @@ public:
 
 	// get the expiry time for a key
 	// returns std::nullopt if the key has no expiry time
-	std::optional<time_t> get_expiry(trn_id_t trn_id, const key_type &key);
+	std::optional<time_t> get_expiry(trn_id_t trn_id, key_view_type key);
 
 	// clear all expiry times
 	void clear_all_expiry(trn_id_t trn_id);
@@ -156,9 +361,14 @@ public:
 	// this deletes all expired keys in the database
 	// this is a deep purge, and is guaranteed to delete
 	// all expired keys in the database
-	// should not be called often
 	void deep_purge();
 
+	// delete the expired keys in the database, one shard at a time,
+	// in slices of M_PURGE_SLICE keys, so no shard is held for long
+	// the shards not loaded yet are skipped, and the snapshot in progress
+	// keeps the keys it erases
+	void purge_expired();
+
 	// enable or disable global expiry for this database
 	// when enabled, expiry works as normal and keys are expired
 	// when their expiry time is met
@@ -168,7 +378,7 @@ public:
 	void expiry_enabled(bool enable);
 
 	// function called before a key is expired
-	void pre_expire(const key_type& key) override;
+	void pre_expire(key_view_type key) override;
 
 
 	// set a string value for a key
@@ -191,7 +401,7 @@ public:
 	// get the length of a string key
 	// returns the length, or std::nullopt
 	// if the value does not exist or is not a string
-	std::optional<int_t> str_len(trn_id_t trn_id, const key_type &key);
+	std::optional<int_t> str_len(trn_id_t trn_id, key_view_type key);
 
 	// get the value for many keys
 	std::vector<std::optional<data_type>> many_get(trn_id_t trn_id, const std::vector<key_type>& keys);
@@ -200,12 +410,12 @@ public:
 	// get the length of a list key
 	// returns the length, 0 if value does not exist or is empty,
 	// or ListErrorKind::NotList if the value exists and is not a list
-	std::variant<size_t, ListErrorKind> list_len(trn_id_t trn_id, const key_type &key);
+	std::variant<size_t, ListErrorKind> list_len(trn_id_t trn_id, key_view_type key);
 
 	// get the value for a list key at a given index
 	// returns the value, or ListErrorKind::NotList if the value is not a list
 	// or ListErrorKind::OutOfRange if the index is out of range or if value does not exist
-	std::variant<std::string, ListErrorKind> list_get(trn_id_t trn_id, const key_type &key, int64_t index);
+	std::variant<std::string, ListErrorKind> list_get(trn_id_t trn_id, key_view_type key, int64_t index);
 
 	// set the value for a list key at a given index
 	// returns the old value if the value was set, or ListErrorKind::NotList if the value is not a list
@@ -235,7 +445,7 @@ public:
 	// get the value for a range of a list key inclusively
 	// returns the values, or ListErrorKind::NotList if the value is not a list
 	// returns an empty list if the range is out of bounds or invalid
-	std::variant<list_t, ListErrorKind> list_range(trn_id_t trn_id, const key_type &key, int64_t start, int64_t end);
+	std::variant<list_t, ListErrorKind> list_range(trn_id_t trn_id, key_view_type key, int64_t start, int64_t end);
 
 	// trim the list stored at key, so that it will
 	// contain only the specified range of elements (trn_id_t trn_id, inclusively)
@@ -259,7 +469,7 @@ public:
 	// get all elements from a set key
 	// returns the elements,
 	// or std::nullopt if the value is not a set
-	std::optional<set_t> set_all(trn_id_t trn_id, const key_type &key);
+	std::optional<set_t> set_all(trn_id_t trn_id, key_view_type key);
 
 	// randomly remove elements from a set key
 	// returns the elements removed,
@@ -274,12 +484,12 @@ public:
 	// get the length of a set key
 	// returns the length, 0 if value does not exist or is empty,
 	// or std::nullopt if the value exists and is not a set
-	std::optional<size_t> set_len(trn_id_t trn_id, const key_type &key);
+	std::optional<size_t> set_len(trn_id_t trn_id, key_view_type key);
 
 	// check if a set key contains a value
 	// returns true if the value exists,
 	// or std::nullopt if the value is not a set
-	std::optional<bool> set_contains(trn_id_t trn_id, const key_type &key, const std::string& value);
+	std::optional<bool> set_contains(trn_id_t trn_id, key_view_type key, const std::string& value);
 
 	// atomically move an element from one set to another
 	// return false if no operation was performed, true if it was
@@ -339,30 +549,30 @@ public:
 	// get all elements from a hash key
 	// returns the elements,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<hash_t, HashError> hash_all(trn_id_t trn_id, const key_type &key);
+	std::variant<hash_t, HashError> hash_all(trn_id_t trn_id, key_view_type key);
 
 	// get the value of a hash key
 	// returns the value,
 	// or HashError::NotHash if the value is not a hash
 	// or HashError::BadKey if key does not exist
 	// or hash_key does not exist in the hash
-	std::variant<string_t, HashError> hash_get(trn_id_t trn_id, const key_type &key, const string_t& hash_key);
+	std::variant<string_t, HashError> hash_get(trn_id_t trn_id, key_view_type key, std::string_view hash_key);
 
 	// check if a hash key contains a value
 	// returns true if the value exists,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<bool, HashError> hash_contains(trn_id_t trn_id, const key_type &key, const string_t& hash_key);
+	std::variant<bool, HashError> hash_contains(trn_id_t trn_id, key_view_type key, std::string_view hash_key);
 
 	// get the length of a hash
 	// returns the length, 0 if value does not exist or is empty,
 	// or HashError::NotHash if the value exists and is not a hash
-	std::variant<size_t, HashError> hash_len(trn_id_t trn_id, const key_type &key);
+	std::variant<size_t, HashError> hash_len(trn_id_t trn_id, key_view_type key);
 
 	// get the length of a hash key
 	// returns the length, 0 if value does not exist or is empty,
 	// or HashError::NotHash if the value exists and is not a hash
 	// or HashError::BadKey if the hash_key does not exist in the hash
-	std::variant<size_t, HashError> hash_key_len(trn_id_t trn_id, const key_type &key, const string_t& hash_key);
+	std::variant<size_t, HashError> hash_key_len(trn_id_t trn_id, key_view_type key, std::string_view hash_key);
 
 	// remove elements from a hash key
 	// return the number of elements removed,
@@ -372,12 +582,12 @@ public:
 	// get all keys from a hash key
 	// returns the keys,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<std::vector<string_t>, HashError> hash_keys(trn_id_t trn_id, const key_type &key);
+	std::variant<std::vector<string_t>, HashError> hash_keys(trn_id_t trn_id, key_view_type key);
 
 	// get all values from a hash key
 	// returns the values,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<std::vector<string_t>, HashError> hash_values(trn_id_t trn_id, const key_type &key);
+	std::variant<std::vector<string_t>, HashError> hash_values(trn_id_t trn_id, key_view_type key);
 
 	// update the contents of a hash
 	// returns the number of elements added,
@@ -388,7 +598,7 @@ public:
 	// returns the values,
 	// or HashError::NotHash if the value is not a hash
 	std::variant<std::vector<std::optional<string_t>>, HashError>
-	hash_many_get(trn_id_t trn_id, const key_type &key, const std::vector<string_t>& hash_keys);
+	hash_many_get(trn_id_t trn_id, key_view_type key, const std::vector<string_t>& hash_keys);
 };
 
 } // namespace vanity::db
@@ -34,9 +34,10 @@ void PrimitiveDatabase::float_set(const key_type& key, float_t value) {
 std::optional<int_t> PrimitiveDatabase::incr_int(const key_type &key, int_t value) {
 	erase_if_expired(key);
 	if (m_data.contains(key)) {
-		if (std::holds_alternative<int_t>(m_data.at(key))){
-			auto& val = std::get<int_t>(m_data.at(key));
-			val += value;
+		auto& stored = m_data.at(key);
+		if (stored.holds<int_t>()){
+			auto val = stored.get<int_t>() + value;
+			stored = val;
 			return val;
 		}
 		else
@@ -51,9 +52,10 @@ std::optional<int_t> PrimitiveDatabase::incr_int(const key_type &key, int_t valu
 std::optional<float_t> PrimitiveDatabase::incr_float(const key_type &key, float_t value) {
 	erase_if_expired(key);
 	if (m_data.contains(key)) {
-		if (std::holds_alternative<float_t>(m_data.at(key))){
-			auto& val = std::get<float_t>(m_data.at(key));
-			val += value;
+		auto& stored = m_data.at(key);
+		if (stored.holds<float_t>()){
+			auto val = stored.get<float_t>() + value;
+			stored = val;
 			return val;
 		}
 		else
@@ -65,10 +67,10 @@ std::optional<float_t> PrimitiveDatabase::incr_float(const key_type &key, float_
 	}
 }
 
-std::optional<int_t> PrimitiveDatabase::str_len(const key_type &key) {
+std::optional<int_t> PrimitiveDatabase::str_len(key_view_type key) {
 	erase_if_expired(key);
-	if (m_data.contains(key) and std::holds_alternative<string_t>(m_data.at(key)))
-		return std::get<string_t>(m_data.at(key)).size();
+	if (m_data.contains(key) and m_data.at(key).holds<string_t>())
+		return m_data.at(key).string_size();
 	else
 		return std::nullopt;
 }
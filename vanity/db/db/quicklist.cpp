@@ -0,0 +1,295 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include <algorithm>
+
+#include "quicklist.h"
+
+
+namespace vanity::db {
+
+size_t Quicklist::prefix_size(size_t size) {
+	size_t bytes = 1;
+	for (; size >= 0x80; size >>= 7)
+		++bytes;
+	return bytes;
+}
+
+void Quicklist::pack(std::string &bytes, std::string_view value) {
+	auto size = value.size();
+	for (; size >= 0x80; size >>= 7)
+		bytes += static_cast<char>((size & 0x7f) | 0x80);
+	bytes += static_cast<char>(size);
+	bytes += value;
+}
+
+std::string_view Quicklist::unpack(std::string_view bytes, size_t &offset) {
+	size_t size = 0;
+	for (int shift = 0;; shift += 7) {
+		auto byte = static_cast<unsigned char>(bytes[offset++]);
+		size |= static_cast<size_t>(byte & 0x7f) << shift;
+		if (not (byte & 0x80))
+			break;
+	}
+
+	auto value = bytes.substr(offset, size);
+	offset += size;
+	return value;
+}
+
+size_t Quicklist::offset_of(const chunk &c, size_t index) {
+	size_t offset = 0;
+	for (size_t i = 0; i < index; ++i)
+		unpack(c.bytes, offset);
+	return offset;
+}
+
+std::pair<size_t, size_t> Quicklist::locate(size_t index) const {
+	if (index < m_size / 2) {
+		size_t chunk = 0;
+		for (; index >= m_chunks[chunk].count; ++chunk)
+			index -= m_chunks[chunk].count;
+		return {chunk, index};
+	}
+
+	// the position of the element from the back, counting from 1
+	auto from_back = m_size - index;
+	size_t chunk = m_chunks.size() - 1;
+	for (; from_back > m_chunks[chunk].count; --chunk)
+		from_back -= m_chunks[chunk].count;
+	return {chunk, m_chunks[chunk].count - from_back};
+}
+
+void Quicklist::split_if_large(size_t index) {
+	auto& c = m_chunks[index];
+	if (c.bytes.size() <= M_SPLIT_BYTES or c.count < 2)
+		return;
+
+	auto half = c.count / 2;
+	auto offset = offset_of(c, half);
+	chunk second {c.bytes.substr(offset), c.count - half};
+	c.bytes.resize(offset);
+	c.count = half;
+	m_chunks.insert(m_chunks.begin() + static_cast<std::ptrdiff_t>(index) + 1, std::move(second));
+}
+
+
+Quicklist::const_iterator::const_iterator(chunks_type::const_iterator chunk, size_t offset)
+	: m_chunk{chunk}, m_offset{offset} {}
+
+std::string_view Quicklist::const_iterator::operator*() const {
+	auto offset = m_offset;
+	return unpack(m_chunk->bytes, offset);
+}
+
+auto Quicklist::const_iterator::operator++() -> const_iterator& {
+	unpack(m_chunk->bytes, m_offset);
+	if (m_offset == m_chunk->bytes.size()) {
+		++m_chunk;
+		m_offset = 0;
+	}
+	return *this;
+}
+
+auto Quicklist::const_iterator::operator++(int) -> const_iterator {
+	auto copy = *this;
+	++*this;
+	return copy;
+}
+
+
+Quicklist::Quicklist(std::initializer_list<std::string_view> values) {
+	for (auto value : values)
+		push_back(value);
+}
+
+size_t Quicklist::size() const {
+	return m_size;
+}
+
+bool Quicklist::empty() const {
+	return m_size == 0;
+}
+
+auto Quicklist::begin() const -> const_iterator {
+	return {m_chunks.begin(), 0};
+}
+
+auto Quicklist::end() const -> const_iterator {
+	return {m_chunks.end(), 0};
+}
+
+std::string Quicklist::at(size_t index) const {
+	auto [chunk, i] = locate(index);
+	auto offset = offset_of(m_chunks[chunk], i);
+	return std::string{unpack(m_chunks[chunk].bytes, offset)};
+}
+
+std::string Quicklist::set(size_t index, std::string_view value) {
+	auto [chunk, i] = locate(index);
+	auto& c = m_chunks[chunk];
+
+	auto offset = offset_of(c, i);
+	auto end = offset;
+	std::string old {unpack(c.bytes, end)};
+
+	std::string packed;
+	pack(packed, value);
+	c.bytes.replace(offset, end - offset, packed);
+
+	split_if_large(chunk);
+	return old;
+}
+
+void Quicklist::push_front(std::string_view value) {
+	auto size = prefix_size(value.size()) + value.size();
+	if (m_chunks.empty() or m_chunks.front().bytes.size() + size > M_CHUNK_BYTES) {
+		// the full chunk will not grow again, give back its spare capacity
+		if (not m_chunks.empty())
+			m_chunks.front().bytes.shrink_to_fit();
+		m_chunks.emplace_front();
+	}
+
+	std::string packed;
+	packed.reserve(size);
+	pack(packed, value);
+
+	auto& front = m_chunks.front();
+	front.bytes.insert(0, packed);
+	++front.count;
+	++m_size;
+}
+
+void Quicklist::push_back(std::string_view value) {
+	auto size = prefix_size(value.size()) + value.size();
+	if (m_chunks.empty() or m_chunks.back().bytes.size() + size > M_CHUNK_BYTES) {
+		// the full chunk will not grow again, give back its spare capacity
+		if (not m_chunks.empty())
+			m_chunks.back().bytes.shrink_to_fit();
+		m_chunks.emplace_back();
+	}
+
+	auto& back = m_chunks.back();
+	pack(back.bytes, value);
+	++back.count;
+	++m_size;
+}
+
+void Quicklist::emplace_back(std::string_view value) {
+	push_back(value);
+}
+
+Quicklist Quicklist::pop_front(size_t n) {
+	Quicklist popped;
+	n = std::min(n, m_size);
+	m_size -= n;
+	popped.m_size = n;
+
+	while (n > 0) {
+		auto& front = m_chunks.front();
+		if (n >= front.count) {
+			n -= front.count;
+			popped.m_chunks.push_back(std::move(front));
+			m_chunks.pop_front();
+			continue;
+		}
+
+		auto offset = offset_of(front, n);
+		popped.m_chunks.push_back({front.bytes.substr(0, offset), n});
+		front.bytes.erase(0, offset);
+		front.count -= n;
+		n = 0;
+	}
+
+	return popped;
+}
+
+Quicklist Quicklist::pop_back(size_t n) {
+	Quicklist popped;
+	n = std::min(n, m_size);
+	m_size -= n;
+	popped.m_size = n;
+
+	while (n > 0) {
+		auto& back = m_chunks.back();
+		if (n >= back.count) {
+			n -= back.count;
+			popped.m_chunks.push_front(std::move(back));
+			m_chunks.pop_back();
+			continue;
+		}
+
+		auto offset = offset_of(back, back.count - n);
+		popped.m_chunks.push_front({back.bytes.substr(offset), n});
+		back.bytes.resize(offset);
+		back.count -= n;
+		n = 0;
+	}
+
+	return popped;
+}
+
+void Quicklist::erase_front(size_t n) {
+	pop_front(n);
+}
+
+void Quicklist::erase_back(size_t n) {
+	pop_back(n);
+}
+
+Quicklist Quicklist::range(size_t start, size_t end) const {
+	Quicklist copy;
+	end = std::min(end, m_size);
+	if (start >= end)
+		return copy;
+
+	auto [chunk, i] = locate(start);
+	const_iterator it {m_chunks.begin() + static_cast<std::ptrdiff_t>(chunk), offset_of(m_chunks[chunk], i)};
+	for (auto n = end - start; n > 0; --n, ++it)
+		copy.push_back(*it);
+
+	return copy;
+}
+
+size_t Quicklist::remove(std::string_view value, int64_t count) {
+	// with a negative count, keep the matches before the last -count
+	size_t keep_matches = 0;
+	if (count < 0) {
+		auto matches = static_cast<size_t>(std::count(begin(), end(), value));
+		keep_matches = matches - std::min(matches, static_cast<size_t>(-count));
+	}
+
+	Quicklist kept;
+	size_t matches = 0, removed = 0;
+	for (auto element : *this) {
+		if (element == value) {
+			auto remove = count == 0
+				or (count > 0 and removed < static_cast<size_t>(count))
+				or (count < 0 and matches >= keep_matches);
+			++matches;
+
+			if (remove) {
+				++removed;
+				continue;
+			}
+		}
+		kept.push_back(element);
+	}
+
+	if (removed > 0)
+		*this = std::move(kept);
+
+	return removed;
+}
+
+void Quicklist::clear() {
+	m_chunks.clear();
+	m_size = 0;
+}
+
+bool Quicklist::operator==(const Quicklist &other) const {
+	return m_size == other.m_size and std::equal(begin(), end(), other.begin());
+}
+
+} // namespace vanity::db
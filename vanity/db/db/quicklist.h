@@ -0,0 +1,188 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_QUICKLIST_H
+#define VANITY_QUICKLIST_H
+
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+
+namespace vanity::db {
+
+/*
+ * A Quicklist is a list of strings stored in a deque of chunks
+ *
+ * Each chunk packs its strings contiguously, each prefixed with its
+ * length as a varint, so an element costs its bytes and a byte or two,
+ * instead of a heap node and a string of its own. Pushes and pops at
+ * either end touch only the chunk at that end. Finding an element by
+ * index skips whole chunks by their counts, from the nearer end, and
+ * then scans one chunk.
+ */
+class Quicklist
+{
+private:
+	// a chunk stops taking new elements past this many bytes
+	static constexpr size_t M_CHUNK_BYTES = 8 * 1024;
+
+	// a chunk grown by set() past this many bytes is split in two
+	static constexpr size_t M_SPLIT_BYTES = 2 * M_CHUNK_BYTES;
+
+	// a run of packed elements
+	struct chunk {
+		// the length-prefixed elements
+		std::string bytes;
+
+		// the number of elements
+		size_t count = 0;
+	};
+
+	using chunks_type = std::deque<chunk>;
+
+	// the chunks, none of them empty
+	chunks_type m_chunks;
+
+	// the number of elements
+	size_t m_size = 0;
+
+	// the number of bytes the length prefix of a string of some size takes
+	static size_t prefix_size(size_t size);
+
+	// append a length-prefixed element to some bytes
+	static void pack(std::string& bytes, std::string_view value);
+
+	// read the element at an offset in some bytes
+	// and move the offset past it
+	static std::string_view unpack(std::string_view bytes, size_t& offset);
+
+	// the offset of the element at an index in a chunk
+	static size_t offset_of(const chunk& c, size_t index);
+
+	// find the chunk an index is in, and the index within the chunk
+	// walks the chunk counts from the nearer end
+	std::pair<size_t, size_t> locate(size_t index) const;
+
+	// split a chunk in two if set() grew it too large
+	void split_if_large(size_t chunk);
+
+public:
+	/*
+	 * A const_iterator walks a Quicklist front to back,
+	 * yielding a view of each element
+	 */
+	class const_iterator
+	{
+	private:
+		// the chunk the element is in
+		chunks_type::const_iterator m_chunk;
+
+		// the offset of the element in the chunk
+		size_t m_offset = 0;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::string_view;
+
+		const_iterator() = default;
+
+		// an iterator at an offset of a chunk
+		const_iterator(chunks_type::const_iterator chunk, size_t offset);
+
+		// the element
+		std::string_view operator*() const;
+
+		// move to the next element
+		const_iterator& operator++();
+
+		// move to the next element
+		const_iterator operator++(int);
+
+		// whether two iterators are at the same element
+		bool operator==(const const_iterator& other) const = default;
+	};
+
+	using value_type = std::string;
+	using size_type = size_t;
+	using iterator = const_iterator;
+
+	// create an empty list
+	Quicklist() = default;
+
+	// create a list of some strings
+	Quicklist(std::initializer_list<std::string_view> values);
+
+	// create a list of the strings in a range
+	template<typename It>
+	Quicklist(It first, It last) {
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+
+	// the number of elements
+	size_t size() const;
+
+	// whether there are no elements
+	bool empty() const;
+
+	// the first element
+	const_iterator begin() const;
+
+	// past the last element
+	const_iterator end() const;
+
+	// the element at an index, which must be in range
+	std::string at(size_t index) const;
+
+	// replace the element at an index, which must be in range
+	// returns the old element
+	std::string set(size_t index, std::string_view value);
+
+	// add an element at the front
+	void push_front(std::string_view value);
+
+	// add an element at the back
+	void push_back(std::string_view value);
+
+	// add an element at the back
+	void emplace_back(std::string_view value);
+
+	// remove and return the first n elements, at most all of them
+	Quicklist pop_front(size_t n);
+
+	// remove and return the last n elements, at most all of them, in order
+	Quicklist pop_back(size_t n);
+
+	// remove the first n elements, at most all of them
+	void erase_front(size_t n);
+
+	// remove the last n elements, at most all of them
+	void erase_back(size_t n);
+
+	// copy the elements from start up to, not including, end
+	Quicklist range(size_t start, size_t end) const;
+
+	// remove elements equal to value, the first count of them if count is
+	// positive, the last -count if negative, or all of them if 0
+	// returns the number removed
+	size_t remove(std::string_view value, int64_t count);
+
+	// remove all elements
+	void clear();
+
+	// whether two lists have the same elements
+	bool operator==(const Quicklist& other) const;
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_QUICKLIST_H
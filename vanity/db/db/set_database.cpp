@@ -2,6 +2,7 @@
 // Created by kingsli on 11/1/23.
 //
 
+#include <algorithm>
 #include <random>
 
 #include "set_database.h"
@@ -29,26 +30,26 @@ SetDatabase::set_add(const key_type &key, set_t values) {
 		m_data[key] = set_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<set_t>(value))
+	if (not value.holds<set_t>())
 		return std::nullopt;
 
-	auto& set = std::get<set_t>(value);
+	auto& set = value.get<set_t>();
 	auto size = set.size();
-	set.merge(values);
+	set.merge(std::move(values));
 	return set.size() - size;
 }
 
 std::optional<set_t>
-SetDatabase::set_all(const key_type &key) {
+SetDatabase::set_all(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return set_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<set_t>(value))
+	if (not value.holds<set_t>())
 		return std::nullopt;
 
-	return std::get<set_t>(value);
+	return value.get<set_t>();
 }
 
 std::optional<set_t>
@@ -58,21 +59,23 @@ SetDatabase::set_remove(const key_type &key, size_t count) {
 		return set_t{};
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<set_t>(value))
+	if (not value.holds<set_t>())
 		return std::nullopt;
 
-	auto& set = std::get<set_t>(value);
+	auto& set = value.get<set_t>();
 	count = std::min(count, set.size());
 
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
+	thread_local std::random_device rd;
+	thread_local std::mt19937 gen(rd());
 
 	set_t removed;
 	for (size_t i = 0; i < count; ++i) {
 		auto it = set.begin();
 		std::uniform_int_distribution<size_t> dis(0, set.size() - 1);
 		std::advance(it, dis(gen));
-		removed.insert(set.extract(it));
+		auto popped = *it;
+		set.erase(popped);
+		removed.insert(std::move(popped));
 	}
 
 	if (set.empty())
@@ -88,10 +91,10 @@ SetDatabase::set_discard(const key_type &key, const set_t& values) {
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<set_t>(value))
+	if (not value.holds<set_t>())
 		return std::nullopt;
 
-	auto& set = std::get<set_t>(value);
+	auto& set = value.get<set_t>();
 	auto size = set.size();
 	for (const auto& v : values)
 		set.erase(v);
@@ -103,29 +106,29 @@ SetDatabase::set_discard(const key_type &key, const set_t& values) {
 }
 
 std::optional<size_t>
-SetDatabase::set_len(const key_type &key) {
+SetDatabase::set_len(key_view_type key) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return 0ull;
 
 	auto& value = m_data.at(key);
-	if (not std::holds_alternative<set_t>(value))
+	if (not value.holds<set_t>())
 		return std::nullopt;
 
-	return std::get<set_t>(value).size();
+	return value.get<set_t>().size();
 }
 
 std::optional<bool>
-SetDatabase::set_contains(const key_type &key, const std::string &value) {
+SetDatabase::set_contains(key_view_type key, const std::string &value) {
 	erase_if_expired(key);
 	if (not m_data.contains(key))
 		return false;
 
 	auto& val = m_data.at(key);
-	if (not std::holds_alternative<set_t>(val))
+	if (not val.holds<set_t>())
 		return std::nullopt;
 
-	return std::get<set_t>(val).contains(value);
+	return val.get<set_t>().contains(value);
 }
 
 std::optional<bool>
@@ -136,22 +139,24 @@ SetDatabase::set_move(const key_type &source, const key_type &dest, const std::s
 		return false;
 
 	auto& source_val = m_data.at(source);
-	if (not std::holds_alternative<set_t>(source_val))
+	if (not source_val.holds<set_t>())
 		return std::nullopt;
 
-	auto& source_set = std::get<set_t>(source_val);
-	if (not source_set.contains(value))
+	if (not source_val.get<set_t>().contains(value))
 		return false;
 
 	if (not m_data.contains(dest))
 		m_data[dest] = set_t{};
 
 	auto& dest_val = m_data.at(dest);
-	if (not std::holds_alternative<set_t>(dest_val))
+	if (not dest_val.holds<set_t>())
 		return std::nullopt;
 
-	auto& dest_set = std::get<set_t>(dest_val);
-	dest_set.insert(source_set.extract(value));
+	// inserting dest may have moved source, so find it again
+	auto& source_set = m_data.at(source).get<set_t>();
+	auto& dest_set = dest_val.get<set_t>();
+	source_set.erase(value);
+	dest_set.insert(value);
 
 	if (source_set.empty())
 		expiry_aware_del(source);
@@ -173,18 +178,24 @@ SetDatabase::set_union(const std::vector<key_type> &keys) {
 			continue;
 
 		auto& value = m_data.at(key);
-		if (not std::holds_alternative<set_t>(value))
+		if (not value.holds<set_t>())
 			return std::nullopt;
 
-		sets.push_back(&std::get<set_t>(value));
+		sets.push_back(&value.get<set_t>());
 	}
 
-	set_t result;
-	for (const auto& set : sets) {
-		set_t tmp = *set; // copy
-		result.merge(tmp);
+	// sets of integers are merged as sorted arrays
+	if (not sets.empty() and std::all_of(sets.begin(), sets.end(), [](const set_t* set) { return set->intset(); })) {
+		IntSet result;
+		for (const auto& set : sets)
+			result = IntSet::set_union(result, *set->intset());
+		return set_t{std::move(result)};
 	}
 
+	set_t result;
+	for (const auto& set : sets)
+		result.merge(set_t{*set}); // copy
+
 	return result;
 }
 
@@ -224,20 +235,29 @@ SetDatabase::set_intersection(const std::vector<key_type> &keys) {
 			return set_t{};
 
 		auto& value = m_data.at(key);
-		if (not std::holds_alternative<set_t>(value))
+		if (not value.holds<set_t>())
 			return std::nullopt;
 
-		const auto& set = std::get<set_t>(value);
+		const auto& set = value.get<set_t>();
 		sets.push_back(&set);
 		if (not smallest or set.size() < smallest->size())
 			smallest = &set;
 	}
 
+	// sets of integers are intersected as sorted arrays
+	if (std::all_of(sets.begin(), sets.end(), [](const set_t* set) { return set->intset(); })) {
+		IntSet result = *smallest->intset();
+		for (const auto& set : sets)
+			if (set != smallest)
+				result = IntSet::set_intersection(result, *set->intset());
+		return set_t{std::move(result)};
+	}
+
 	set_t result;
 	for (const auto& value : *smallest) {
 		bool common = true;
 		for (const auto& set : sets) {
-			if (&set == &smallest)
+			if (set == smallest)
 				continue;
 
 			if (not set->contains(value)) {
@@ -283,11 +303,14 @@ SetDatabase::set_difference(const key_type &key1, const key_type &key2) {
 
 	auto& value1 = m_data.at(key1);
 	auto& value2 = m_data.at(key2);
-	if (not std::holds_alternative<set_t>(value1) or not std::holds_alternative<set_t>(value2))
+	if (not value1.holds<set_t>() or not value2.holds<set_t>())
 		return std::nullopt;
 
-	const auto& set1 = std::get<set_t>(value1);
-	const auto& set2 = std::get<set_t>(value2);
+	const auto& set1 = value1.get<set_t>();
+	const auto& set2 = value2.get<set_t>();
+	if (set1.intset() and set2.intset())
+		return set_t{IntSet::set_difference(*set1.intset(), *set2.intset())};
+
 	set_t result;
 	for (const auto& value : set1) {
 		if (not set2.contains(value))
@@ -37,7 +37,7 @@ class SetDatabase : public virtual BaseDatabase
 	// get all elements from a set key
 	// returns the elements,
 	// or std::nullopt if the value is not a set
-	std::optional<set_t> set_all(const key_type &key);
+	std::optional<set_t> set_all(key_view_type key);
 
 	// randomly remove elements from a set key
 	// returns the elements removed,
@@ -52,12 +52,12 @@ class SetDatabase : public virtual BaseDatabase
 	// get the length of a set key
 	// returns the length, 0 if value does not exist or is empty,
 	// or std::nullopt if the value exists and is not a set
-	std::optional<size_t> set_len(const key_type &key);
+	std::optional<size_t> set_len(key_view_type key);
 
 	// check if a set key contains a value
 	// returns true if the value exists,
 	// or std::nullopt if the value is not a set
-	std::optional<bool> set_contains(const key_type &key, const std::string& value);
+	std::optional<bool> set_contains(key_view_type key, const std::string& value);
 
 	// atomically move an element from one set to another
 	// return false if no operation was performed, true if it was
@@ -0,0 +1,292 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_SHARDED_MAP_H
+#define VANITY_SHARDED_MAP_H
+
+#include <array>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "key_table.h"
+
+
+namespace vanity::db {
+
+// number of shards a ShardedMap is split into
+static constexpr size_t M_NUM_SHARDS = 32;
+
+// get the shard a key belongs to
+// all ShardedMaps with the same key type agree on this,
+// and a std::string_view key agrees with its std::string
+template<typename K>
+inline size_t shard_of(const K& key) {
+	return std::hash<K>{}(key) % M_NUM_SHARDS;
+}
+
+/*
+ * A ShardedMap is a map split into M_NUM_SHARDS hash-partitioned shards
+ *
+ * A key always lives in the same shard, so operations on keys in
+ * different shards never touch the same underlying map, and can
+ * safely run concurrently as long as each shard is locked
+ *
+ * Each shard is a KeyTable, so each key also has an optional expiry
+ * time stored alongside its value
+ *
+ * With a transparent Hash, keys can be looked up by any
+ * type the hash and std::equal_to<> accept, without a conversion
+ */
+template<typename K, typename V, typename Hash = std::hash<K>>
+class ShardedMap
+{
+public:
+	using map_type = KeyTable<K, V, Hash>;
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = typename map_type::value_type;
+	using size_type = size_t;
+	using time_point = typename map_type::time_point;
+
+private:
+	using shards_type = std::array<map_type, M_NUM_SHARDS>;
+
+	// the shards
+	shards_type m_shards;
+
+	// get the shard a key belongs to
+	template<typename Q>
+	map_type& shard_for(const Q& key) {
+		return m_shards[shard_of(key)];
+	}
+
+	// get the shard a key belongs to
+	template<typename Q>
+	const map_type& shard_for(const Q& key) const {
+		return m_shards[shard_of(key)];
+	}
+
+	/*
+	 * A forward iterator over all entries in all shards
+	 */
+	template<bool Const>
+	class basic_iterator
+	{
+	private:
+		using shards_ptr = std::conditional_t<Const, const shards_type*, shards_type*>;
+		using inner_type = std::conditional_t<Const, typename map_type::const_iterator, typename map_type::iterator>;
+
+		// the shards being iterated
+		shards_ptr m_shards = nullptr;
+
+		// the index of the current shard
+		size_t m_shard = M_NUM_SHARDS;
+
+		// the position in the current shard
+		inner_type m_it {};
+
+		// advance to the next shard with an entry, if the current one is exhausted
+		void skip_exhausted() {
+			while (m_shard < M_NUM_SHARDS and m_it == (*m_shards)[m_shard].end())
+				if (++m_shard < M_NUM_SHARDS)
+					m_it = (*m_shards)[m_shard].begin();
+		}
+
+	public:
+		using iterator_concept = std::forward_iterator_tag;
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename map_type::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, const value_type&, value_type&>;
+		using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+		// create an end iterator
+		basic_iterator() = default;
+
+		// create an iterator at the start of shard
+		basic_iterator(shards_ptr shards, size_t shard) : m_shards{shards}, m_shard{shard} {
+			if (m_shard < M_NUM_SHARDS) {
+				m_it = (*m_shards)[m_shard].begin();
+				skip_exhausted();
+			}
+		}
+
+		// a non-const iterator converts to a const iterator
+		operator basic_iterator<true>() const requires (not Const) {
+			basic_iterator<true> ret;
+			ret.m_shards = m_shards;
+			ret.m_shard = m_shard;
+			ret.m_it = m_it;
+			return ret;
+		}
+
+		reference operator*() const {
+			return *m_it;
+		}
+
+		pointer operator->() const {
+			return &*m_it;
+		}
+
+		basic_iterator& operator++() {
+			++m_it;
+			skip_exhausted();
+			return *this;
+		}
+
+		basic_iterator operator++(int) {
+			auto ret = *this;
+			++*this;
+			return ret;
+		}
+
+		bool operator==(const basic_iterator& other) const {
+			return m_shard == other.m_shard and (m_shard == M_NUM_SHARDS or m_it == other.m_it);
+		}
+
+		friend class basic_iterator<not Const>;
+	};
+
+public:
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	// get a shard by index
+	map_type& shard(size_t index) {
+		return m_shards[index];
+	}
+
+	// get a shard by index
+	const map_type& shard(size_t index) const {
+		return m_shards[index];
+	}
+
+	// get the value for a key, or nullptr if it does not exist
+	template<typename Q>
+	V* find(const Q& key) {
+		return shard_for(key).find(key);
+	}
+
+	// get the value for a key, or nullptr if it does not exist
+	template<typename Q>
+	const V* find(const Q& key) const {
+		return shard_for(key).find(key);
+	}
+
+	// check if a key exists
+	template<typename Q>
+	bool contains(const Q& key) const {
+		return shard_for(key).contains(key);
+	}
+
+	// get the value for a key, throwing if it does not exist
+	template<typename Q>
+	V& at(const Q& key) {
+		if (auto value = find(key))
+			return *value;
+		throw std::out_of_range("ShardedMap::at");
+	}
+
+	// get the value for a key, throwing if it does not exist
+	template<typename Q>
+	const V& at(const Q& key) const {
+		if (auto value = find(key))
+			return *value;
+		throw std::out_of_range("ShardedMap::at");
+	}
+
+	// get the value for a key, default-inserting it if it does not exist
+	V& operator[](const K& key) {
+		return shard_for(key)[key];
+	}
+
+	// insert a key-value pair if the key does not exist
+	bool insert(std::pair<K, V>&& value) {
+		auto& shard = shard_for(value.first);
+		return shard.insert(std::move(value.first), std::move(value.second));
+	}
+
+	// erase a key, returning the number of elements erased
+	template<typename Q>
+	size_type erase(const Q& key) {
+		return shard_for(key).erase(key);
+	}
+
+	// get the expiry time of a key, or nullptr if it has none
+	template<typename Q>
+	const time_point* expiry(const Q& key) const {
+		return shard_for(key).expiry(key);
+	}
+
+	// set the expiry time of a key
+	// returns false, and does nothing, if the key does not exist
+	template<typename Q>
+	bool set_expiry(const Q& key, time_point expiry) {
+		return shard_for(key).set_expiry(key, expiry);
+	}
+
+	// clear the expiry time of a key, if it has one
+	template<typename Q>
+	void clear_expiry(const Q& key) {
+		shard_for(key).clear_expiry(key);
+	}
+
+	// clear the expiry times of all keys
+	void clear_all_expiry() {
+		for (auto& shard : m_shards)
+			shard.clear_all_expiry();
+	}
+
+	// the total number of keys with an expiry time in all shards
+	size_type expiring() const {
+		size_type expiring = 0;
+		for (auto& shard : m_shards)
+			expiring += shard.expiring();
+		return expiring;
+	}
+
+	// the total number of elements in all shards
+	size_type size() const {
+		size_type size = 0;
+		for (auto& shard : m_shards)
+			size += shard.size();
+		return size;
+	}
+
+	// check if all shards are empty
+	bool empty() const {
+		for (auto& shard : m_shards)
+			if (not shard.empty())
+				return false;
+		return true;
+	}
+
+	// clear all shards
+	void clear() {
+		for (auto& shard : m_shards)
+			shard.clear();
+	}
+
+	iterator begin() {
+		return {&m_shards, 0};
+	}
+
+	iterator end() {
+		return {};
+	}
+
+	const_iterator begin() const {
+		return {&m_shards, 0};
+	}
+
+	const_iterator end() const {
+		return {};
+	}
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_SHARDED_MAP_H
@@ -0,0 +1,54 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_SNAPSHOT_H
+#define VANITY_SNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "sharded_map.h"
+
+
+namespace vanity::db {
+
+/*
+ * The snapshot (database file) format
+ *
+ * A snapshot starts with a header of M_SNAPSHOT_MAGIC, the format version
+ * and the last WAL epoch it covers. The shards of every database follow, each
+ * as written by Database::persist_shard(). The file ends with an index of where
+ * each shard is, then the offset of the index, so a loader can find any shard
+ * without reading the ones before it.
+ *
+ * A database file that does not start with M_SNAPSHOT_MAGIC was written
+ * before snapshots: every database as its index then its keys in one table,
+ * with no header and no index. It is still loaded, all at once.
+ */
+
+// the magic bytes at the start of a snapshot
+static constexpr std::string_view M_SNAPSHOT_MAGIC = "VSNP";
+
+// the version of the snapshot format
+static constexpr uint8_t M_SNAPSHOT_VERSION = 1;
+
+// the size of the snapshot header
+static constexpr size_t M_SNAPSHOT_HEADER_SIZE = M_SNAPSHOT_MAGIC.size() + sizeof(M_SNAPSHOT_VERSION) + sizeof(uint64_t);
+
+// where a shard is in a snapshot
+struct shard_extent {
+	// the offset of the shard from the start of the file
+	uint64_t offset;
+
+	// the size of the shard
+	uint64_t size;
+};
+
+// where each shard of a database is in a snapshot
+using shard_extents = std::array<shard_extent, M_NUM_SHARDS>;
+
+} // namespace vanity::db
+
+#endif //VANITY_SNAPSHOT_H
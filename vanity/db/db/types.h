@@ -8,13 +8,14 @@
 #include <chrono>
 #include <exception>
 #include <fstream>
-#include <list>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include "compact_hash.h"
+#include "compact_set.h"
+#include "quicklist.h"
 
 
 namespace vanity::db {
@@ -23,13 +24,14 @@ using string_t = std::string;
 using int_t = int64_t;
 using float_t = double;
 
-using list_t = std::list<string_t>;
-using set_t = std::unordered_set<string_t>;
-using hash_t = std::unordered_map<string_t, string_t>;
+using list_t = Quicklist;
+using set_t = CompactSet;
+using hash_t = CompactHash;
 
 using time_t = std::chrono::time_point<std::chrono::system_clock>;
 
 using db_key_type = string_t;
+using db_key_view_type = std::string_view;
 
 using db_data_type = std::variant<string_t, int_t, float_t, list_t, set_t, hash_t>;
 
@@ -0,0 +1,199 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include <charconv>
+#include <stdexcept>
+
+#include "intset.h"
+#include "value.h"
+
+
+namespace vanity::db {
+
+static_assert(sizeof(Value) == 16);
+
+auto Value::get_encoding() const -> encoding {
+	return static_cast<encoding>(m_bytes[M_MAX_INLINE] & 0x0f);
+}
+
+size_t Value::inline_size() const {
+	return m_bytes[M_MAX_INLINE] >> 4;
+}
+
+void Value::set_tag(encoding enc, size_t size) {
+	m_bytes[M_MAX_INLINE] = static_cast<unsigned char>(static_cast<uint8_t>(enc) | size << 4);
+}
+
+void Value::destroy() {
+	switch (get_encoding()) {
+		case encoding::HEAP_STRING:
+			delete load<string_t*>();
+			break;
+		case encoding::LIST:
+			delete load<list_t*>();
+			break;
+		case encoding::SET:
+			delete load<set_t*>();
+			break;
+		case encoding::HASH:
+			delete load<hash_t*>();
+			break;
+		default:
+			break;
+	}
+}
+
+Value::Value() {
+	set_tag(encoding::INLINE_STRING);
+}
+
+Value::Value(string_t value) {
+	if (value.size() <= M_MAX_INLINE) {
+		std::memcpy(m_bytes, value.data(), value.size());
+		set_tag(encoding::INLINE_STRING, value.size());
+	}
+	else if (auto integer = IntSet::parse(value)) {
+		store(*integer);
+		set_tag(encoding::INT_STRING);
+	}
+	else {
+		store(new string_t(std::move(value)));
+		set_tag(encoding::HEAP_STRING);
+	}
+}
+
+Value::Value(int_t value) {
+	store(value);
+	set_tag(encoding::INT);
+}
+
+Value::Value(float_t value) {
+	store(value);
+	set_tag(encoding::FLOAT);
+}
+
+Value::Value(list_t value) {
+	store(new list_t(std::move(value)));
+	set_tag(encoding::LIST);
+}
+
+Value::Value(set_t value) {
+	store(new set_t(std::move(value)));
+	set_tag(encoding::SET);
+}
+
+Value::Value(hash_t value) {
+	store(new hash_t(std::move(value)));
+	set_tag(encoding::HASH);
+}
+
+Value::Value(db_data_type value)
+	: Value(std::visit([](auto& v) { return Value{std::move(v)}; }, value)) {}
+
+Value::Value(const Value &other) {
+	switch (other.get_encoding()) {
+		case encoding::HEAP_STRING:
+			store(new string_t(*other.load<string_t*>()));
+			break;
+		case encoding::LIST:
+			store(new list_t(*other.load<list_t*>()));
+			break;
+		case encoding::SET:
+			store(new set_t(*other.load<set_t*>()));
+			break;
+		case encoding::HASH:
+			store(new hash_t(*other.load<hash_t*>()));
+			break;
+		default:
+			std::memcpy(m_bytes, other.m_bytes, M_SIZE);
+			return;
+	}
+	m_bytes[M_MAX_INLINE] = other.m_bytes[M_MAX_INLINE];
+}
+
+Value &Value::operator=(const Value &other) {
+	if (this != &other)
+		*this = Value{other};
+	return *this;
+}
+
+Value::Value(Value &&other) noexcept {
+	std::memcpy(m_bytes, other.m_bytes, M_SIZE);
+	other.set_tag(encoding::INLINE_STRING);
+}
+
+Value &Value::operator=(Value &&other) noexcept {
+	if (this != &other) {
+		destroy();
+		std::memcpy(m_bytes, other.m_bytes, M_SIZE);
+		other.set_tag(encoding::INLINE_STRING);
+	}
+	return *this;
+}
+
+Value::~Value() {
+	destroy();
+}
+
+size_t Value::index() const {
+	switch (get_encoding()) {
+		case encoding::INLINE_STRING:
+		case encoding::INT_STRING:
+		case encoding::HEAP_STRING:
+			return index_of<string_t>();
+		case encoding::INT:
+			return index_of<int_t>();
+		case encoding::FLOAT:
+			return index_of<float_t>();
+		case encoding::LIST:
+			return index_of<list_t>();
+		case encoding::SET:
+			return index_of<set_t>();
+		case encoding::HASH:
+			return index_of<hash_t>();
+	}
+	throw std::runtime_error("invalid encoding");
+}
+
+std::string_view Value::view(string_buffer &buffer) const {
+	switch (get_encoding()) {
+		case encoding::INLINE_STRING:
+			return {reinterpret_cast<const char*>(m_bytes), inline_size()};
+		case encoding::INT_STRING: {
+			auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), load<int64_t>());
+			return {buffer.data(), end};
+		}
+		case encoding::HEAP_STRING:
+			return *load<string_t*>();
+		default:
+			throw std::bad_variant_access{};
+	}
+}
+
+size_t Value::string_size() const {
+	string_buffer buffer;
+	return view(buffer).size();
+}
+
+db_data_type Value::data() const {
+	switch (get_encoding()) {
+		case encoding::INLINE_STRING:
+		case encoding::INT_STRING:
+		case encoding::HEAP_STRING:
+			return get<string_t>();
+		case encoding::INT:
+			return get<int_t>();
+		case encoding::FLOAT:
+			return get<float_t>();
+		case encoding::LIST:
+			return get<list_t>();
+		case encoding::SET:
+			return get<set_t>();
+		case encoding::HASH:
+			return get<hash_t>();
+	}
+	throw std::runtime_error("invalid encoding");
+}
+
+} // namespace vanity::db
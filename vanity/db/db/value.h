@@ -0,0 +1,187 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_VALUE_H
+#define VANITY_VALUE_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "types.h"
+
+
+namespace vanity::db {
+
+/*
+ * A Value is a db_data_type stored in 16 bytes
+ *
+ * The last byte is a tag holding the encoding, and the length of an
+ * inline string. Strings of up to M_MAX_INLINE bytes are kept inline,
+ * longer strings that are the canonical form of an integer are kept as
+ * that integer, and other strings are kept behind a pointer. Integers
+ * and floats are kept inline, and lists, sets and hashes behind a
+ * pointer. Requests and responses still see a db_data_type
+ */
+class Value
+{
+private:
+	// the size of a value
+	static constexpr size_t M_SIZE = 16;
+
+	// the longest string kept inline
+	static constexpr size_t M_MAX_INLINE = M_SIZE - 1;
+
+	// how the value is stored
+	enum class encoding : uint8_t
+	{
+		INLINE_STRING,
+		INT_STRING,
+		HEAP_STRING,
+		INT,
+		FLOAT,
+		LIST,
+		SET,
+		HASH,
+	};
+
+	// the payload, then the tag
+	alignas(8) unsigned char m_bytes[M_SIZE];
+
+	// the encoding in the tag
+	encoding get_encoding() const;
+
+	// the length of an inline string in the tag
+	size_t inline_size() const;
+
+	// set the tag
+	void set_tag(encoding enc, size_t size = 0);
+
+	// read something from the start of the payload
+	template<typename T>
+	T load() const {
+		T value;
+		std::memcpy(&value, m_bytes, sizeof(T));
+		return value;
+	}
+
+	// write something to the start of the payload
+	template<typename T>
+	void store(T value) {
+		std::memcpy(m_bytes, &value, sizeof(T));
+	}
+
+	// the list, set or hash, or throws std::bad_variant_access
+	template<typename T>
+	T* container() const {
+		if (not holds<T>())
+			throw std::bad_variant_access{};
+		return load<T*>();
+	}
+
+	// free anything behind a pointer
+	void destroy();
+
+	// the index of a type in db_data_type
+	template<typename T, size_t I = 0>
+	static constexpr size_t index_of() {
+		if constexpr (std::is_same_v<T, db_index_t<I>>)
+			return I;
+		else
+			return index_of<T, I + 1>();
+	}
+
+public:
+	// long enough for any integer encoded string
+	using string_buffer = std::array<char, 20>;
+
+	// an empty string
+	Value();
+
+	// a string, in the smallest encoding that holds it
+	Value(string_t value);
+
+	// an integer
+	Value(int_t value);
+
+	// a float
+	Value(float_t value);
+
+	// a list
+	Value(list_t value);
+
+	// a set
+	Value(set_t value);
+
+	// a hash
+	Value(hash_t value);
+
+	// any db_data_type
+	explicit Value(db_data_type value);
+
+	// copy the value, including anything behind a pointer
+	Value(const Value& other);
+	Value& operator=(const Value& other);
+
+	// move the value, leaving an empty string behind
+	Value(Value&& other) noexcept;
+	Value& operator=(Value&& other) noexcept;
+
+	// destroy the value
+	~Value();
+
+	// the index of the type in db_data_type
+	size_t index() const;
+
+	// whether the value is a type
+	template<typename T>
+	bool holds() const {
+		return index() == index_of<T>();
+	}
+
+	// the value as a type, or throws std::bad_variant_access
+	// lists, sets and hashes are returned by reference, the rest by value
+	template<typename T>
+	decltype(auto) get() const {
+		if constexpr (std::is_same_v<T, list_t> or std::is_same_v<T, set_t> or std::is_same_v<T, hash_t>)
+			return static_cast<const T&>(*container<T>());
+		else if constexpr (std::is_same_v<T, string_t>) {
+			string_buffer buffer;
+			return string_t{view(buffer)};
+		}
+		else {
+			if (not holds<T>())
+				throw std::bad_variant_access{};
+			return load<T>();
+		}
+	}
+
+	// the value as a type, or throws std::bad_variant_access
+	// lists, sets and hashes are returned by reference, the rest by value
+	template<typename T>
+	decltype(auto) get() {
+		if constexpr (std::is_same_v<T, list_t> or std::is_same_v<T, set_t> or std::is_same_v<T, hash_t>)
+			return static_cast<T&>(*container<T>());
+		else
+			return std::as_const(*this).get<T>();
+	}
+
+	// the string, formatting an integer encoded string into a buffer
+	// or throws std::bad_variant_access
+	std::string_view view(string_buffer& buffer) const;
+
+	// the length of the string, or throws std::bad_variant_access
+	size_t string_size() const;
+
+	// a copy of the value as a db_data_type
+	db_data_type data() const;
+};
+
+} // namespace vanity::db
+
+#endif //VANITY_VALUE_H
@@ -29,6 +29,11 @@ void DatabaseObjectServer::deep_purge_databases() {
 		db.deep_purge();
 }
 
+void DatabaseObjectServer::purge_expired_databases() {
+	for (auto& db: m_databases)
+		db.purge_expired();
+}
+
 void DatabaseObjectServer::enable_databases_expiry(bool enable) {
 	for (auto& db: m_databases)
 		db.expiry_enabled(enable);
@@ -54,6 +54,9 @@ protected:
 	// convenience function to deep_purge() all databases
 	void deep_purge_databases();
 
+	// convenience function to purge_expired() in all databases
+	void purge_expired_databases();
+
 	// enable (or disable) expiry for all databases
 	void enable_databases_expiry(bool enable);
 
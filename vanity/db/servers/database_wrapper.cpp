@@ -13,7 +13,7 @@ void DatabaseWrapper::reset() {
 	m_database.reset(m_trn_id);
 }
 
-bool DatabaseWrapper::has(const key_type &key) {
+bool DatabaseWrapper::has(key_view_type key) {
 	return m_database.has(m_trn_id, key);
 }
 
@@ -21,11 +21,11 @@ bool DatabaseWrapper::del(const key_type &key) {
 	return m_database.del(m_trn_id, key);
 }
 
-std::optional<db::db_data_type> DatabaseWrapper::get(const key_type &key) {
+std::optional<db::db_data_type> DatabaseWrapper::get(key_view_type key) {
 	return m_database.get(m_trn_id, key);
 }
 
-std::optional<int> DatabaseWrapper::type(const key_type &key) {
+std::optional<int> DatabaseWrapper::type(key_view_type key) {
 	return m_database.type(m_trn_id, key);
 }
 
@@ -54,7 +54,7 @@ void DatabaseWrapper::set_expiry(const key_type &key, time_t expiry_time) {
 	m_database.set_expiry(m_trn_id, key, expiry_time);
 }
 
-std::optional<time_t> DatabaseWrapper::get_expiry(const key_type &key) {
+std::optional<time_t> DatabaseWrapper::get_expiry(key_view_type key) {
 	return m_database.get_expiry(m_trn_id, key);
 }
 
@@ -87,7 +87,7 @@ std::optional<float_t> DatabaseWrapper::incr_float(const key_type &key, float_t
 	return m_database.incr_float(m_trn_id, key, value);
 }
 
-std::optional<int_t> DatabaseWrapper::str_len(const key_type &key) {
+std::optional<int_t> DatabaseWrapper::str_len(key_view_type key) {
 	return m_database.str_len(m_trn_id, key);
 }
 
@@ -96,11 +96,11 @@ std::vector<std::optional<db::db_data_type>> DatabaseWrapper::many_get(const std
 }
 
 
-std::variant<size_t, ListErrorKind> DatabaseWrapper::list_len(const key_type &key) {
+std::variant<size_t, ListErrorKind> DatabaseWrapper::list_len(key_view_type key) {
 	return m_database.list_len(m_trn_id, key);
 }
 
-std::variant<std::string, ListErrorKind> DatabaseWrapper::list_get(const key_type &key, int64_t index) {
+std::variant<std::string, ListErrorKind> DatabaseWrapper::list_get(key_view_type key, int64_t index) {
 	return m_database.list_get(m_trn_id, key, index);
 }
 
@@ -126,7 +126,7 @@ std::variant<list_t, ListErrorKind> DatabaseWrapper::list_pop_right(const key_ty
 }
 
 std::variant<list_t, ListErrorKind>
-DatabaseWrapper::list_range(const key_type &key, int64_t start, int64_t end) {
+DatabaseWrapper::list_range(key_view_type key, int64_t start, int64_t end) {
 	return m_database.list_range(m_trn_id, key, start, end);
 }
 
@@ -146,7 +146,7 @@ std::optional<size_t> DatabaseWrapper::set_add(const key_type &key, set_t values
 	return m_database.set_add(m_trn_id, key, std::move(values));
 }
 
-std::optional<set_t> DatabaseWrapper::set_all(const key_type &key) {
+std::optional<set_t> DatabaseWrapper::set_all(key_view_type key) {
 	return m_database.set_all(m_trn_id, key);
 }
 
@@ -158,11 +158,11 @@ std::optional<size_t> DatabaseWrapper::set_discard(const key_type &key, const se
 	return m_database.set_discard(m_trn_id, key, values);
 }
 
-std::optional<size_t> DatabaseWrapper::set_len(const key_type &key) {
+std::optional<size_t> DatabaseWrapper::set_len(key_view_type key) {
 	return m_database.set_len(m_trn_id, key);
 }
 
-std::optional<bool> DatabaseWrapper::set_contains(const key_type &key, const std::string &value) {
+std::optional<bool> DatabaseWrapper::set_contains(key_view_type key, const std::string &value) {
 	return m_database.set_contains(m_trn_id, key, value);
 }
 
@@ -215,26 +215,26 @@ void DatabaseWrapper::hash_set(const key_type &key, hash_t values) {
 	m_database.hash_set(m_trn_id, key, std::move(values));
 }
 
-std::variant<hash_t, HashError> DatabaseWrapper::hash_all(const key_type &key) {
+std::variant<hash_t, HashError> DatabaseWrapper::hash_all(key_view_type key) {
 	return m_database.hash_all(m_trn_id, key);
 }
 
 std::variant<string_t, HashError>
-DatabaseWrapper::hash_get(const key_type &key, const string_t &hash_key) {
+DatabaseWrapper::hash_get(key_view_type key, std::string_view hash_key) {
 	return m_database.hash_get(m_trn_id, key, hash_key);
 }
 
 std::variant<bool, HashError>
-DatabaseWrapper::hash_contains(const key_type &key, const string_t &hash_key) {
+DatabaseWrapper::hash_contains(key_view_type key, std::string_view hash_key) {
 	return m_database.hash_contains(m_trn_id, key, hash_key);
 }
 
-std::variant<size_t, HashError> DatabaseWrapper::hash_len(const key_type &key) {
+std::variant<size_t, HashError> DatabaseWrapper::hash_len(key_view_type key) {
 	return m_database.hash_len(m_trn_id, key);
 }
 
 std::variant<size_t, HashError>
-DatabaseWrapper::hash_key_len(const key_type &key, const string_t &hash_key) {
+DatabaseWrapper::hash_key_len(key_view_type key, std::string_view hash_key) {
 	return m_database.hash_key_len(m_trn_id, key, hash_key);
 }
 
@@ -243,11 +243,11 @@ DatabaseWrapper::hash_remove(const key_type &key, const std::vector<string_t> &h
 	return m_database.hash_remove(m_trn_id, key, hash_keys);
 }
 
-std::variant<std::vector<string_t>, HashError> DatabaseWrapper::hash_keys(const key_type &key) {
+std::variant<std::vector<string_t>, HashError> DatabaseWrapper::hash_keys(key_view_type key) {
 	return m_database.hash_keys(m_trn_id, key);
 }
 
-std::variant<std::vector<string_t>, HashError> DatabaseWrapper::hash_values(const key_type &key) {
+std::variant<std::vector<string_t>, HashError> DatabaseWrapper::hash_values(key_view_type key) {
 	return m_database.hash_values(m_trn_id, key);
 }
 
@@ -256,7 +256,7 @@ std::variant<size_t, HashError> DatabaseWrapper::hash_update(const key_type &key
 }
 
 std::variant<std::vector<std::optional<string_t>>, HashError>
-DatabaseWrapper::hash_many_get(const key_type &key, const std::vector<string_t> &hash_keys) {
+DatabaseWrapper::hash_many_get(key_view_type key, const std::vector<string_t> &hash_keys) {
 	return m_database.hash_many_get(m_trn_id, key, hash_keys);
 }
 
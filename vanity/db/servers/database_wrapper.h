@@ -23,6 +23,7 @@ private:
 	trn_id_t m_trn_id;
 
 	using key_type = db_key_type;
+	using key_view_type = db_key_view_type;
 	using data_type = db_data_type;
 
 public:
@@ -33,16 +34,16 @@ public:
 	void reset();
 
 	// check if the key exists
-	bool has(const key_type& key);
+	bool has(key_view_type key);
 
 	// delete the value for a key
 	bool del(const key_type& key);
 
 	// get the value for a key
-	std::optional<data_type> get(const key_type& key);
+	std::optional<data_type> get(key_view_type key);
 
 	// get the type of key as an index
-	std::optional<int> type(const key_type& key);
+	std::optional<int> type(key_view_type key);
 
 	// get all keys in this database
 	std::vector<key_type> keys();
@@ -78,7 +79,7 @@ public:
 
 	// get the expiry time for a key
 	// returns std::nullopt if the key has no expiry time
-	std::optional<time_t> get_expiry(const key_type &key);
+	std::optional<time_t> get_expiry(key_view_type key);
 
 	// clear all expiry times
 	void clear_all_expiry();
@@ -104,7 +105,7 @@ public:
 	// get the length of a string key
 	// returns the length, or std::nullopt
 	// if the value does not exist or is not a string
-	std::optional<int_t> str_len(const key_type &key);
+	std::optional<int_t> str_len(key_view_type key);
 
 	// get the value for many keys
 	std::vector<std::optional<data_type>> many_get(const std::vector<key_type>& keys);
@@ -113,12 +114,12 @@ public:
 	// get the length of a list key
 	// returns the length, 0 if value does not exist or is empty,
 	// or ListErrorKind::NotList if the value exists and is not a list
-	std::variant<size_t, ListErrorKind> list_len(const key_type &key);
+	std::variant<size_t, ListErrorKind> list_len(key_view_type key);
 
 	// get the value for a list key at a given index
 	// returns the value, or ListErrorKind::NotList if the value is not a list
 	// or ListErrorKind::OutOfRange if the index is out of range or if value does not exist
-	std::variant<std::string, ListErrorKind> list_get(const key_type &key, int64_t index);
+	std::variant<std::string, ListErrorKind> list_get(key_view_type key, int64_t index);
 
 	// set the value for a list key at a given index
 	// returns the old value if the value was set, or ListErrorKind::NotList if the value is not a list
@@ -148,7 +149,7 @@ public:
 	// get the value for a range of a list key inclusively
 	// returns the values, or ListErrorKind::NotList if the value is not a list
 	// returns an empty list if the range is out of bounds or invalid
-	std::variant<list_t, ListErrorKind> list_range(const key_type &key, int64_t start, int64_t end);
+	std::variant<list_t, ListErrorKind> list_range(key_view_type key, int64_t start, int64_t end);
 
 	// trim the list stored at key, so that it will
 	// contain only the specified range of elements (inclusively)
@@ -172,7 +173,7 @@ public:
 	// get all elements from a set key
 	// returns the elements,
 	// or std::nullopt if the value is not a set
-	std::optional<set_t> set_all(const key_type &key);
+	std::optional<set_t> set_all(key_view_type key);
 
 	// randomly remove elements from a set key
 	// returns the elements removed,
@@ -187,12 +188,12 @@ public:
 	// get the length of a set key
 	// returns the length, 0 if value does not exist or is empty,
 	// or std::nullopt if the value exists and is not a set
-	std::optional<size_t> set_len(const key_type &key);
+	std::optional<size_t> set_len(key_view_type key);
 
 	// check if a set key contains a value
 	// returns true if the value exists,
 	// or std::nullopt if the value is not a set
-	std::optional<bool> set_contains(const key_type &key, const std::string& value);
+	std::optional<bool> set_contains(key_view_type key, const std::string& value);
 
 	// atomically move an element from one set to another
 	// return false if no operation was performed, true if it was
@@ -252,30 +253,30 @@ public:
 	// get all elements from a hash key
 	// returns the elements,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<hash_t, HashError> hash_all(const key_type &key);
+	std::variant<hash_t, HashError> hash_all(key_view_type key);
 
 	// get the value of a hash key
 	// returns the value,
 	// or HashError::NotHash if the value is not a hash
 	// or HashError::BadKey if key does not exist
 	// or hash_key does not exist in the hash
-	std::variant<string_t, HashError> hash_get(const key_type &key, const string_t& hash_key);
+	std::variant<string_t, HashError> hash_get(key_view_type key, std::string_view hash_key);
 
 	// check if a hash key contains a value
 	// returns true if the value exists,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<bool, HashError> hash_contains(const key_type &key, const string_t& hash_key);
+	std::variant<bool, HashError> hash_contains(key_view_type key, std::string_view hash_key);
 
 	// get the length of a hash
 	// returns the length, 0 if value does not exist or is empty,
 	// or HashError::NotHash if the value exists and is not a hash
-	std::variant<size_t, HashError> hash_len(const key_type &key);
+	std::variant<size_t, HashError> hash_len(key_view_type key);
 
 	// get the length of a hash key
 	// returns the length, 0 if value does not exist or is empty,
 	// or HashError::NotHash if the value exists and is not a hash
 	// or HashError::BadKey if the hash_key does not exist in the hash
-	std::variant<size_t, HashError> hash_key_len(const key_type &key, const string_t& hash_key);
+	std::variant<size_t, HashError> hash_key_len(key_view_type key, std::string_view hash_key);
 
 	// remove elements from a hash key
 	// return the number of elements removed,
@@ -285,12 +286,12 @@ public:
 	// get all keys from a hash key
 	// returns the keys,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<std::vector<string_t>, HashError> hash_keys(const key_type &key);
+	std::variant<std::vector<string_t>, HashError> hash_keys(key_view_type key);
 
 	// get all values from a hash key
 	// returns the values,
 	// or HashError::NotHash if the value is not a hash
-	std::variant<std::vector<string_t>, HashError> hash_values(const key_type &key);
+	std::variant<std::vector<string_t>, HashError> hash_values(key_view_type key);
 
 	// update the contents of a hash
 	// returns the number of elements added,
@@ -301,7 +302,7 @@ public:
 	// returns the values,
 	// or HashError::NotHash if the value is not a hash
 	std::variant<std::vector<std::optional<string_t>>, HashError>
-	hash_many_get(const key_type &key, const std::vector<string_t>& hash_keys);
+	hash_many_get(key_view_type key, const std::vector<string_t>& hash_keys);
 };
 
 } // namespace vanity::db
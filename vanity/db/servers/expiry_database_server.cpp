@@ -3,6 +3,7 @@
 //
 
 #include "expiry_database_server.h"
+#include "utils/cached_clock.h"
 
 namespace vanity {
 
@@ -11,7 +12,7 @@ ExpiryDatabaseServer::ExpiryDatabaseServer() {
 }
 
 void ExpiryDatabaseServer::event_expire() {
-	deep_purge_databases();
+	purge_expired_databases();
 }
 
 void ExpiryDatabaseServer::request_set_expiry(Client &client, const std::string &key, double seconds) {
@@ -19,7 +20,7 @@ void ExpiryDatabaseServer::request_set_expiry(Client &client, const std::string
 	send(client, ok());
 }
 
-void ExpiryDatabaseServer::request_get_expiry(Client &client, const std::string &key) {
+void ExpiryDatabaseServer::request_get_expiry(Client &client, std::string_view key) {
 	if (auto expiry_time = database(client).get_expiry(key))
 		send(client, ok(time_point_to_seconds(*expiry_time)));
 	else
@@ -33,12 +34,12 @@ void ExpiryDatabaseServer::request_clear_expiry(Client &client, const std::strin
 
 auto ExpiryDatabaseServer::seconds_to_time_point(double seconds) -> time_point {
 	using namespace std::chrono;
-	return system_clock::now() + duration_cast<system_clock::duration>(duration<double>(seconds));
+	return CachedClock::now() + duration_cast<system_clock::duration>(duration<double>(seconds));
 }
 
 double ExpiryDatabaseServer::time_point_to_seconds(time_point tp) {
 	using namespace std::chrono;
-	return duration_cast<duration<double>>(tp - system_clock::now()).count();
+	return duration_cast<duration<double>>(tp - CachedClock::now()).count();
 }
 
 } // namespace vanity
\ No newline at end of file
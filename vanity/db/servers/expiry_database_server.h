@@ -20,7 +20,8 @@ private:
 	using time_point = std::chrono::time_point<std::chrono::system_clock>;
 
 	// time between automatic emitted server_events in microseconds
-	static constexpr long M_EXPIRE_INTERVAL = 10 * 1000 * 1000;
+	// each only visits the keys that are due, so this can be short
+	static constexpr long M_EXPIRE_INTERVAL = 100 * 1000;
 
 	// convert a double in seconds to a time_point
 	static time_point seconds_to_time_point(double seconds);
@@ -39,7 +40,7 @@ public:
 	void request_set_expiry(Client& client, const std::string& key, double seconds) override;
 
 	// a get_expiry request was received from a client
-	void request_get_expiry(Client& client, const std::string& key) override;
+	void request_get_expiry(Client& client, std::string_view key) override;
 
 	// a clear_expiry request was received from a client
 	void request_clear_expiry(Client& client, const std::string& key) override;
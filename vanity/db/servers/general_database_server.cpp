@@ -14,7 +14,7 @@ void GeneralDatabaseServer::request_switch_db(Client &client, int64_t db) {
 	send(client, ok());
 }
 
-void GeneralDatabaseServer::request_get(Client &client, const std::string &key) {
+void GeneralDatabaseServer::request_get(Client &client, std::string_view key) {
 	auto value = database(client).get(key);
 	if (not value.has_value())
 		return send(client, null());
@@ -45,7 +45,7 @@ void GeneralDatabaseServer::request_del(Client &client, const std::string &key)
 		send(client, null());
 }
 
-void GeneralDatabaseServer::request_type(Client &client, const std::string &key) {
+void GeneralDatabaseServer::request_type(Client &client, std::string_view key) {
 	auto type = database(client).type(key);
 	if (not type.has_value())
 		return send(client, null());
@@ -74,7 +74,7 @@ void GeneralDatabaseServer::request_reset(Client &client) {
 	send(client, ok());
 }
 
-void GeneralDatabaseServer::request_exists(Client &client, const std::string &key) {
+void GeneralDatabaseServer::request_exists(Client &client, std::string_view key) {
 	if (database(client).has(key))
 		send(client, ok());
 	else
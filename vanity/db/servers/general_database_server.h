@@ -19,16 +19,16 @@ public:
 	void request_switch_db(Client& client, int64_t db) override;
 
 	// a get request was received from a client
-	void request_get(Client& client, const std::string& key) override;
+	void request_get(Client& client, std::string_view key) override;
 
 	// a del request was received from a client
 	void request_del(Client& client, const std::string& key) override;
 
 	// a type request was received from a client
-	void request_type(Client& client, const std::string& key) override;
+	void request_type(Client& client, std::string_view key) override;
 
 	// an exists request was received from a client
-	void request_exists(Client& client, const std::string& key) override;
+	void request_exists(Client& client, std::string_view key) override;
 
 	// a reset request was received from a client
 	void request_reset(Client& client) override;
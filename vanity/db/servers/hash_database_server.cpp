@@ -7,28 +7,28 @@
 namespace vanity {
 
 
-void HashDatabaseServer::request_hash_set(Client &client, const std::string &key, std::unordered_map<std::string, std::string> values) {
+void HashDatabaseServer::request_hash_set(Client &client, const std::string &key, db::hash_t values) {
 	database(client).hash_set(key, std::move(values));
 	send(client, ok());
 }
 
-void HashDatabaseServer::request_hash_all(Client &client, const std::string &key) {
+void HashDatabaseServer::request_hash_all(Client &client, std::string_view key) {
 	handle_result(client, database(client).hash_all(key));
 }
 
-void HashDatabaseServer::request_hash_get(Client &client, const std::string &key, const std::string &hash_key) {
+void HashDatabaseServer::request_hash_get(Client &client, std::string_view key, std::string_view hash_key) {
 	handle_result(client, database(client).hash_get(key, hash_key));
 }
 
-void HashDatabaseServer::request_hash_contains(Client &client, const std::string &key, const std::string &hash_key) {
+void HashDatabaseServer::request_hash_contains(Client &client, std::string_view key, std::string_view hash_key) {
 	handle_result(client, database(client).hash_contains(key, hash_key));
 }
 
-void HashDatabaseServer::request_hash_len(Client &client, const std::string &key) {
+void HashDatabaseServer::request_hash_len(Client &client, std::string_view key) {
 	handle_result(client, database(client).hash_len(key));
 }
 
-void HashDatabaseServer::request_hash_key_len(Client &client, const std::string &key, const std::string &hash_key) {
+void HashDatabaseServer::request_hash_key_len(Client &client, std::string_view key, std::string_view hash_key) {
 	handle_result(client, database(client).hash_key_len(key, hash_key));
 }
 
@@ -36,19 +36,19 @@ void HashDatabaseServer::request_hash_remove(Client &client, const std::string &
 	handle_result(client, database(client).hash_remove(key, hash_keys));
 }
 
-void HashDatabaseServer::request_hash_keys(Client &client, const std::string &key) {
+void HashDatabaseServer::request_hash_keys(Client &client, std::string_view key) {
 	handle_result(client, database(client).hash_keys(key));
 }
 
-void HashDatabaseServer::request_hash_values(Client &client, const std::string &key) {
+void HashDatabaseServer::request_hash_values(Client &client, std::string_view key) {
 	handle_result(client, database(client).hash_values(key));
 }
 
-void HashDatabaseServer::request_hash_update(Client &client, const std::string &key, std::unordered_map<std::string, std::string> values) {
+void HashDatabaseServer::request_hash_update(Client &client, const std::string &key, db::hash_t values) {
 	handle_result(client, database(client).hash_update(key, std::move(values)));
 }
 
-void HashDatabaseServer::request_hash_many_get(Client &client, const std::string &key, const std::vector<std::string> &hash_keys) {
+void HashDatabaseServer::request_hash_many_get(Client &client, std::string_view key, const std::vector<std::string> &hash_keys) {
 	handle_result(client, database(client).hash_many_get(key, hash_keys));
 }
 
@@ -16,37 +16,37 @@ class HashDatabaseServer : public virtual BaseDatabaseServer
 {
 public:
 	// a hash_set request was received from a client
-	void request_hash_set(Client& client, const std::string& key, std::unordered_map<std::string, std::string> values) override;
+	void request_hash_set(Client& client, const std::string& key, db::hash_t values) override;
 
 	// a hash_all request was received from a client
-	void request_hash_all(Client& client, const std::string& key) override;
+	void request_hash_all(Client& client, std::string_view key) override;
 
 	// a hash_get request was received from a client
-	void request_hash_get(Client& client, const std::string& key, const std::string& hash_key) override;
+	void request_hash_get(Client& client, std::string_view key, std::string_view hash_key) override;
 
 	// a hash_contains request was received from a client
-	void request_hash_contains(Client& client, const std::string& key, const std::string& hash_key) override;
+	void request_hash_contains(Client& client, std::string_view key, std::string_view hash_key) override;
 
 	// a hash_len request was received from a client
-	void request_hash_len(Client& client, const std::string& key) override;
+	void request_hash_len(Client& client, std::string_view key) override;
 
 	// a hash_key_len request was received from a client
-	void request_hash_key_len(Client& client, const std::string& key, const std::string& hash_key) override;
+	void request_hash_key_len(Client& client, std::string_view key, std::string_view hash_key) override;
 
 	// a hash_remove request was received from a client
 	void request_hash_remove(Client& client, const std::string& key, const std::vector<std::string>& hash_keys) override;
 
 	// a hash_keys request was received from a client
-	void request_hash_keys(Client& client, const std::string& key) override;
+	void request_hash_keys(Client& client, std::string_view key) override;
 
 	// a hash_values request was received from a client
-	void request_hash_values(Client& client, const std::string& key) override;
+	void request_hash_values(Client& client, std::string_view key) override;
 
 	// a hash_update request was received from a client
-	void request_hash_update(Client& client, const std::string& key, std::unordered_map<std::string, std::string> values) override;
+	void request_hash_update(Client& client, const std::string& key, db::hash_t values) override;
 
 	// a hash_many_get request was received from a client
-	void request_hash_many_get(Client& client, const std::string& key, const std::vector<std::string>& hash_keys) override;
+	void request_hash_many_get(Client& client, std::string_view key, const std::vector<std::string>& hash_keys) override;
 
 private:
 	// handle a variant result returned by a hash request
@@ -6,11 +6,11 @@
 
 namespace vanity {
 
-void ListDatabaseServer::request_list_len(Client &client, const std::string &key) {
+void ListDatabaseServer::request_list_len(Client &client, std::string_view key) {
 	handle_result(client, database(client).list_len(key));
 }
 
-void ListDatabaseServer::request_list_get(Client &client, const std::string &key, int64_t index) {
+void ListDatabaseServer::request_list_get(Client &client, std::string_view key, int64_t index) {
 	handle_result(client, database(client).list_get(key, index));
 }
 
@@ -18,11 +18,11 @@ void ListDatabaseServer::request_list_set(Client &client, const std::string &key
 	handle_result(client, database(client).list_set(key, index, std::move(value)));
 }
 
-void ListDatabaseServer::request_list_push_left(Client &client, const std::string &key, std::list<std::string> values) {
+void ListDatabaseServer::request_list_push_left(Client &client, const std::string &key, db::list_t values) {
 	handle_result(client, database(client).list_push_left(key, std::move(values)));
 }
 
-void ListDatabaseServer::request_list_push_right(Client &client, const std::string &key, std::list<std::string> values) {
+void ListDatabaseServer::request_list_push_right(Client &client, const std::string &key, db::list_t values) {
 	handle_result(client, database(client).list_push_right(key, std::move(values)));
 }
 
@@ -34,7 +34,7 @@ void ListDatabaseServer::request_list_pop_right(Client &client, const std::strin
 	handle_result(client, database(client).list_pop_right(key, count));
 }
 
-void ListDatabaseServer::request_list_range(Client &client, const std::string &key, int64_t start, int64_t stop) {
+void ListDatabaseServer::request_list_range(Client &client, std::string_view key, int64_t start, int64_t stop) {
 	handle_result(client, database(client).list_range(key, start, stop));
 }
 
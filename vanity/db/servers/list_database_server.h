@@ -17,19 +17,19 @@ class ListDatabaseServer : public virtual BaseDatabaseServer
 {
 public:
 	// a list_len request was received from a client
-	void request_list_len(Client& client, const std::string& key) override;
+	void request_list_len(Client& client, std::string_view key) override;
 
 	// a list_get request was received from a client
-	void request_list_get(Client& client, const std::string& key, int64_t index) override;
+	void request_list_get(Client& client, std::string_view key, int64_t index) override;
 
 	// a list_set request was received from a client
 	void request_list_set(Client& client, const std::string& key, int64_t index, std::string value) override;
 
 	// a list_push_left request was received from a client
-	void request_list_push_left(Client& client, const std::string& key, std::list<std::string> values) override;
+	void request_list_push_left(Client& client, const std::string& key, db::list_t values) override;
 
 	// a list_push_right request was received from a client
-	void request_list_push_right(Client& client, const std::string& key, std::list<std::string> values) override;
+	void request_list_push_right(Client& client, const std::string& key, db::list_t values) override;
 
 	// a list_pop_left request was received from a client
 	void request_list_pop_left(Client& client, const std::string& key, int64_t count) override;
@@ -38,7 +38,7 @@ public:
 	void request_list_pop_right(Client& client, const std::string& key, int64_t count) override;
 
 	// a list_range request was received from a client
-	void request_list_range(Client& client, const std::string& key, int64_t start, int64_t stop) override;
+	void request_list_range(Client& client, std::string_view key, int64_t start, int64_t stop) override;
 
 	// a list_trim request was received from a client
 	void request_list_trim(Client& client, const std::string& key, int64_t start, int64_t stop) override;
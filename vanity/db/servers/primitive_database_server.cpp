@@ -39,7 +39,7 @@ void PrimitiveDatabaseServer::request_incr_float(Client &client, const std::stri
 		send(client, bad_type("not a float"));
 }
 
-void PrimitiveDatabaseServer::request_str_len(Client &client, const std::string &key) {
+void PrimitiveDatabaseServer::request_str_len(Client &client, std::string_view key) {
 	auto result = database(client).str_len(key);
 
 	if (result.has_value())
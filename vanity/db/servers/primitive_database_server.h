@@ -32,7 +32,7 @@ public:
 	void request_incr_float(Client& client, const std::string& key, db::float_t value) override;
 
 	// a str_len request was received from a client
-	void request_str_len(Client& client, const std::string& key) override;
+	void request_str_len(Client& client, std::string_view key) override;
 
 	// a many_get request was received from a client
 	void request_many_get(Client& client, const std::vector<std::string>& keys) override;
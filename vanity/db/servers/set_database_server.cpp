@@ -8,10 +8,10 @@
 namespace vanity {
 
 void SetDatabaseServer::request_set_add(Client &client, const std::string &key, std::unordered_set<std::string> values) {
-	handle_result(client, database(client).set_add(key, std::move(values)));
+	handle_result(client, database(client).set_add(key, {values.begin(), values.end()}));
 }
 
-void SetDatabaseServer::request_set_all(Client &client, const std::string &key) {
+void SetDatabaseServer::request_set_all(Client &client, std::string_view key) {
 	handle_result(client, database(client).set_all(key));
 }
 
@@ -20,14 +20,14 @@ void SetDatabaseServer::request_set_remove(Client &client, const std::string &ke
 }
 
 void SetDatabaseServer::request_set_discard(Client &client, const std::string &key, std::unordered_set<std::string> values) {
-	handle_result(client, database(client).set_discard(key, values));
+	handle_result(client, database(client).set_discard(key, {values.begin(), values.end()}));
 }
 
-void SetDatabaseServer::request_set_len(Client &client, const std::string &key) {
+void SetDatabaseServer::request_set_len(Client &client, std::string_view key) {
 	handle_result(client, database(client).set_len(key));
 }
 
-void SetDatabaseServer::request_set_contains(Client &client, const std::string &key, const std::string &value) {
+void SetDatabaseServer::request_set_contains(Client &client, std::string_view key, const std::string &value) {
 	handle_result(client, database(client).set_contains(key, value));
 }
 
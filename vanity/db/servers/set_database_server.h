@@ -19,7 +19,7 @@ public:
 	void request_set_add(Client& client, const std::string& key, std::unordered_set<std::string> values) override;
 
 	// a set_all request was received from a client
-	void request_set_all(Client& client, const std::string& key) override;
+	void request_set_all(Client& client, std::string_view key) override;
 
 	// a set_remove request was received from a client
 	void request_set_remove(Client& client, const std::string& key, int64_t count) override;
@@ -28,10 +28,10 @@ public:
 	void request_set_discard(Client& client, const std::string& key, std::unordered_set<std::string> values) override;
 
 	// a set_len request was received from a client
-	void request_set_len(Client& client, const std::string& key) override;
+	void request_set_len(Client& client, std::string_view key) override;
 
 	// a set_contains request was received from a client
-	void request_set_contains(Client& client, const std::string& key, const std::string& value) override;
+	void request_set_contains(Client& client, std::string_view key, const std::string& value) override;
 
 	// a set_move request was received from a client
 	void request_set_move(Client& client, const std::string& source, const std::string& dest, const std::string& value) override;
@@ -0,0 +1,24 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_FSYNC_POLICY_T_H
+#define VANITY_FSYNC_POLICY_T_H
+
+namespace vanity::wal {
+
+// when the WAL is synced to disk
+enum class fsync_policy_t : char {
+	// after every group of entries written
+	always,
+
+	// at most once every second
+	everysec,
+
+	// whenever the OS decides to
+	os,
+};
+
+} // namespace vanity::wal
+
+#endif //VANITY_FSYNC_POLICY_T_H
@@ -2,8 +2,14 @@
 // Created by kingsli on 2/18/24.
 //
 
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
 #include "journalist.h"
 #include "persist_journal_server.h"
+#include "utils/crc32c.h"
+#include "utils/mapped_file.h"
 
 
 namespace vanity::wal {
@@ -13,29 +19,80 @@ namespace vanity::wal {
 std::filesystem::path with_name_prefix(const std::filesystem::path& file, const char* prefix);
 
 
-void PersistJournalServer::do_persist(const path &file) {
-	std::ofstream out{file, std::ios::binary};
+void PersistJournalServer::do_persist(const path &file, wal_epoch_t epoch) {
+	std::ofstream file_out{file, std::ios::binary};
+	serializer::BufferWriter out{file_out};
+	out.write(db::M_SNAPSHOT_MAGIC.data(), db::M_SNAPSHOT_MAGIC.size());
+	serializer::write(out, db::M_SNAPSHOT_VERSION);
+	serializer::write(out, epoch);
+
+	std::array<db::shard_extents, M_NUM_DATABASES> index;
+	for (size_t i = 0; i < M_NUM_DATABASES; ++i)
+		index[i] = m_databases[i].persist(out);
+
+	uint64_t index_offset = out.position();
+	serializer::write(out, M_NUM_DATABASES);
+	for (auto& extents : index) {
+		serializer::write(out, extents.size());
+		for (auto& [offset, size] : extents) {
+			serializer::write(out, offset);
+			serializer::write(out, size);
+		}
+	}
+	serializer::write(out, index_offset);
+}
+
+void PersistJournalServer::begin_snapshots() {
 	for (auto& db : m_databases)
-		db.persist(out);
+		db.begin_snapshot();
+}
+
+void PersistJournalServer::wait_loaded() {
+	if (m_loader.joinable())
+		m_loader.join();
 }
 
 auto PersistJournalServer::lock_all() {
+	wait_loaded();
 	return [this]<size_t... I>(std::index_sequence<I...>) {
-		return std::scoped_lock {database_obj(I).mutex()... };
+		return std::array<db::LockedDatabase::ShardLock, M_NUM_DATABASES> {database_obj(I).lock_all()... };
 	}(std::make_index_sequence<M_NUM_DATABASES>{});
 }
 
-void PersistJournalServer::persist_with_wal() {
-	WriteAheadLogger::Closed closed {wal_logger(), *m_wal_file};
-	auto lock {lock_all()};
+void PersistJournalServer::journal_persist(wal_epoch_t epoch) {
 	Journalist journalist {*m_journal_file, *m_db_file, *m_wal_file};
-	do_persist(journalist.tmp_db_file());
+	do_persist(journalist.tmp_db_file(), epoch);
 	journalist.switch_and_journal();
+	m_db_epoch = epoch;
+}
+
+void PersistJournalServer::persist_with_wal() {
+	auto epoch = wal_logger().epoch();
+	{
+		// the WAL cut: the snapshots hold exactly the records
+		// of this epoch, later ones go to the next WAL file
+		auto lock {lock_all()};
+		wal_logger().switch_wal(*m_next_wal_file, epoch + 1);
+		begin_snapshots();
+	}
+
+	// the old WAL file is removed once the snapshots are persisted,
+	// so it has to be durable by then, but not under the locks
+	wal_logger().sync_retired();
+	journal_persist(epoch);
+
+	// the WAL keeps writing to the same file under its new name
+	rename(*m_next_wal_file, *m_wal_file);
 }
 
 void PersistJournalServer::persist_without_wal() {
 	auto tmp = with_name_prefix(*m_db_file, "tmp.");
-	do_persist(tmp);
+	{
+		auto lock {lock_all()};
+		begin_snapshots();
+	}
+
+	do_persist(tmp, m_db_epoch);
 	rename(tmp, *m_db_file);
 }
 
@@ -43,9 +100,54 @@ void PersistJournalServer::load_databases() {
 	if (not m_db_file or not exists(*m_db_file))
 		return;
 
-	std::ifstream in{*m_db_file, std::ios::binary};
+	auto file = std::make_shared<const MappedFile>(*m_db_file);
+	auto data = file->data();
+	if (not data.empty() and not std::string_view{data.data(), data.size()}.starts_with(db::M_SNAPSHOT_MAGIC))
+		return load_unversioned_databases(data);
+
+	if (data.size() < db::M_SNAPSHOT_HEADER_SIZE + sizeof(uint64_t))
+		throw std::runtime_error("Database file is truncated");
+
+	serializer::SpanReader header {data.first(db::M_SNAPSHOT_HEADER_SIZE)};
+	if (header.read_view(db::M_SNAPSHOT_MAGIC.size()) != db::M_SNAPSHOT_MAGIC)
+		throw std::runtime_error("Database file is corrupted: bad magic");
+
+	auto version = serializer::read<uint8_t>(header);
+	if (version != db::M_SNAPSHOT_VERSION)
+		throw std::runtime_error("Unsupported database file version: " + std::to_string(version));
+	m_db_epoch = serializer::read<wal_epoch_t>(header);
+
+	uint64_t index_offset;
+	std::memcpy(&index_offset, data.data() + data.size() - sizeof(index_offset), sizeof(index_offset));
+	if (index_offset > data.size() - sizeof(index_offset))
+		throw std::runtime_error("Database file is corrupted: bad index offset");
+
+	serializer::SpanReader index {data.subspan(index_offset)};
+	auto num_databases = serializer::read<size_t>(index);
+	if (num_databases != M_NUM_DATABASES)
+		throw std::runtime_error("Database file has " + std::to_string(num_databases) + " databases");
+
+	std::vector<db::shard_extent> extents;
+	for (auto& db : m_databases) {
+		extents.resize(serializer::read<size_t>(index));
+		for (auto& [offset, size] : extents) {
+			offset = serializer::read<uint64_t>(index);
+			size = serializer::read<uint64_t>(index);
+		}
+		db.load_from(file, extents);
+	}
+}
+
+void PersistJournalServer::load_unversioned_databases(std::span<const char> data) {
+	serializer::SpanReader in {data};
 	for (auto& db : m_databases)
-		db = db::Database::from(in);
+		db.load_unversioned(in);
+
+	if (in.remaining() > 0)
+		throw std::runtime_error("Database file is corrupted: trailing data");
+
+	// every WAL record left is newer than the database file
+	m_db_epoch = 0;
 }
 
 void PersistJournalServer::pre_database_load() {
@@ -97,44 +199,183 @@ void PersistJournalServer::pre_database_load() {
 	}
 }
 
-void PersistJournalServer::do_recover()
-{
+std::optional<std::string_view> PersistJournalServer::read_record(serializer::SpanReader &wal) {
+	wal_record_header header {};
+	if (wal.remaining() < sizeof(header))
+		return std::nullopt;
+
+	wal.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (wal.remaining() < header.length)
+		return std::nullopt;
+
+	auto payload = wal.read_view(header.length);
+	if (crc32c::crc32c(payload.data(), payload.size()) != header.crc)
+		return std::nullopt;
+
+	return payload;
+}
+
+void PersistJournalServer::redo_entry(serializer::ReadHandle<serializer::SpanReader> &reader) {
 	auto get_db = [this](uint db) -> auto& { return database_obj(db); };
-	auto eof = std::ifstream::traits_type::eof();
-	std::ifstream wal{*m_wal_file};
 
-	serializer::ReadHandle reader {wal};
-	while (wal.peek() != eof)
+	auto [entry_t, db] = reader.read<wal_entry_t, uint>();
+	switch (entry_t) {
+		case wal_entry_t::db_op:
+		{
+			auto [trn_id, op] = reader.read<trn_id_t, db::db_op_t>();
+			database_obj(db).wal_redo_db_op(trn_id, op, reader, get_db);
+			break;
+		}
+		case wal_entry_t::expire:
+		{
+			auto key = reader.read<std::string>();
+			database_obj(db).wal_redo_expiry(key);
+			break;
+		}
+		default:
+		{
+			throw WALError("Bad wal_entry_t");
+		}
+	}
+}
+
+void PersistJournalServer::redo_record(std::string_view payload) {
+	serializer::SpanReader in {payload};
+	serializer::ReadHandle reader {in};
+	redo_entry(reader);
+}
+
+std::pair<uint, bool> PersistJournalServer::record_target(std::string_view payload) {
+	serializer::SpanReader in {payload};
+	serializer::ReadHandle reader {in};
+
+	auto [entry_t, db] = reader.read<wal_entry_t, uint>();
+	if (db >= M_NUM_DATABASES)
+		throw WALError("Bad database index: " + std::to_string(db));
+
+	if (entry_t != wal_entry_t::db_op)
+		return {db, false};
+
+	auto [trn_id, op] = reader.read<trn_id_t, db::db_op_t>();
+	return {db, op == db::db_op_t::copy_to_db or op == db::db_op_t::move_to_db};
+}
+
+void PersistJournalServer::redo_batch(redo_batch_t &batch, size_t size, WorkerPool &pool) {
+	std::vector<WorkerPool::task_t> tasks;
+	for (auto& records : batch) {
+		if (records.empty())
+			continue;
+
+		tasks.emplace_back([this, &records] {
+			for (auto& record : records)
+				redo_record(record);
+		});
+	}
+
+	if (size < M_MIN_PARALLEL_REDO_SIZE or tasks.size() < 2) {
+		for (auto& task : tasks)
+			task();
+	}
+	else {
+		pool.run(tasks);
+	}
+
+	for (auto& records : batch)
+		records.clear();
+}
+
+std::optional<wal_epoch_t> PersistJournalServer::read_header(serializer::SpanReader &wal) {
+	if (wal.remaining() < M_WAL_HEADER_SIZE)
+		return std::nullopt;
+
+	if (wal.read_view(M_WAL_MAGIC.size()) != M_WAL_MAGIC)
+		throw WALError("WAL file is corrupted: bad magic");
+
+	auto version = serializer::read<uint8_t>(wal);
+	if (version != M_WAL_VERSION)
+		throw WALError("Unsupported WAL version: " + std::to_string(version));
+
+	return serializer::read<wal_epoch_t>(wal);
+}
+
+size_t PersistJournalServer::do_recover(serializer::SpanReader &wal, WorkerPool &pool)
+{
+	size_t valid = wal.position();
+	redo_batch_t batch;
+	size_t batch_size = 0;
+	while (auto payload = read_record(wal))
 	{
-		auto [entry_t, db] = reader.read<wal_entry_t, uint>();
-		switch (entry_t) {
-			case wal_entry_t::db_op:
-			{
-				auto [trn_id, op] = reader.read<trn_id_t, db::db_op_t>();
-				database_obj(db).wal_redo_db_op(trn_id, op, reader, get_db);
-				break;
+		valid = wal.position();
+		auto [db, crosses_db] = record_target(*payload);
+		if (crosses_db) {
+			// a barrier: everything before it must be redone first
+			redo_batch(batch, batch_size, pool);
+			batch_size = 0;
+			redo_record(*payload);
+			continue;
+		}
+
+		batch_size += payload->size();
+		batch[db].push_back(*payload);
+		if (batch_size >= M_MAX_REDO_BATCH_SIZE) {
+			redo_batch(batch, batch_size, pool);
+			batch_size = 0;
+		}
+	}
+
+	redo_batch(batch, batch_size, pool);
+	return valid;
+}
+
+bool PersistJournalServer::is_unversioned(std::span<const char> wal) {
+	std::string_view data {wal.data(), wal.size()};
+	return not data.empty() and not data.starts_with(M_WAL_MAGIC.substr(0, data.size()));
+}
+
+void PersistJournalServer::do_recover_unversioned(std::span<const char> wal, const path &file, wal_epoch_t epoch) {
+	auto tmp = with_name_prefix(file, "tmp.");
+	{
+		std::ofstream file_out{tmp, std::ios::binary};
+		serializer::BufferWriter out{file_out};
+		out.write(M_WAL_MAGIC.data(), M_WAL_MAGIC.size());
+		serializer::write(out, M_WAL_VERSION);
+		serializer::write(out, epoch);
+
+		// an entry is the payload of a record, so it is framed as is
+		serializer::SpanReader in {wal};
+		serializer::ReadHandle reader {in};
+		while (in.remaining() > 0) {
+			auto start = in.position();
+			try {
+				redo_entry(reader);
 			}
-			case wal_entry_t::expire:
-			{
-				auto key = reader.read<std::string>();
-				database_obj(db).wal_redo_expiry(key);
+			catch (const std::out_of_range&) {
+				// torn: its arguments are read before it is redone
 				break;
 			}
-			default:
-			{
-				throw WALError("Bad wal_entry_t");
-			}
-		}
 
-		if (wal.get() != '\n')
-			throw WALError("WAL file is corrupted: no newline after entry");
+			// the newline may be torn after a whole entry
+			auto payload = wal.subspan(start, in.position() - start);
+			if (in.remaining() > 0 and in.read_view(1) != "\n")
+				throw WALError("WAL file is corrupted: no newline after entry");
+
+			wal_record_header header {
+				static_cast<uint32_t>(payload.size()),
+				crc32c::crc32c(payload.data(), payload.size()),
+			};
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(payload.data(), payload.size());
+		}
 	}
+
+	rename(tmp, file);
 }
 
-PersistJournalServer::PersistJournalServer(optional_path wal_file, optional_path db_file, optional_path journal_file):
+PersistJournalServer::PersistJournalServer(optional_path wal_file, optional_path db_file, optional_path journal_file, fsync_policy_t fsync_policy):
 	m_wal_file{std::move(wal_file)},
 	m_db_file{std::move(db_file)},
-	m_journal_file{std::move(journal_file)}
+	m_journal_file{std::move(journal_file)},
+	m_next_wal_file{m_wal_file ? optional_path{with_name_prefix(*m_wal_file, "next.")} : std::nullopt}
 {
 	if (m_wal_file and m_db_file and not m_journal_file)
 		throw std::invalid_argument("Journal file must be provided if WAL and DB files are provided");
@@ -142,11 +383,11 @@ PersistJournalServer::PersistJournalServer(optional_path wal_file, optional_path
 	pre_database_load();
 	load_databases();
 
-	if (m_wal_file)
-		wal_logger().wal_to(*m_wal_file);
+	wal_logger().fsync_policy(fsync_policy);
 }
 
 void PersistJournalServer::persist_no_check() {
+	std::lock_guard lock{m_persist_mutex};
 	deep_purge_databases();
 
 	if (m_wal_file and m_db_file)
@@ -155,22 +396,92 @@ void PersistJournalServer::persist_no_check() {
 		persist_without_wal();
 }
 
-void PersistJournalServer::recover() {
-	if (not m_wal_file)
-		return;
+void PersistJournalServer::recover_wal() {
+	// the WAL files with records not in the database file, oldest first
+	std::vector<path> live;
+	wal_epoch_t epoch = m_db_epoch + 1;
+	bool redone = false;
 
-	auto &file = *m_wal_file;
-	if (not exists(file))
-		return;
+	// started for the first WAL file with records, and shared by both
+	std::optional<WorkerPool> pool;
 
-	enable_databases_expiry(false);
-	{
-		WriteAheadLogger::Closed closed {wal_logger(), file};
-		do_recover();
+	for (auto& file : {*m_wal_file, *m_next_wal_file}) {
+		if (not exists(file))
+			continue;
+
+		size_t valid;
+		std::optional<wal_epoch_t> file_epoch;
+		{
+			MappedFile mapped {file};
+			if (is_unversioned(mapped.data())) {
+				// written before epochs, so newer than the database file
+				if (not redone) {
+					enable_databases_expiry(false);
+					redone = true;
+				}
+
+				file_epoch = m_db_epoch + 1;
+				do_recover_unversioned(mapped.data(), file, *file_epoch);
+				live.push_back(file);
+				epoch = *file_epoch;
+				continue;
+			}
+
+			serializer::SpanReader wal {mapped.data()};
+			file_epoch = read_header(wal);
+			if (not file_epoch or *file_epoch <= m_db_epoch) {
+				remove(file);
+				continue;
+			}
+
+			// records load only the shards they touch as they are redone
+			if (not redone and wal.remaining() > 0) {
+				enable_databases_expiry(false);
+				redone = true;
+			}
+
+			if (not pool)
+				pool.emplace(std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), M_NUM_DATABASES) - 1);
+			valid = do_recover(wal, *pool);
+		}
+
+		// drop any torn or corrupted tail, so new records follow valid ones
+		if (valid < file_size(file))
+			resize_file(file, valid);
+
+		live.push_back(file);
+		epoch = *file_epoch;
 	}
 
-	enable_databases_expiry(true);
-	deep_purge_databases();
+	if (redone)
+		enable_databases_expiry(true);
+
+	if (live.size() > 1) {
+		// a persist did not finish: the databases now hold
+		// both WAL files, so persist them to start over from one
+		begin_snapshots();
+		journal_persist(epoch);
+		remove(*m_next_wal_file);
+		++epoch;
+	}
+	else if (live.size() == 1 and live.front() == *m_next_wal_file) {
+		rename(*m_next_wal_file, *m_wal_file);
+	}
+
+	wal_logger().wal_to(*m_wal_file, epoch);
+	if (redone)
+		deep_purge_databases();
+}
+
+void PersistJournalServer::recover() {
+	if (m_wal_file)
+		recover_wal();
+
+	// load the rest of the database file in the background
+	m_loader = std::jthread {[this](std::stop_token stop) {
+		for (auto& db : m_databases)
+			db.load_all(stop);
+	}};
 }
 
 } // namespace vanity::wal
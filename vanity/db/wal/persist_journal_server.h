@@ -5,7 +5,10 @@
 #ifndef VANITY_PERSIST_JOURNAL_SERVER_H
 #define VANITY_PERSIST_JOURNAL_SERVER_H
 
+#include <thread>
+
 #include "db/servers/database_object_server.h"
+#include "utils/worker_pool.h"
 
 namespace vanity {
 
@@ -13,6 +16,23 @@ namespace wal {
 
 /*
  * A PersistJournalServer journals a persist operation to provide crash recovery
+ *
+ * A persist does not stop the databases: it cuts the WAL by switching to
+ * a new WAL file (the next WAL file) and beginning a snapshot of every database,
+ * all under a brief lock, then writes the snapshot out while operations carry on.
+ * Once the database file is switched, the old WAL file is removed and the
+ * next WAL file takes its place. Each WAL file carries an epoch, and the database
+ * file records the last epoch it covers, so recovery only redoes WAL files
+ * whose records are not in the database file yet.
+ *
+ * Loading maps the database file and only reads its index, each shard
+ * is parsed on first use or by a background thread, so the server can
+ * take requests before a large database file has been read.
+ *
+ * Recovery redoes the records of each database in parallel on a pool of
+ * workers started once per recovery, since databases are independent,
+ * except for records that cross databases (copy_to_db and move_to_db),
+ * which are redone alone after all earlier records
  */
 class PersistJournalServer : public virtual DatabaseObjectServer
 {
@@ -21,6 +41,17 @@ private:
 
 	using optional_path = std::optional<path>;
 
+	// records to redo, by database
+	// views of the payloads in the mapped WAL file
+	using redo_batch_t = std::array<std::vector<std::string_view>, M_NUM_DATABASES>;
+
+	// the size at which a batch of records is redone during recovery
+	static constexpr size_t M_MAX_REDO_BATCH_SIZE = 64 * 1024 * 1024;
+
+	// the size below which a batch is redone on the recovering thread,
+	// as handing it to the workers would cost more than redoing it
+	static constexpr size_t M_MIN_PARALLEL_REDO_SIZE = 64 * 1024;
+
 protected:
 	// the WAL file, if any
 	const optional_path m_wal_file;
@@ -31,9 +62,29 @@ protected:
 	// the journal file, if any
 	const optional_path m_journal_file;
 
+	// the WAL file written to while a persist is in progress, if any
+	const optional_path m_next_wal_file;
+
 private:
-	// perform the persist operation into file
-	void do_persist(const path &file);
+	// the last WAL epoch covered by the database file
+	wal_epoch_t m_db_epoch = 0;
+
+	// mutex for persisting
+	std::mutex m_persist_mutex;
+
+	// loads the shards of the database file not loaded yet
+	std::jthread m_loader;
+
+	// perform the persist operation of the snapshots into file
+	void do_persist(const path &file, wal_epoch_t epoch);
+
+	// begin a snapshot of every database
+	// assumes all shards of all databases are already locked
+	void begin_snapshots();
+
+	// persist the snapshots into the database file, journaling the switch
+	// the database file then covers the WAL files up to epoch
+	void journal_persist(wal_epoch_t epoch);
 
 	// perform a persist operation with WAL enabled (journaling the operation)
 	// assumes the WAL file, the database file, and the journal file are all present
@@ -43,28 +94,76 @@ private:
 	void persist_without_wal();
 
 	// load the databases from the database file
+	// this only reads the index, the shards are loaded lazily
 	void load_databases();
 
+	// load the databases from a database file written before snapshots,
+	// which has no header and no index, so it is loaded all at once
+	void load_unversioned_databases(std::span<const char> data);
+
 	// recover from a possible crash using the journal
 	// this should be called before any of db_file, wal_file, or journal_file are accessed
 	// it ensures that the database file and the WAL are in a consistent state
 	void pre_database_load();
 
-	// return a lock on the wal mutex and all databases
+	// wait for the shards of the database file to finish loading
+	void wait_loaded();
+
+	// return a lock on all shards of all databases
+	// the databases are loaded first, so no shard is parsed while others are locked
 	auto lock_all();
 
-	// perform recovery from the wal_file
-	void do_recover();
+	// read the next record from the WAL
+	// returns a view of its payload, or std::nullopt
+	// if there is no complete, valid record left
+	static std::optional<std::string_view> read_record(serializer::SpanReader& wal);
+
+	// redo the next entry from a reader
+	void redo_entry(serializer::ReadHandle<serializer::SpanReader>& reader);
+
+	// redo the entry in a record's payload
+	void redo_record(std::string_view payload);
+
+	// get the database a record's payload belongs to,
+	// and whether it also touches another database
+	static std::pair<uint, bool> record_target(std::string_view payload);
+
+	// redo a batch of records of a total size, each database's records
+	// as one task on the pool, or all of them here if the batch is small
+	// empties the batch
+	void redo_batch(redo_batch_t& batch, size_t size, WorkerPool& pool);
+
+	// read the header of a WAL file
+	// returns the epoch of the file, or std::nullopt if the header is torn
+	static std::optional<wal_epoch_t> read_header(serializer::SpanReader& wal);
+
+	// perform recovery from the records of a WAL file, after its header
+	// stops at the first torn or corrupted record
+	// returns the size of the valid prefix of the file
+	size_t do_recover(serializer::SpanReader& wal, WorkerPool& pool);
+
+	// whether a WAL file was written before WAL files had a header,
+	// as entries each followed by a newline, with no framing
+	static bool is_unversioned(std::span<const char> wal);
+
+	// perform recovery from an unversioned WAL file, then rewrite
+	// its entries into file as records, with a header of epoch
+	// stops at the first torn entry
+	void do_recover_unversioned(std::span<const char> wal, const path& file, wal_epoch_t epoch);
+
+	// recover previous state from the WAL files, then open the WAL
+	void recover_wal();
 
 public:
 	// create a PersistJournalServer
-	PersistJournalServer(optional_path wal_file, optional_path db_file, optional_path journal_file);
+	PersistJournalServer(optional_path wal_file, optional_path db_file, optional_path journal_file, fsync_policy_t fsync_policy);
 
 	// persist the databases
 	// assumes the database file is present
 	void persist_no_check();
 
-	// recover previous state from the WAL file
+	// recover previous state from the WAL files, then load
+	// the rest of the database file in the background
 	void recover();
 };
 
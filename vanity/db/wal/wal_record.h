@@ -0,0 +1,53 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_WAL_RECORD_H
+#define VANITY_WAL_RECORD_H
+
+#include <cstdint>
+#include <string_view>
+
+
+namespace vanity::wal {
+
+/*
+ * The WAL file format
+ *
+ * A WAL file starts with a header of M_WAL_MAGIC, the format version and the
+ * epoch of the file. Each persist starts a new WAL file with the next epoch, and
+ * the database file records the last epoch it covers, so a WAL file whose
+ * records are already in the database file is never redone.
+ * The header is followed by records, each framed by a wal_record_header holding the
+ * length of the record's payload and the CRC32C of the payload, so a torn or
+ * corrupted record can be detected without parsing it.
+ *
+ * A WAL file that does not start with M_WAL_MAGIC was written before WAL files
+ * had a header: each entry is a record's payload followed by a newline. It is
+ * still redone, then rewritten in this format.
+ */
+
+// the magic bytes at the start of a WAL file
+static constexpr std::string_view M_WAL_MAGIC = "VWAL";
+
+// the version of the WAL format
+static constexpr uint8_t M_WAL_VERSION = 2;
+
+// the epoch of a WAL file
+using wal_epoch_t = uint64_t;
+
+// the size of the WAL file header
+static constexpr size_t M_WAL_HEADER_SIZE = M_WAL_MAGIC.size() + sizeof(M_WAL_VERSION) + sizeof(wal_epoch_t);
+
+// the header framing each record
+struct wal_record_header {
+	// the length of the payload
+	uint32_t length;
+
+	// the CRC32C of the payload
+	uint32_t crc;
+};
+
+} // namespace vanity::wal
+
+#endif //VANITY_WAL_RECORD_H
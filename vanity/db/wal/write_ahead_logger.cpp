@@ -2,25 +2,302 @@
 // Created by kingsli on 8/7/24.
 //
 
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "exceptions.h"
+#include "utils/crc32c.h"
 #include "write_ahead_logger.h"
 
 namespace vanity::wal {
 
-void WriteAheadLogger::wal_to(const std::filesystem::path &wal_file) {
+WriteAheadLogger::WriteAheadLogger() {
+	new_group();
+	m_writer = std::thread{&WriteAheadLogger::run_writer, this};
+}
+
+WriteAheadLogger::~WriteAheadLogger() {
+	{
+		std::lock_guard lock(m_wal_mutex);
+		m_stopping = true;
+		m_pending_cv.notify_one();
+	}
+
+	m_writer.join();
+	close_wal();
+	try {
+		sync_retired();
+	}
+	catch (const WALError&) {
+		// nothing to report it to
+	}
+}
+
+auto WriteAheadLogger::ready_future() -> durability_future {
+	static const durability_future ready = [] {
+		std::promise<void> promise;
+		promise.set_value();
+		return promise.get_future().share();
+	}();
+	return ready;
+}
+
+auto WriteAheadLogger::failed_future(std::exception_ptr error) -> durability_future {
+	std::promise<void> promise;
+	promise.set_exception(std::move(error));
+	return promise.get_future().share();
+}
+
+serializer::BufferWriter &WriteAheadLogger::entry_buffer() {
+	thread_local serializer::BufferWriter buffer;
+	wal_record_header placeholder {};
+	buffer.clear();
+	buffer.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+	return buffer;
+}
+
+std::string_view WriteAheadLogger::seal_entry(serializer::BufferWriter &entry) {
+	auto record = entry.data();
+	auto payload = record.subspan(sizeof(wal_record_header));
+
+	wal_record_header header {
+		static_cast<uint32_t>(payload.size()),
+		crc32c::crc32c(payload.data(), payload.size()),
+	};
+
+	std::memcpy(record.data(), &header, sizeof(header));
+	return entry.view();
+}
+
+auto WriteAheadLogger::append(std::string_view entry) -> durability_future {
 	std::lock_guard lock(m_wal_mutex);
-	if (m_wal_file.is_open())
-		m_wal_file.close();
-	m_wal_file.open(wal_file, std::ios::out | std::ios::app);
+	if (m_wal_fd < 0)
+		return ready_future();
+	if (m_error)
+		return failed_future(m_error);
+
+	m_buffer.append(entry);
+	m_pending = true;
+	m_pending_cv.notify_one();
+	return m_group_future;
 }
 
-void WriteAheadLogger::close_wal() {
+void WriteAheadLogger::new_group() {
+	m_group_promise = std::promise<void>{};
+	m_group_future = m_group_promise.get_future().share();
+}
+
+std::pair<std::string, std::promise<void>> WriteAheadLogger::take_group() {
+	auto data = std::exchange(m_buffer, {});
+	m_pending = false;
+
+	auto promise = std::move(m_group_promise);
+	new_group();
+	return {std::move(data), std::move(promise)};
+}
+
+void WriteAheadLogger::write_all(int fd, std::string_view data) {
+	size_t written = 0;
+	while (written < data.size()) {
+		auto n = ::write(fd, data.data() + written, data.size() - written);
+		if (n < 0 and errno == EINTR)
+			continue;
+		if (n < 0)
+			throw WALError("Could not write to WAL file: " + std::to_string(errno));
+		written += n;
+	}
+}
+
+std::exception_ptr WriteAheadLogger::write_group(int fd, std::pair<std::string, std::promise<void>> group, bool sync, std::exception_ptr error) {
+	auto& [data, promise] = group;
+	try {
+		if (error)
+			std::rethrow_exception(error);
+
+		write_all(fd, data);
+		if (sync and ::fdatasync(fd) < 0)
+			throw WALError("Could not sync WAL file: " + std::to_string(errno));
+
+		promise.set_value();
+		return nullptr;
+	}
+	catch (const WALError&) {
+		// a partly written group would cut off recovery before every later one
+		promise.set_exception(std::current_exception());
+		return std::current_exception();
+	}
+}
+
+void WriteAheadLogger::flush(std::unique_lock<std::mutex> &lock) {
+	m_idle_cv.wait(lock, [this] {
+		return not m_writing;
+	});
+
+	if (m_pending)
+		m_error = write_group(m_wal_fd, take_group(), m_fsync_policy == fsync_policy_t::always, m_error);
+}
+
+void WriteAheadLogger::wait_sync(std::unique_lock<std::mutex> &lock) {
+	m_idle_cv.wait(lock, [this] {
+		return not m_syncing;
+	});
+}
+
+void WriteAheadLogger::run_writer() {
+	std::unique_lock lock(m_wal_mutex);
+	while (true) {
+		m_pending_cv.wait_for(lock, M_SYNC_INTERVAL, [this] {
+			return m_pending or m_stopping;
+		});
+
+		if (m_pending) {
+			auto fd = m_wal_fd;
+			auto sync = m_fsync_policy == fsync_policy_t::always;
+			auto group = take_group();
+			auto error = m_error;
+
+			// while m_writing is set, fd cannot be closed, see flush()
+			m_writing = true;
+			lock.unlock();
+			error = write_group(fd, std::move(group), sync, std::move(error));
+			lock.lock();
+			m_error = std::move(error);
+			m_writing = false;
+			m_idle_cv.notify_all();
+
+			m_unsynced = not sync;
+			if (sync)
+				m_last_sync = std::chrono::steady_clock::now();
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (m_unsynced and m_fsync_policy == fsync_policy_t::everysec and now - m_last_sync >= M_SYNC_INTERVAL) {
+			auto fd = m_wal_fd;
+
+			// appenders hold shard locks, so do not keep them waiting on the sync
+			// while m_syncing is set, fd cannot be closed, see wait_sync()
+			m_syncing = true;
+			lock.unlock();
+			auto synced = fd < 0 or ::fdatasync(fd) == 0;
+			auto sync_errno = errno;
+			lock.lock();
+			m_syncing = false;
+			m_idle_cv.notify_all();
+
+			if (not synced and not m_error)
+				m_error = std::make_exception_ptr(WALError("Could not sync WAL file: " + std::to_string(sync_errno)));
+			m_unsynced = false;
+			m_last_sync = now;
+		}
+
+		if (m_stopping and not m_pending)
+			break;
+	}
+}
+
+void WriteAheadLogger::wal_to(const std::filesystem::path &wal_file, wal_epoch_t epoch) {
+	close_wal();
+
 	std::lock_guard lock(m_wal_mutex);
-	if (m_wal_file.is_open())
-		m_wal_file.close();
+	open_wal(wal_file, epoch);
+}
+
+void WriteAheadLogger::switch_wal(const std::filesystem::path &wal_file, wal_epoch_t epoch) {
+	std::unique_lock lock(m_wal_mutex);
+	if (m_wal_fd < 0)
+		return open_wal(wal_file, epoch);
+
+	// the group writes are cheap, only the sync is left for sync_retired()
+	flush(lock);
+	if (m_retired_fd >= 0) {
+		// a previous switch was never synced, so this one waits for it
+		wait_sync(lock);
+		::fdatasync(m_retired_fd);
+		::close(m_retired_fd);
+	}
+
+	m_retired_fd = std::exchange(m_wal_fd, -1);
+	open_wal(wal_file, epoch);
+}
+
+void WriteAheadLogger::sync_retired() {
+	std::unique_lock lock(m_wal_mutex);
+	wait_sync(lock);
+	auto fd = std::exchange(m_retired_fd, -1);
+	auto sync = m_fsync_policy != fsync_policy_t::os;
+	lock.unlock();
+
+	if (fd < 0)
+		return;
+
+	auto synced = not sync or ::fdatasync(fd) == 0;
+	auto sync_errno = errno;
+	::close(fd);
+	if (not synced)
+		throw WALError("Could not sync WAL file: " + std::to_string(sync_errno));
+}
+
+void WriteAheadLogger::open_wal(const std::filesystem::path &wal_file, wal_epoch_t epoch) {
+	m_wal_fd = ::open(wal_file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (m_wal_fd < 0)
+		throw WALError("Could not open WAL file: " + wal_file.string());
+
+	m_epoch = epoch;
+	m_error = nullptr;
+	write_file_header();
+	m_unsynced = false;
+	m_last_sync = std::chrono::steady_clock::now();
+	m_open = true;
+}
+
+void WriteAheadLogger::write_file_header() {
+	struct stat st {};
+	if (::fstat(m_wal_fd, &st) < 0)
+		throw WALError("Could not stat WAL file: " + std::to_string(errno));
+
+	if (st.st_size != 0)
+		return;
+
+	std::string header {M_WAL_MAGIC};
+	header.push_back(static_cast<char>(M_WAL_VERSION));
+	header.append(reinterpret_cast<const char*>(&m_epoch), sizeof(m_epoch));
+	write_all(m_wal_fd, header);
+}
+
+wal_epoch_t WriteAheadLogger::epoch() {
+	std::lock_guard lock(m_wal_mutex);
+	return m_epoch;
+}
+
+void WriteAheadLogger::close_wal() {
+	std::unique_lock lock(m_wal_mutex);
+	if (m_wal_fd < 0)
+		return;
+
+	m_open = false;
+	flush(lock);
+	wait_sync(lock);
+	if (m_fsync_policy != fsync_policy_t::os)
+		::fdatasync(m_wal_fd);
+
+	::close(m_wal_fd);
+	m_wal_fd = -1;
+	m_unsynced = false;
+}
+
+void WriteAheadLogger::fsync_policy(fsync_policy_t policy) {
+	m_fsync_policy = policy;
+}
+
+fsync_policy_t WriteAheadLogger::fsync_policy() {
+	return m_fsync_policy;
 }
 
-void WriteAheadLogger::wal_expiry(const std::string &key, uint db) {
-	wal(wal_entry_t::expire, db, key);
+auto WriteAheadLogger::wal_expiry(std::string_view key, uint db) -> durability_future {
+	return wal(wal_entry_t::expire, db, key);
 }
 
 } // namespace vanity::wal
@@ -5,23 +5,42 @@
 #ifndef VANITY_WRITE_AHEAD_LOGGER_H
 #define VANITY_WRITE_AHEAD_LOGGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <filesystem>
-#include <fstream>
+#include <future>
 #include <mutex>
+#include <thread>
 
 #include "db/db/db_operations.h"
 #include "db/trn_constants.h"
+#include "fsync_policy_t.h"
 #include "utils/serializer.h"
 #include "wal_entry_t.h"
+#include "wal_record.h"
 
 
 namespace vanity::wal {
 
 /*
  * A WriteAheadLogger logs the operations performed on a database
+ *
+ * Entries are appended to an in-memory buffer, and a dedicated writer
+ * thread writes out everything appended since its last write in one go
+ * (a commit group), syncing the file according to the fsync policy.
+ * Every entry gets a future that is ready once its commit group has been
+ * written to the OS, and synced to disk if the policy is fsync_policy_t::always.
+ * Once a write or sync fails, nothing more is written to the file, and the
+ * futures of that group and every later entry hold the WALError, until
+ * the WAL is moved to another file.
  */
 class WriteAheadLogger
 {
+public:
+	// a future that is ready when an entry is durable
+	using durability_future = std::shared_future<void>;
+
 private:
 	template<std::size_t n, typename T, typename... Tp>
 	struct is_nth_type;
@@ -46,78 +65,198 @@ private:
 	static constexpr void validate_types(const Args &...) {
 		constexpr bool is_wal_entry_0 = is_nth_type_v<0, wal_entry_t, Args...>;
 		constexpr bool is_uint_1 = is_nth_type_v<1, uint, Args...>;
-		constexpr bool is_string_2 = is_nth_type_v<2, std::string, Args...>;
+		constexpr bool is_string_2 = is_nth_type_v<2, std::string, Args...> or is_nth_type_v<2, std::string_view, Args...>;
 		constexpr bool is_trn_id_2 = is_nth_type_v<2, trn_id_t, Args...>;
 		constexpr bool is_db_op_3 = is_nth_type_v<3, db::db_op_t, Args...>;
 
 		static_assert(is_wal_entry_0, "First argument must be of type wal_entry_t");
 		static_assert(is_uint_1, "Second argument must be of type uint");
 		static_assert((is_string_2) or (is_trn_id_2 and is_db_op_3),
-			"Third argument must be of type std::string or trn_id_t and fourth argument must be of type db::db_op_t"
+			"Third argument must be of type std::string(_view) or trn_id_t and fourth argument must be of type db::db_op_t"
 		);
 	}
 
-	// the WAL file
-	std::ofstream m_wal_file;
+	// how long to wait between syncs with fsync_policy_t::everysec
+	static constexpr auto M_SYNC_INTERVAL = std::chrono::seconds(1);
+
+	// the WAL file descriptor, or -1 if the WAL is closed
+	int m_wal_fd = -1;
+
+	// the file the WAL was switched away from, or -1 if there is none
+	// written out, but not synced until sync_retired()
+	int m_retired_fd = -1;
+
+	// whether the WAL is open, readable without the lock
+	// so entries are not serialized when there is no WAL to append them to
+	std::atomic<bool> m_open = false;
+
+	// the epoch of the WAL file
+	wal_epoch_t m_epoch = 0;
+
+	// entries appended but not yet taken by the writer
+	std::string m_buffer;
+
+	// whether m_buffer holds any entries
+	bool m_pending = false;
+
+	// whether the writer is currently writing a commit group
+	bool m_writing = false;
+
+	// whether the writer is currently syncing a file
+	bool m_syncing = false;
+
+	// whether the writer thread should exit
+	bool m_stopping = false;
+
+	// whether the file has writes that have not been synced
+	bool m_unsynced = false;
+
+	// the error a write or sync failed with, nothing is written once it is set
+	std::exception_ptr m_error;
+
+	// when the file was last synced
+	std::chrono::steady_clock::time_point m_last_sync;
+
+	// the fsync policy
+	std::atomic<fsync_policy_t> m_fsync_policy = fsync_policy_t::everysec;
+
+	// the promise for the commit group being buffered
+	std::promise<void> m_group_promise;
+
+	// the future for the commit group being buffered
+	durability_future m_group_future;
 
 	// mutex for the WAL
 	std::mutex m_wal_mutex;
 
+	// notified when entries are appended or the writer should exit
+	std::condition_variable m_pending_cv;
+
+	// notified when the writer finishes a commit group
+	std::condition_variable m_idle_cv;
+
+	// the writer thread
+	std::thread m_writer;
+
 
 	// write an entry to the wal
+	// the entry is serialized before the lock is taken,
+	// only appending it to the buffer happens under the lock
 	template<typename ...Args>
-	void wal(const Args &... args) {
+	durability_future wal(const Args &... args) {
 		validate_types(args...);
+		if (not m_open.load(std::memory_order_relaxed))
+			return ready_future();
 
-		std::lock_guard lock(m_wal_mutex);
-		if (not m_wal_file.is_open())
-			return;
-
-		serializer::WriteHandle writer{m_wal_file};
+		auto& entry = entry_buffer();
+		serializer::WriteHandle writer{entry};
 		writer.write(args...);
-		std::endl(m_wal_file);
+
+		return append(seal_entry(entry));
 	}
 
+	// get this thread's buffer for serializing an entry
+	// emptied, except for space for the record header
+	static serializer::BufferWriter& entry_buffer();
+
+	// fill in the record header for the entry in the buffer
+	// returns the whole record
+	static std::string_view seal_entry(serializer::BufferWriter& entry);
+
+	// write the WAL file header if the file is empty
+	// assumes the lock is already acquired
+	void write_file_header();
+
+	// append a serialized entry to the buffer
+	durability_future append(std::string_view entry);
+
+	// a future that is already ready
+	static durability_future ready_future();
+
+	// a future that holds an error
+	static durability_future failed_future(std::exception_ptr error);
+
+	// start a new commit group
+	// assumes the lock is already acquired
+	void new_group();
+
+	// take the buffered entries and the promise of their commit group,
+	// starting a new commit group
+	// assumes the lock is already acquired
+	std::pair<std::string, std::promise<void>> take_group();
+
+	// write all of data to fd
+	static void write_all(int fd, std::string_view data);
+
+	// write a commit group to fd, syncing if sync is set,
+	// then fulfil its promise
+	// if error is set, the group is failed with it and not written
+	// returns the error the group failed with, if any
+	static std::exception_ptr write_group(int fd, std::pair<std::string, std::promise<void>> group, bool sync, std::exception_ptr error);
+
+	// write out the buffered entries from the calling thread
+	// waits for the writer thread to finish any group it is writing
+	// assumes the lock is held by lock
+	void flush(std::unique_lock<std::mutex>& lock);
+
+	// wait for the writer thread to finish any sync it is doing
+	// assumes the lock is held by lock
+	void wait_sync(std::unique_lock<std::mutex>& lock);
+
+	// open file for the WAL
+	// assumes the lock is already acquired and the WAL is closed
+	void open_wal(const std::filesystem::path &wal_file, wal_epoch_t epoch);
+
+	// the writer thread loop
+	void run_writer();
+
 	// close the WAL
 	void close_wal();
 
 public:
-	// use file for the WAL
-	void wal_to(const std::filesystem::path &wal_file);
+	// create a WriteAheadLogger and start its writer thread
+	WriteAheadLogger();
+
+	// no copy
+	WriteAheadLogger(const WriteAheadLogger&) = delete;
+	WriteAheadLogger& operator=(const WriteAheadLogger&) = delete;
+
+	// write out any remaining entries and stop the writer thread
+	~WriteAheadLogger();
+
+	// use file for the WAL, closing the current one
+	// the file header gets epoch if the file is new
+	void wal_to(const std::filesystem::path &wal_file, wal_epoch_t epoch);
+
+	// use file for the WAL, writing out the current one without syncing it
+	// the current file is retired, and stays open until sync_retired()
+	// the file header gets epoch if the file is new
+	void switch_wal(const std::filesystem::path &wal_file, wal_epoch_t epoch);
+
+	// sync and close the retired WAL file, if any
+	// throws a WALError if the sync fails
+	void sync_retired();
+
+	// get the epoch of the WAL file
+	wal_epoch_t epoch();
+
+	// set the fsync policy
+	void fsync_policy(fsync_policy_t policy);
+
+	// get the fsync policy
+	fsync_policy_t fsync_policy();
 
 	// log a db operation that's about to happen
+	// returns a future that is ready when the entry is durable
 	template<typename ...Args>
-	void wal_db_op(uint db, trn_id_t trn_id, db::db_op_t op, const Args &... args) {
-		wal(wal_entry_t::db_op, db, trn_id, op, args...);
+	durability_future wal_db_op(uint db, trn_id_t trn_id, db::db_op_t op, const Args &... args) {
+		return wal(wal_entry_t::db_op, db, trn_id, op, args...);
 	}
 
 	// log an expiry that's about to happen
-	void wal_expiry(const std::string &key, uint db);
-
-
-	/*
-	 * RAII mechanism to close and reopen a WriteAheadLogger
-	 */
-	class Closed {
-	private:
-		// the WriteAheadLogger
-		WriteAheadLogger &m_wal;
-
-		// the WAL file to reopen with
-		std::filesystem::path m_wal_file;
-
-	public:
-		// close the Logger
-		Closed(WriteAheadLogger &wal, std::filesystem::path wal_file)
-			: m_wal{wal}, m_wal_file{std::move(wal_file)} {
-			m_wal.close_wal();
-		}
-
-		// reopen the Logger
-		~Closed() {
-			m_wal.wal_to(m_wal_file);
-		}
-	};
+	// returns a future that is ready when the entry is durable
+	durability_future wal_expiry(std::string_view key, uint db);
+
 };
 
 }
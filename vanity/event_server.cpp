@@ -2,6 +2,9 @@
 // Created by kingsli on 12/24/23.
 //
 
+#include <array>
+#include <thread>
+
 #include "event_server.h"
 
 namespace vanity {
@@ -9,10 +12,6 @@ namespace vanity {
 void EventServer::event_loop()  {
 	while (true)
 		switch (m_event_queue.get()) {
-			case server_event::epoll_ready: {
-				event_epoll_ready();
-				break;
-			}
 			case server_event::persist: {
 				event_persist();
 				break;
@@ -21,10 +20,6 @@ void EventServer::event_loop()  {
 				event_expire();
 				break;
 			}
-			case server_event::publish: {
-				event_publish();
-				break;
-			}
 			case server_event::pulse: {
 				event_pulse();
 				break;
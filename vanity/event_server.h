@@ -6,7 +6,7 @@
 #define VANITY_EVENT_SERVER_H
 
 #include "abstract_server.h"
-#include "utils/queue.h"
+#include "utils/mpmc_queue.h"
 
 
 namespace vanity {
@@ -19,11 +19,9 @@ class EventServer : public virtual AbstractServer
 protected:
 	// some type of sever event that should be completed
 	enum class server_event{
-		epoll_ready,
 		persist,
 		terminate,
 		expire,
-		publish,
 		pulse,
 	};
 
@@ -32,7 +30,8 @@ private:
 	static constexpr int M_THREADS = 4;
 
 	// events that need attention are sent through here
-	Queue<server_event> m_event_queue;
+	// a push only blocks if the event threads fall a whole queue behind
+	MpmcQueue<server_event> m_event_queue;
 
 	// the event loop
 	void event_loop();
@@ -47,18 +46,12 @@ public:
 	// request to terminate the server
 	void terminate() override;
 
-	// an epoll_ready event was received
-	virtual void event_epoll_ready() = 0;
-
 	// a persist event was received
 	virtual void event_persist() = 0;
 
 	// an expire event was received
 	virtual void event_expire() = 0;
 
-	// a publish event was received
-	virtual void event_publish() = 0;
-
 	// a pulse event was received
 	virtual void event_pulse() = 0;
 };
@@ -6,24 +6,24 @@
 
 namespace vanity {
 
-void PollServer::event_epoll_ready() {
-	epoll_ready();
-	m_polled.set();
-}
-
 void PollServer::start() {
 	m_running = true;
-	m_poll_thread = std::thread{&PollServer::poll, this};
+	m_poll_threads.reserve(reactor_count());
+	for (size_t i = 0; i < reactor_count(); ++i)
+		m_poll_threads.emplace_back(&PollServer::poll, this, std::ref(reactor(i)));
 }
 
 void PollServer::stop() {
 	m_running = false;
-	m_poll_thread.join();
+	for (auto& thread : m_poll_threads)
+		thread.join();
+
+	m_poll_threads.clear();
 }
 
-void PollServer::poll() {
+void PollServer::poll(socket::Reactor& reactor) {
 	while (true) {
-		auto n = epoll_wait(M_MAX_TIMEOUT * 1000);
+		auto n = epoll_wait(reactor, M_MAX_TIMEOUT * 1000);
 
 		if (n == 0 and not m_running)
 			break;
@@ -31,9 +31,7 @@ void PollServer::poll() {
 		if (n <= 0)
 			continue;
 
-		push_event(server_event::epoll_ready);
-		m_polled.wait();
-		m_polled.clear();
+		epoll_ready(reactor);
 	}
 }
 
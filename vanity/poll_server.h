@@ -5,40 +5,37 @@
 #ifndef VANITY_POLL_SERVER_H
 #define VANITY_POLL_SERVER_H
 
-#include "event_server.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "abstract_server.h"
 #include "socket/epoll_server.h"
-#include "utils/event.h"
 
 
 namespace vanity {
 
 /*
  * A PollServer add liveness to the EpollServer
- * by waiting on the epoll on a separate thread
- * and pushing events to be handled by worker
- * threads when an event is ready
+ * by running one thread per Reactor, each thread
+ * waiting on its own Reactor and handling its
+ * ready events without going through the event queue
  */
 class PollServer:
-	public virtual EventServer,
+	public virtual AbstractServer,
 	public virtual socket::EpollServer
 {
 private:
-	// the poll thread
-	std::thread m_poll_thread {};
-
-	// whether the reported epoll_ready has been polled
-	Event m_polled {};
+	// the poll threads, one per reactor
+	std::vector<std::thread> m_poll_threads {};
 
-	// whether the polling thread is still running
-	bool m_running {false};
+	// whether the polling threads are still running
+	std::atomic<bool> m_running {false};
 
 public:
 	// destroy the poll server
 	~PollServer() override = default;
 
-	// an epoll_ready event was received
-	void event_epoll_ready() override;
-
 protected:
 	// start polling
 	void start();
@@ -47,10 +44,9 @@ protected:
 	void stop();
 
 private:
-	// block on epoll on a separate thread.
-	// yield server_event::epoll_ready to the
-	// event queue when some epoll is ready
-	void poll();
+	// block on the reactor's epoll and
+	// handle its events when some epoll is ready
+	void poll(socket::Reactor& reactor);
 };
 
 } // namespace vanity
@@ -2,6 +2,9 @@
 // Created by kingsli on 12/31/23.
 //
 
+#include <algorithm>
+#include <thread>
+
 #include "pubsub_server.h"
 
 namespace vanity {
@@ -34,36 +37,53 @@ void PubSubServer::request_unsubscribe(Client &client, const std::string &channe
 
 void PubSubServer::request_unsubscribe_all(Client &client) {
 	auto &channels = session_channels(client);
+	auto &patterns = session_patterns(client);
 	{
 		std::lock_guard lock(m_subscriptions_mutex);
 		for (auto& channel : channels)
 			erase_subscription(client, channel);
+		for (auto& pattern : patterns)
+			m_pattern_subscriptions.erase(pattern, &client);
 	}
 	channels.clear();
+	patterns.clear();
 	send(client, ok());
 }
 
-void PubSubServer::request_publish(Client &client, const std::string &channel, const std::string &message) {
+void PubSubServer::request_psubscribe(Client &client, const std::string &pattern) {
+	auto &patterns = session_patterns(client);
 	{
-		std::lock_guard lock(m_publish_queue_mutex);
-		m_publish_queue.emplace_back(channel, message);
+		std::lock_guard lock(m_subscriptions_mutex);
+		m_pattern_subscriptions.insert(pattern, &client);
 	}
-	push_event(server_event::publish);
-	send(client, ok());
+	patterns.insert(pattern);
+	send(client, ok(patterns.size()));
 }
 
-void PubSubServer::event_publish() {
-	std::vector<PublishData> publish_queue;
+void PubSubServer::request_psubscribed(Client &client) {
+	auto &patterns_set = session_patterns(client);
+	std::vector<std::string> pattern_arr{patterns_set.begin(), patterns_set.end()};
+	send(client, ok(pattern_arr));
+}
+
+void PubSubServer::request_punsubscribe(Client &client, const std::string &pattern) {
+	auto &patterns = session_patterns(client);
 	{
-		std::lock_guard lock(m_publish_queue_mutex);
-		if (m_publish_queue.empty())
-			return;
-		std::swap(publish_queue, m_publish_queue);
+		std::lock_guard lock(m_subscriptions_mutex);
+		m_pattern_subscriptions.erase(pattern, &client);
 	}
+	patterns.erase(pattern);
+	send(client, ok(patterns.size()));
+}
 
-	std::lock_guard lock(m_subscriptions_mutex);
-	for (auto& data : publish_queue)
-		publish(data);
+void PubSubServer::request_publish(Client &client, const std::string &channel, const std::string &message) {
+	// publish before replying, so the message reaches subscribers
+	// ahead of any later reply to them
+	{
+		std::shared_lock lock(m_subscriptions_mutex);
+		publish({channel, message});
+	}
+	send(client, ok());
 }
 
 void PubSubServer::erase_subscription(Client &client, const std::string &channel) {
@@ -91,13 +111,52 @@ Response& Response::serialize(const PubSubServer::PublishData& data) {
 		.serialize_string_body(data.message);
 }
 
+std::vector<Client*> PubSubServer::subscribers(const std::string &channel) {
+	std::vector<Client*> clients;
+	if (auto it = m_subscriptions.find(channel); it != m_subscriptions.end())
+		clients.assign(it->second.begin(), it->second.end());
+
+	if (m_pattern_subscriptions.empty())
+		return clients;
+
+	// a client gets each message once, however many of its subscriptions match
+	std::unordered_set<Client*> seen{clients.begin(), clients.end()};
+	m_pattern_subscriptions.match(channel, [&](Client* client) {
+		if (seen.insert(client).second)
+			clients.push_back(client);
+	});
+	return clients;
+}
+
 void PubSubServer::publish(const PublishData &data) {
-	if (not m_subscriptions.contains(data.channel))
+	auto clients = subscribers(data.channel);
+	if (clients.empty())
 		return;
 
-	auto response = async(data);
-	for (auto& client : m_subscriptions[data.channel])
-		send(*client, Response(response)); // copy response
+	// every subscriber queues the same buffer, instead of a copy of it
+	auto message = async(data).share();
+	auto size = clients.size();
+	auto first = clients.data();
+
+	// spread a large fan-out across the pool, taking the first part here
+	auto threads = m_fanout_pool.size() + 1;
+	auto part = std::max(M_FANOUT_SIZE, (size + threads - 1) / threads);
+	if (part >= size)
+		return fan_out(first, first + size, message);
+
+	std::vector<WorkerPool::task_t> parts;
+	for (size_t start = 0; start < size; start += part) {
+		auto stop = std::min(start + part, size);
+		parts.emplace_back([this, first, start, stop, &message] {
+			fan_out(first + start, first + stop, message);
+		});
+	}
+	m_fanout_pool.run(parts);
+}
+
+void PubSubServer::fan_out(Client* const* begin, Client* const* end, const Sendable::shared_data_t& message) {
+	for (auto it = begin; it != end; ++it)
+		send_shared(**it, message);
 }
 
 void PubSubServer::pre_client_delete_pubsub(TcpClient &client) {
@@ -107,6 +166,8 @@ void PubSubServer::pre_client_delete_pubsub(TcpClient &client) {
 	std::lock_guard lock {m_subscriptions_mutex};
 	for (auto& channel : session_channels(client))
 		erase_subscription(client, channel);
+	for (auto& pattern : session_patterns(client))
+		m_pattern_subscriptions.erase(pattern, &client);
 }
 
 } // namespace vanity
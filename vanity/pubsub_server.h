@@ -5,7 +5,10 @@
 #ifndef VANITY_PUBSUB_SERVER_H
 #define VANITY_PUBSUB_SERVER_H
 
+#include <algorithm>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -14,6 +17,8 @@
 #include "request/request_handler.h"
 #include "response/response_server.h"
 #include "session_server.h"
+#include "utils/pattern_trie.h"
+#include "utils/worker_pool.h"
 
 
 namespace vanity {
@@ -36,17 +41,21 @@ public:
 	};
 
 private:
+	// the most subscribers a single thread publishes a message to
+	static constexpr size_t M_FANOUT_SIZE = 512;
+
+	// the threads a large fan-out is spread across, besides the publishing one
+	WorkerPool m_fanout_pool {std::max(std::thread::hardware_concurrency(), 1u) - 1};
+
 	// a map of channels to clients subscribed to that channel
 	std::unordered_map<std::string, std::unordered_set<Client*>> m_subscriptions;
 
-	// mutex for m_subscriptions
-	std::mutex m_subscriptions_mutex;
-
-	// a queue of messages to be published
-	std::vector<PublishData> m_publish_queue;
+	// the clients subscribed to each channel pattern
+	PatternTrie<Client*> m_pattern_subscriptions;
 
-	// mutex for m_publish_queue
-	std::mutex m_publish_queue_mutex;
+	// mutex for m_subscriptions and m_pattern_subscriptions
+	// publishing only needs a shared lock, so channels are published to concurrently
+	std::shared_mutex m_subscriptions_mutex;
 
 public:
 	// a subscribe request was received from a client
@@ -61,12 +70,18 @@ public:
 	// an unsubscribe_all request was received from a client
 	void request_unsubscribe_all(Client& client) override;
 
+	// a psubscribe request was received from a client
+	void request_psubscribe(Client& client, const std::string& pattern) override;
+
+	// a psubscribed request was received from a client
+	void request_psubscribed(Client& client) override;
+
+	// a punsubscribe request was received from a client
+	void request_punsubscribe(Client& client, const std::string& pattern) override;
+
 	// a publish request was received from a client
 	void request_publish(Client& client, const std::string& channel, const std::string& message) override;
 
-	// a publish event was received
-	void event_publish() override;
-
 private:
 	// erase a client from a channel
 	// assumes m_subscriptions_mutex is locked
@@ -76,10 +91,17 @@ private:
 	// assumes m_subscriptions_mutex is locked
 	void insert_subscription(Client& client, const std::string& channel);
 
+	// the clients subscribed to a channel, directly or by a pattern
+	// assumes m_subscriptions_mutex is locked
+	std::vector<Client*> subscribers(const std::string& channel);
+
 	// publish a message to a channel
 	// assumes m_subscriptions_mutex is locked
 	void publish(const PublishData& data);
 
+	// send the same message to every subscriber in a range
+	void fan_out(Client* const* begin, Client* const* end, const Sendable::shared_data_t& message);
+
 	// the pubsub hook pre-deleting a client
 	// this removes the tcp_client from all channels
 	void pre_client_delete_pubsub(TcpClient& client) override;
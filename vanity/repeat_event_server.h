@@ -5,6 +5,9 @@
 #ifndef VANITY_REPEAT_EVENT_SERVER_H
 #define VANITY_REPEAT_EVENT_SERVER_H
 
+#include <queue>
+
+
 #include "event_server.h"
 #include "utils/event.h"
 
@@ -179,11 +179,15 @@ double Extractable::get_float() {
 }
 
 std::string Extractable::get_str() {
+	return std::string{get_str_view()};
+}
+
+std::string_view Extractable::get_str_view() {
 	size_t len = get_len();
 	if (not has_up_to(len))
 		throw InvalidRequest("string too short");
 
-	auto ret = m_msg.substr(m_pos, len);
+	std::string_view ret {m_msg.data() + m_pos, len};
 	*this += len;
 	return ret;
 }
@@ -201,11 +205,11 @@ std::vector<std::string> Extractable::get_arr() {
 	return arr;
 }
 
-std::list<std::string> Extractable::get_list() {
+db::list_t Extractable::get_list() {
 	size_t len = get_len();
 	expect('[', "list not opened with bracket");
 
-	std::list<std::string> list;
+	db::list_t list;
 	for (size_t i = 0; i < len; ++i)
 		list.emplace_back(get_str());
 
@@ -225,11 +229,11 @@ std::unordered_set<std::string> Extractable::get_set() {
 	return set;
 }
 
-std::unordered_map<std::string, std::string> Extractable::get_hash() {
+db::hash_t Extractable::get_hash() {
 	size_t len = get_len();
 	expect('{', "hash not opened with '{' bracket");
 
-	std::unordered_map<std::string, std::string> hash;
+	db::hash_t hash;
 	for (size_t i = 0; i < len; ++i) {
 		auto key = get_str();
 		auto value = get_str();
@@ -254,14 +258,15 @@ bool Extractable::get_bool() {
 	throw InvalidRequest("invalid boolean");
 }
 
-template<class T>
-T Extractable::peek_from_list(const Extractable::list_of_pairs<T> &list, const char *err) {
+template<class T, size_t Nodes>
+T Extractable::get_from_trie(const StringTrie<T, Nodes> &trie, const char *err) {
 	skip_whitespace();
-	for (const auto& [val, str]: list)
-		if (compare(str))
-			return val;
+	auto match = trie.match(std::string_view{m_msg}.substr(m_pos));
+	if (not match)
+		throw InvalidRequest(err);
 
-	throw InvalidRequest(err);
+	*this += match->second;
+	return match->first;
 }
 
 template<class T>
@@ -279,16 +284,14 @@ T Extractable::get_from_list(const list_of_pairs<T> &list, const char *err) {
 // explicit instantiations
 template object_t Extractable::get_from_list(const list_of_pairs<object_t>&, const char*);
 
-template operation_t Extractable::get_from_list(const list_of_pairs<operation_t>&, const char*);
-
 template peer_request_t Extractable::get_from_list(const list_of_pairs<peer_request_t>&, const char*);
 
 template ReplyStatus Extractable::get_from_list(const list_of_pairs<ReplyStatus>&, const char*);
 
-template peer_op_t Extractable::get_from_list(const list_of_pairs<peer_op_t>&, const char*);
+template operation_t Extractable::get_from_trie(decltype(OPERATION_T_TRIE)&, const char*);
 
-template async_op_t Extractable::get_from_list(const list_of_pairs<async_op_t>&, const char*);
+template peer_op_t Extractable::get_from_trie(decltype(PEER_OP_TRIE)&, const char*);
 
-template operation_t Extractable::peek_from_list(const list_of_pairs<operation_t>&, const char*);
+template async_op_t Extractable::get_from_trie(decltype(ASYNC_OP_TRIE)&, const char*);
 
 } // namespace vanity
@@ -6,6 +6,7 @@
 #define VANITY_EXTRACTABLE_H
 
 #include "object_t.h"
+#include "utils/string_trie.h"
 
 namespace vanity {
 
@@ -71,17 +72,21 @@ protected:
 	// extract a string from the extractable
 	std::string get_str();
 
+	// extract a string from the extractable, as a view into it
+	// the view is only valid as long as the extracted string
+	std::string_view get_str_view();
+
 	// extract an array from the extractable
 	std::vector<std::string> get_arr();
 
 	// extract a list from the extractable
-	std::list<std::string> get_list();
+	db::list_t get_list();
 
 	// extract a set from the extractable
 	std::unordered_set<std::string> get_set();
 
 	// extract a hash from the extractable
-	std::unordered_map<std::string, std::string> get_hash();
+	db::hash_t get_hash();
 
 	// extract a bool from the extractable
 	bool get_bool();
@@ -99,10 +104,12 @@ protected:
 	template<class T>
 	T get_from_list(const list_of_pairs<T>& list, const char* err);
 
-	// peek a value from a list of pairs
-	// same as get_from_list but doesn't advance the position
-	template<class T>
-	T peek_from_list(const list_of_pairs<T>& list, const char* err);
+	// extract a value from a trie
+	// by matching the longest string in the trie
+	// to the extractable and returning its value
+	// or throw an InvalidRequest with err
+	template<class T, size_t Nodes>
+	T get_from_trie(const StringTrie<T, Nodes>& trie, const char* err);
 
 public:
 	// extract a (len) from part of an extractable
@@ -133,6 +140,11 @@ public:
 	Extractable(Extractable&& other) = default;
 };
 
+template<>
+inline std::string_view Extractable::get<object_t::STR_VIEW>() {
+	return get_str_view();
+}
+
 template<>
 inline int64_t Extractable::get<object_t::INT>() {
 	return get_int();
@@ -154,7 +166,7 @@ inline std::vector<std::string> Extractable::get<object_t::ARR>() {
 }
 
 template<>
-inline std::list<std::string> Extractable::get<object_t::LIST>() {
+inline db::list_t Extractable::get<object_t::LIST>() {
 	return get_list();
 }
 
@@ -164,7 +176,7 @@ inline std::unordered_set<std::string> Extractable::get<object_t::SET>() {
 }
 
 template<>
-inline std::unordered_map<std::string, std::string> Extractable::get<object_t::HASH>() {
+inline db::hash_t Extractable::get<object_t::HASH>() {
 	return get_hash();
 }
 
@@ -5,14 +5,15 @@
 #ifndef VANITY_OBJECT_T_H
 #define VANITY_OBJECT_T_H
 
-#include <list>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "client/session_info.h"
+#include "db/db/types.h"
 
 
 namespace vanity {
@@ -28,6 +29,10 @@ enum class object_t{
 	HASH,
 	BOOL,
 	CLIENT_AUTH,
+
+	// a STR, extracted as a view into the request
+	// instead of a copy, for arguments that are only looked up
+	STR_VIEW,
 };
 
 const std::initializer_list<std::pair<object_t, std::string>> OBJECT_T_STRINGS {
@@ -50,6 +55,11 @@ struct concrete_traits<object_t::STR> {
 	using type = std::string;
 };
 
+template<>
+struct concrete_traits<object_t::STR_VIEW> {
+	using type = std::string_view;
+};
+
 template<>
 struct concrete_traits<object_t::INT> {
 	using type = int64_t;
@@ -67,7 +77,7 @@ struct concrete_traits<object_t::ARR> {
 
 template<>
 struct concrete_traits<object_t::LIST> {
-	using type = std::list<std::string>;
+	using type = db::list_t;
 };
 
 template<>
@@ -77,7 +87,7 @@ struct concrete_traits<object_t::SET> {
 
 template<>
 struct concrete_traits<object_t::HASH> {
-	using type = std::unordered_map<std::string, std::string>;
+	using type = db::hash_t;
 };
 
 template<>
@@ -17,11 +17,11 @@ ReplyStatus PeerRequest::get_reply_status() {
 }
 
 peer_op_t PeerRequest::get_op() {
-	return get_from_list(PEER_OP_STRINGS, "invalid peer operation");
+	return get_from_trie(PEER_OP_TRIE, "invalid peer operation");
 }
 
 async_op_t PeerRequest::get_async_op() {
-	return get_from_list(ASYNC_OP_STRINGS, "invalid async operation");
+	return get_from_trie(ASYNC_OP_TRIE, "invalid async operation");
 }
 
 std::string PeerRequest::format() const {
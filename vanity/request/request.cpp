@@ -29,11 +29,7 @@ std::string_view Request::view(size_t start, size_t end) const {
 }
 
 operation_t Request::get_operation() {
-	return get_from_list(OPERATION_T_STRINGS, "invalid operation");
-}
-
-operation_t Request::peek_operation() {
-	return peek_from_list(OPERATION_T_STRINGS, "invalid operation");
+	return get_from_trie(OPERATION_T_TRIE, "invalid operation");
 }
 
 object_t Request::get_object_t() {
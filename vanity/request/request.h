@@ -35,9 +35,6 @@ public:
 
 	// extract an operation type from the extractable
 	operation_t get_operation();
-
-	// like get_operation, but doesn't advance the position
-	operation_t peek_operation();
 };
 
 } // namespace vanity
@@ -6,10 +6,10 @@
 
 namespace vanity {
 
-void RequestHandler::dispatch(Client &client, Request& request, bool end) {
+void RequestHandler::dispatch(Client &client, Request& request, operation_t op, bool end) {
 	using enum object_t;
 
-	switch (request.get_operation()) {
+	switch (op) {
 		case operation_t::TERMINATE:
 		{
 			request.get_exact<>(true);
@@ -47,6 +47,12 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 			request_unbind(client, host, port);
 			break;
 		}
+		case operation_t::CLIENT_OUTPUT:
+		{
+			request.get_exact<>(end);
+			request_client_output(client);
+			break;
+		}
 
 		case operation_t::ADD_USER:
 		{
@@ -153,6 +159,24 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 			request_unsubscribe_all(client);
 			break;
 		}
+		case operation_t::PSUBSCRIBE:
+		{
+			auto pattern = request.get_exact<STR>(end);
+			request_psubscribe(client, pattern);
+			break;
+		}
+		case operation_t::PSUBSCRIBED:
+		{
+			request.get_exact<>(end);
+			request_psubscribed(client);
+			break;
+		}
+		case operation_t::PUNSUBSCRIBE:
+		{
+			auto pattern = request.get_exact<STR>(end);
+			request_punsubscribe(client, pattern);
+			break;
+		}
 
 		case operation_t::DEL:
 		{
@@ -162,13 +186,13 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::TYPE:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_type(client, key);
 			break;
 		}
 		case operation_t::EXISTS:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_exists(client, key);
 			break;
 		}
@@ -217,7 +241,7 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::GET_EXPIRY:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_get_expiry(client, key);
 			break;
 		}
@@ -230,7 +254,7 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 
 		case operation_t::GET:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_get(client, key);
 			break;
 		}
@@ -266,7 +290,7 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::STR_LEN:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_str_len(client, key);
 			break;
 		}
@@ -279,13 +303,13 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 
 		case operation_t::LIST_LEN:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_list_len(client, key);
 			break;
 		}
 		case operation_t::LIST_GET:
 		{
-			auto [key, index] = request.get_exact<STR, INT>(end);
+			auto [key, index] = request.get_exact<STR_VIEW, INT>(end);
 			request_list_get(client, key, index);
 			break;
 		}
@@ -321,7 +345,7 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::LIST_RANGE:
 		{
-			auto [key, start, stop] = request.get_exact<STR, INT, INT>(end);
+			auto [key, start, stop] = request.get_exact<STR_VIEW, INT, INT>(end);
 			request_list_range(client, key, start, stop);
 			break;
 		}
@@ -346,7 +370,7 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::SET_ALL:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_set_all(client, key);
 			break;
 		}
@@ -364,13 +388,13 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::SET_LEN:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_set_len(client, key);
 			break;
 		}
 		case operation_t::SET_CONTAINS:
 		{
-			auto [key, value] = request.get_exact<STR, STR>(end);
+			auto [key, value] = request.get_exact<STR_VIEW, STR>(end);
 			request_set_contains(client, key, value);
 			break;
 		}
@@ -443,31 +467,31 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::HASH_ALL:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_hash_all(client, key);
 			break;
 		}
 		case operation_t::HASH_GET:
 		{
-			auto [key, hash_key] = request.get_exact<STR, STR>(end);
+			auto [key, hash_key] = request.get_exact<STR_VIEW, STR_VIEW>(end);
 			request_hash_get(client, key, hash_key);
 			break;
 		}
 		case operation_t::HASH_CONTAINS:
 		{
-			auto [key, hash_key] = request.get_exact<STR, STR>(end);
+			auto [key, hash_key] = request.get_exact<STR_VIEW, STR_VIEW>(end);
 			request_hash_contains(client, key, hash_key);
 			break;
 		}
 		case operation_t::HASH_LEN:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_hash_len(client, key);
 			break;
 		}
 		case operation_t::HASH_KEY_LEN:
 		{
-			auto [key, hash_key] = request.get_exact<STR, STR>(end);
+			auto [key, hash_key] = request.get_exact<STR_VIEW, STR_VIEW>(end);
 			request_hash_key_len(client, key, hash_key);
 			break;
 		}
@@ -479,13 +503,13 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::HASH_KEYS:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_hash_keys(client, key);
 			break;
 		}
 		case operation_t::HASH_VALUES:
 		{
-			auto key = request.get_exact<STR>(end);
+			auto key = request.get_exact<STR_VIEW>(end);
 			request_hash_values(client, key);
 			break;
 		}
@@ -497,7 +521,7 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 		}
 		case operation_t::HASH_MANY_GET:
 		{
-			auto [key, hash_keys] = request.get_exact<STR, ARR>(end);
+			auto [key, hash_keys] = request.get_exact<STR_VIEW, ARR>(end);
 			request_hash_many_get(client, key, hash_keys);
 			break;
 		}
@@ -554,10 +578,10 @@ void RequestHandler::dispatch(Client &client, Request& request, bool end) {
 	}
 }
 
-void RequestHandler::dry_dispatch(Request& request, bool end) {
+void RequestHandler::dry_dispatch(Request& request, operation_t op, bool end) {
 	using enum object_t;
 
-	switch (request.get_operation()) {
+	switch (op) {
 		case operation_t::TERMINATE:
 		{
 			request.get_exact<>(true);
@@ -581,38 +605,43 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 
 		case operation_t::BIND:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::UNBIND:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
+			break;
+		}
+		case operation_t::CLIENT_OUTPUT:
+		{
+			request.get_exact<>(end);
 			break;
 		}
 
 		case operation_t::AUTH:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::ADD_USER:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::EDIT_USER:
 		{
-			request.get_exact<STR, CLIENT_AUTH>(end);
+			request.get_exact<STR_VIEW, CLIENT_AUTH>(end);
 			break;
 		}
 		case operation_t::DEL_USER:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::CHANGE_PASSWORD:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::AUTH_LEVEL:
@@ -655,12 +684,12 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 
 		case operation_t::PUBLISH:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SUBSCRIBE:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SUBSCRIBED:
@@ -670,7 +699,7 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::UNSUBSCRIBE:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::UNSUBSCRIBE_ALL:
@@ -678,20 +707,35 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 			request.get_exact<>(end);
 			break;
 		}
+		case operation_t::PSUBSCRIBE:
+		{
+			request.get_exact<STR_VIEW>(end);
+			break;
+		}
+		case operation_t::PSUBSCRIBED:
+		{
+			request.get_exact<>(end);
+			break;
+		}
+		case operation_t::PUNSUBSCRIBE:
+		{
+			request.get_exact<STR_VIEW>(end);
+			break;
+		}
 
 		case operation_t::DEL:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::TYPE:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::EXISTS:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::RESET:
@@ -706,74 +750,74 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::COPY_TO:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::MOVE_TO:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::COPY_TO_DB:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::MOVE_TO_DB:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 
 		case operation_t::SET_EXPIRY:
 		{
-			request.get_exact<STR, FLOAT>(end);
+			request.get_exact<STR_VIEW, FLOAT>(end);
 			break;
 		}
 		case operation_t::GET_EXPIRY:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::CLEAR_EXPIRY:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 
 		case operation_t::GET:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::STR_SET:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::INT_SET:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::FLOAT_SET:
 		{
-			request.get_exact<STR, FLOAT>(end);
+			request.get_exact<STR_VIEW, FLOAT>(end);
 			break;
 		}
 		case operation_t::INCR_INT:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::INCR_FLOAT:
 		{
-			request.get_exact<STR, FLOAT>(end);
+			request.get_exact<STR_VIEW, FLOAT>(end);
 			break;
 		}
 		case operation_t::STR_LEN:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::MANY_GET:
@@ -784,88 +828,88 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 
 		case operation_t::LIST_LEN:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::LIST_GET:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::LIST_SET:
 		{
-			request.get_exact<STR, INT, STR>(end);
+			request.get_exact<STR_VIEW, INT, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::LIST_PUSH_LEFT:
 		{
-			request.get_exact<STR, LIST>(end);
+			request.get_exact<STR_VIEW, LIST>(end);
 			break;
 		}
 		case operation_t::LIST_PUSH_RIGHT:
 		{
-			request.get_exact<STR, LIST>(end);
+			request.get_exact<STR_VIEW, LIST>(end);
 			break;
 		}
 		case operation_t::LIST_POP_LEFT:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::LIST_POP_RIGHT:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::LIST_RANGE:
 		{
-			request.get_exact<STR, INT, INT>(end);
+			request.get_exact<STR_VIEW, INT, INT>(end);
 			break;
 		}
 		case operation_t::LIST_TRIM:
 		{
-			request.get_exact<STR, INT, INT>(end);
+			request.get_exact<STR_VIEW, INT, INT>(end);
 			break;
 		}
 		case operation_t::LIST_REMOVE:
 		{
-			request.get_exact<STR, STR, INT>(end);
+			request.get_exact<STR_VIEW, STR_VIEW, INT>(end);
 			break;
 		}
 
 		case operation_t::SET_ADD:
 		{
-			request.get_exact<STR, SET>(end);
+			request.get_exact<STR_VIEW, SET>(end);
 			break;
 		}
 		case operation_t::SET_ALL:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SET_REMOVE:
 		{
-			request.get_exact<STR, INT>(end);
+			request.get_exact<STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::SET_DISCARD:
 		{
-			request.get_exact<STR, SET>(end);
+			request.get_exact<STR_VIEW, SET>(end);
 			break;
 		}
 		case operation_t::SET_LEN:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SET_CONTAINS:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SET_MOVE:
 		{
-			request.get_exact<STR, STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SET_UNION:
@@ -875,7 +919,7 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::SET_UNION_INTO:
 		{
-			request.get_exact<STR, ARR>(end);
+			request.get_exact<STR_VIEW, ARR>(end);
 			break;
 		}
 		case operation_t::SET_UNION_LEN:
@@ -890,7 +934,7 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::SET_INTERSECT_INTO:
 		{
-			request.get_exact<STR, ARR>(end);
+			request.get_exact<STR_VIEW, ARR>(end);
 			break;
 		}
 		case operation_t::SET_INTERSECT_LEN:
@@ -900,79 +944,79 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::SET_DIFF:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SET_DIFF_INTO:
 		{
-			request.get_exact<STR, STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::SET_DIFF_LEN:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 
 		case operation_t::HASH_SET:
 		{
-			request.get_exact<STR, HASH>(end);
+			request.get_exact<STR_VIEW, HASH>(end);
 			break;
 		}
 		case operation_t::HASH_ALL:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_GET:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_CONTAINS:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_LEN:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_KEY_LEN:
 		{
-			request.get_exact<STR, STR>(end);
+			request.get_exact<STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_REMOVE:
 		{
-			request.get_exact<STR, ARR>(end);
+			request.get_exact<STR_VIEW, ARR>(end);
 			break;
 		}
 		case operation_t::HASH_KEYS:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_VALUES:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 		case operation_t::HASH_UPDATE:
 		{
-			request.get_exact<STR, HASH>(end);
+			request.get_exact<STR_VIEW, HASH>(end);
 			break;
 		}
 		case operation_t::HASH_MANY_GET:
 		{
-			request.get_exact<STR, ARR>(end);
+			request.get_exact<STR_VIEW, ARR>(end);
 			break;
 		}
 
 		case operation_t::CLUSTER_JOIN:
 		{
-			request.get_exact<STR, STR, INT>(end);
+			request.get_exact<STR_VIEW, STR_VIEW, INT>(end);
 			break;
 		}
 		case operation_t::CLUSTER_KEY:
@@ -992,7 +1036,7 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::CLUSTER_NEW:
 		{
-			request.get_exact<STR>(end);
+			request.get_exact<STR_VIEW>(end);
 			break;
 		}
 
@@ -1008,7 +1052,7 @@ void RequestHandler::dry_dispatch(Request& request, bool end) {
 		}
 		case operation_t::PEER_AUTH:
 		{
-			request.get_exact<INT, STR, STR>(end);
+			request.get_exact<INT, STR_VIEW, STR_VIEW>(end);
 			break;
 		}
 	}
@@ -36,6 +36,9 @@ public:
 	// an unbind request was received from a client
 	virtual void request_unbind(Client& client, const std::string& host, int64_t port) = 0;
 
+	// a client_output request was received from a client
+	virtual void request_client_output(Client& client) = 0;
+
 
 	// an add_user request was received from a client
 	virtual void request_add_user(Client& client, const std::string& username, const std::string& password) = 0;
@@ -91,18 +94,27 @@ public:
 	// an unsubscribe_all request was received from a client
 	virtual void request_unsubscribe_all(Client& client) = 0;
 
+	// a psubscribe request was received from a client
+	virtual void request_psubscribe(Client& client, const std::string& pattern) = 0;
+
+	// a psubscribed request was received from a client
+	virtual void request_psubscribed(Client& client) = 0;
+
+	// a punsubscribe request was received from a client
+	virtual void request_punsubscribe(Client& client, const std::string& pattern) = 0;
+
 
 	// a del request was received from a client
 	virtual void request_del(Client& client, const std::string& key) = 0;
 
 	// a type request was received from a client
-	virtual void request_type(Client& client, const std::string& key) = 0;
+	virtual void request_type(Client& client, std::string_view key) = 0;
 
 	// a reset request was received from a client
 	virtual void request_reset(Client& client) = 0;
 
 	// an exists request was received from a client
-	virtual void request_exists(Client& client, const std::string& key) = 0;
+	virtual void request_exists(Client& client, std::string_view key) = 0;
 
 	// a keys request was received from a client
 	virtual void request_keys(Client& client) = 0;
@@ -124,14 +136,14 @@ public:
 	virtual void request_set_expiry(Client& client, const std::string& key, double seconds) = 0;
 
 	// a get_expiry request was received from a client
-	virtual void request_get_expiry(Client& client, const std::string& key) = 0;
+	virtual void request_get_expiry(Client& client, std::string_view key) = 0;
 
 	// a clear_expiry request was received from a client
 	virtual void request_clear_expiry(Client& client, const std::string& key) = 0;
 
 
 	// a get request was received from a client
-	virtual void request_get(Client& client, const std::string& key) = 0;
+	virtual void request_get(Client& client, std::string_view key) = 0;
 
 	// a str_set request was received from a client
 	virtual void request_str_set(Client& client, const std::string& key, std::string value) = 0;
@@ -149,26 +161,26 @@ public:
 	virtual void request_incr_float(Client& client, const std::string& key, double value) = 0;
 
 	// a str_len request was received from a client
-	virtual void request_str_len(Client& client, const std::string& key) = 0;
+	virtual void request_str_len(Client& client, std::string_view key) = 0;
 
 	// a many_get request was received from a client
 	virtual void request_many_get(Client& client, const std::vector<std::string>& keys) = 0;
 
 
 	// a list_len request was received from a client
-	virtual void request_list_len(Client& client, const std::string& key) = 0;
+	virtual void request_list_len(Client& client, std::string_view key) = 0;
 
 	// a list_get request was received from a client
-	virtual void request_list_get(Client& client, const std::string& key, int64_t index) = 0;
+	virtual void request_list_get(Client& client, std::string_view key, int64_t index) = 0;
 
 	// a list_set request was received from a client
 	virtual void request_list_set(Client& client, const std::string& key, int64_t index, std::string value) = 0;
 
 	// a list_push_left request was received from a client
-	virtual void request_list_push_left(Client& client, const std::string& key, std::list<std::string> values) = 0;
+	virtual void request_list_push_left(Client& client, const std::string& key, db::list_t values) = 0;
 
 	// a list_push_right request was received from a client
-	virtual void request_list_push_right(Client& client, const std::string& key, std::list<std::string> values) = 0;
+	virtual void request_list_push_right(Client& client, const std::string& key, db::list_t values) = 0;
 
 	// a list_pop_left request was received from a client
 	virtual void request_list_pop_left(Client& client, const std::string& key, int64_t count) = 0;
@@ -177,7 +189,7 @@ public:
 	virtual void request_list_pop_right(Client& client, const std::string& key, int64_t count) = 0;
 
 	// a list_range request was received from a client
-	virtual void request_list_range(Client& client, const std::string& key, int64_t start, int64_t stop) = 0;
+	virtual void request_list_range(Client& client, std::string_view key, int64_t start, int64_t stop) = 0;
 
 	// a list_trim request was received from a client
 	virtual void request_list_trim(Client& client, const std::string& key, int64_t start, int64_t stop) = 0;
@@ -190,7 +202,7 @@ public:
 	virtual void request_set_add(Client& client, const std::string& key, std::unordered_set<std::string> values) = 0;
 
 	// a set_all request was received from a client
-	virtual void request_set_all(Client& client, const std::string& key) = 0;
+	virtual void request_set_all(Client& client, std::string_view key) = 0;
 
 	// a set_remove request was received from a client
 	virtual void request_set_remove(Client& client, const std::string& key, int64_t count) = 0;
@@ -199,10 +211,10 @@ public:
 	virtual void request_set_discard(Client& client, const std::string& key, std::unordered_set<std::string> values) = 0;
 
 	// a set_len request was received from a client
-	virtual void request_set_len(Client& client, const std::string& key) = 0;
+	virtual void request_set_len(Client& client, std::string_view key) = 0;
 
 	// a set_contains request was received from a client
-	virtual void request_set_contains(Client& client, const std::string& key, const std::string& value) = 0;
+	virtual void request_set_contains(Client& client, std::string_view key, const std::string& value) = 0;
 
 	// a set_move request was received from a client
 	virtual void request_set_move(Client& client, const std::string& source, const std::string& dest, const std::string& value) = 0;
@@ -236,37 +248,37 @@ public:
 
 
 	// a hash_set request was received from a client
-	virtual void request_hash_set(Client& client, const std::string& key, std::unordered_map<std::string, std::string> values) = 0;
+	virtual void request_hash_set(Client& client, const std::string& key, db::hash_t values) = 0;
 
 	// a hash_all request was received from a client
-	virtual void request_hash_all(Client& client, const std::string& key) = 0;
+	virtual void request_hash_all(Client& client, std::string_view key) = 0;
 
 	// a hash_get request was received from a client
-	virtual void request_hash_get(Client& client, const std::string& key, const std::string& hash_key) = 0;
+	virtual void request_hash_get(Client& client, std::string_view key, std::string_view hash_key) = 0;
 
 	// a hash_contains request was received from a client
-	virtual void request_hash_contains(Client& client, const std::string& key, const std::string& hash_key) = 0;
+	virtual void request_hash_contains(Client& client, std::string_view key, std::string_view hash_key) = 0;
 
 	// a hash_len request was received from a client
-	virtual void request_hash_len(Client& client, const std::string& key) = 0;
+	virtual void request_hash_len(Client& client, std::string_view key) = 0;
 
 	// a hash_key_len request was received from a client
-	virtual void request_hash_key_len(Client& client, const std::string& key, const std::string& hash_key) = 0;
+	virtual void request_hash_key_len(Client& client, std::string_view key, std::string_view hash_key) = 0;
 
 	// a hash_remove request was received from a client
 	virtual void request_hash_remove(Client& client, const std::string& key, const std::vector<std::string>& hash_keys) = 0;
 
 	// a hash_keys request was received from a client
-	virtual void request_hash_keys(Client& client, const std::string& key) = 0;
+	virtual void request_hash_keys(Client& client, std::string_view key) = 0;
 
 	// a hash_values request was received from a client
-	virtual void request_hash_values(Client& client, const std::string& key) = 0;
+	virtual void request_hash_values(Client& client, std::string_view key) = 0;
 
 	// a hash_update request was received from a client
-	virtual void request_hash_update(Client& client, const std::string& key, std::unordered_map<std::string, std::string> values) = 0;
+	virtual void request_hash_update(Client& client, const std::string& key, db::hash_t values) = 0;
 
 	// a hash_many_get request was received from a client
-	virtual void request_hash_many_get(Client& client, const std::string& key, const std::vector<std::string>& hash_keys) = 0;
+	virtual void request_hash_many_get(Client& client, std::string_view key, const std::vector<std::string>& hash_keys) = 0;
 
 
 	// a cluster_join request was received from a client
@@ -296,15 +308,15 @@ public:
 
 protected:
 	// convenience function that contains a giant switch statement to dispatch an operation_t
-	// this extracts the command and arguments from
-	// the request string and calls the appropriate request_ method
+	// this extracts the arguments of op, which has already been extracted,
+	// from the request string and calls the appropriate request_ method
 	// this is used by RequestServer to dispatch requests and follow the same pattern
 	// do not call
-	void dispatch(Client& client, Request& request, bool end);
+	void dispatch(Client& client, Request& request, operation_t op, bool end);
 
 	// similar to dispatch_op, but merely advances m_pos by
 	// extracting the data without actually calling the request_ method
-	static void dry_dispatch(Request& request, bool end);
+	static void dry_dispatch(Request& request, operation_t op, bool end);
 };
 
 } // namespace vanity
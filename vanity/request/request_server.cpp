@@ -4,6 +4,7 @@
 
 #include "request_server.h"
 #include "request_tracker.h"
+#include "utils/cached_clock.h"
 
 namespace vanity {
 
@@ -16,6 +17,9 @@ void RequestServer::do_handle(Client &client, Request &request, size_t len) {
 	if (len == 0)
 		return;
 
+	// every key in the request is checked for expiry at the same time
+	CachedClock::Batch batch;
+
 	for (size_t i = 0; i < len - 1; ++i)
 		do_handle_single(client, request, false);
 	do_handle_single(client, request, true);
@@ -52,16 +56,17 @@ bool RequestServer::do_handle_single(Client &client, Request& request, bool end)
 }
 
 bool RequestServer::dispatch_or_refuse(Client &client, Request& request, bool end) {
-	if (not client.has_perm(request.peek_operation()))
-		return refuse_with_response(client, request, denied(), end);
+	auto op = request.get_operation();
+	if (not client.has_perm(op))
+		return refuse_with_response(client, request, op, denied(), end);
 
-	dispatch(client, request, end);
+	dispatch(client, request, op, end);
 	return true;
 }
 
-bool RequestServer::refuse_with_response(Client& client, Request& request, Response&& response, bool end) {
+bool RequestServer::refuse_with_response(Client& client, Request& request, operation_t op, Response&& response, bool end) {
 	if (not end)
-		dry_dispatch(request, end);
+		dry_dispatch(request, op, end);
 
 	send(client, response.move());
 	return false;
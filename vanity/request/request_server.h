@@ -55,9 +55,9 @@ private:
 	// check for permissions and dispatch a request or refuse it
 	bool dispatch_or_refuse(Client& client, Request& request, bool end);
 
-	// send a response to the client, calling dry_dispatch if necessary
+	// send a response to the client, calling dry_dispatch for op if necessary
 	// always returns false
-	bool refuse_with_response(Client& client, Request& request, Response&& response, bool end);
+	bool refuse_with_response(Client& client, Request& request, operation_t op, Response&& response, bool end);
 };
 
 } // namespace vanity
@@ -27,6 +27,11 @@ public:
 		reserve(body.size());
 		*this << body.data();
 	};
+
+	// append the body of shared sendable data to the PipedResponse
+	void append(std::string_view body) {
+		Sendable::operator<<(body);
+	};
 };
 
 } // namespace vanity
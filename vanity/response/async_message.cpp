@@ -12,7 +12,7 @@ auto AsyncMessage::init_op_strings() -> std::array<const char*, M_OP_COUNT> {
 	std::array<const char*, M_OP_COUNT> strings {};
 
 	for (auto& [op, str] : ASYNC_OP_STRINGS)
-		strings[static_cast<uint>(op)] = str.c_str();
+		strings[static_cast<uint>(op)] = str.data();
 
 	return strings;
 }
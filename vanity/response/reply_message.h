@@ -5,6 +5,7 @@
 #ifndef VANITY_REPLY_MESSAGE_H
 #define VANITY_REPLY_MESSAGE_H
 
+#include <array>
 #include <unordered_set>
 
 #include "cluster/reply_status.h"
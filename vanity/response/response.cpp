@@ -43,6 +43,11 @@ Response &Response::operator<<(const std::string &data) {
 	return *this;
 }
 
+Response &Response::operator<<(std::string_view data) {
+	this->Sendable::operator<<(data);
+	return *this;
+}
+
 Response &Response::operator<<(const char *data) {
 	this->Sendable::operator<<(data);
 	return *this;
@@ -57,7 +62,7 @@ Response &Response::serialize(bool data) {
 	return serialize_type<bool>() << (data ? "true" : "false");
 }
 
-Response &Response::serialize_string_body(const std::string &data) {
+Response &Response::serialize_string_body(std::string_view data) {
 	reserve(data.size() + 6);
 	serialize_length(data.size());
 	return *this << data;
@@ -80,8 +85,8 @@ Response &Response::serialize(double data) {
 	return serialize_type<double>() << std::to_string(data);
 }
 
-Response &Response::serialize(const std::list<std::string> &data) {
-	serialize_type<std::list<std::string>>();
+Response &Response::serialize(const db::list_t &data) {
+	serialize_type<db::list_t>();
 	serialize_length(data.size());
 
 	*this << '[';
@@ -100,8 +105,18 @@ Response &Response::serialize(const std::unordered_set<std::string> &data) {
 	return *this << '}';
 }
 
-Response &Response::serialize(const std::unordered_map<std::string, std::string> &data) {
-	serialize_type<std::unordered_map<std::string, std::string>>();
+Response &Response::serialize(const db::set_t &data) {
+	serialize_type<db::set_t>();
+	serialize_length(data.size());
+
+	*this << '{';
+	for (const auto &s: data)
+		serialize_string_body(s);
+	return *this << '}';
+}
+
+Response &Response::serialize(const db::hash_t &data) {
+	serialize_type<db::hash_t>();
 	serialize_length(data.size());
 
 	*this << '{';
@@ -66,6 +66,11 @@ struct type_to_string<db::list_t> {
 	static constexpr const char* value = ":LIST";
 };
 
+template <>
+struct type_to_string<std::unordered_set<std::string>> {
+	static constexpr const char* value = ":SET";
+};
+
 template <>
 struct type_to_string<db::set_t> {
 	static constexpr const char* value = ":SET";
@@ -130,6 +135,9 @@ public:
 	// add a message to the response
 	Response& operator<<(const std::string& data);
 
+	// add a message to the response
+	Response& operator<<(std::string_view data);
+
 	// add a message to the response
 	Response& operator<<(const char* data);
 
@@ -152,13 +160,16 @@ public:
 	Response& serialize(double data);
 
 	// serialize a list of strings to a Response
-	Response& serialize(const std::list<std::string>& data);
+	Response& serialize(const db::list_t& data);
 
 	// serialize a set of strings to a Response
 	Response& serialize(const std::unordered_set<std::string>& data);
 
+	// serialize a set of strings to a Response
+	Response& serialize(const db::set_t& data);
+
 	// serialize a hash of strings to a Response
-	Response& serialize(const std::unordered_map<std::string, std::string>& data);
+	Response& serialize(const db::hash_t& data);
 
 	// serialize the database's primary type to a Response
 	Response& serialize(const primary_serialize_type& data);
@@ -234,7 +245,7 @@ public:
 	}
 
 	// serialize a string's body to a Response
-	Response& serialize_string_body(const std::string &data);
+	Response& serialize_string_body(std::string_view data);
 
 	// serialize a length to a Response
 	Response& serialize_length(size_t length);
@@ -18,6 +18,14 @@ std::string&& Sendable::extract_data() {
 	return std::move(m_data);
 }
 
+auto Sendable::share() -> shared_data_t {
+	return std::make_shared<const std::string>(extract_data());
+}
+
+std::string_view Sendable::body_of(const shared_data_t& data) {
+	return std::string_view{*data}.substr(M_LENGTH_SIZE);
+}
+
 std::string_view Sendable::body() const {
 	return {m_data.data() + M_LENGTH_SIZE, m_data.size() - M_LENGTH_SIZE};
 }
@@ -36,6 +44,11 @@ Sendable &Sendable::operator<<(const std::string &data) {
 	return *this;
 }
 
+Sendable &Sendable::operator<<(std::string_view data) {
+	m_data += data;
+	return *this;
+}
+
 Sendable &Sendable::operator<<(const char *data) {
 	m_data += data;
 	return *this;
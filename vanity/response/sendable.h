@@ -5,8 +5,10 @@
 #ifndef VANITY_SENDABLE_H
 #define VANITY_SENDABLE_H
 
+#include <memory>
 #include <netinet/in.h>
 #include <string>
+#include <string_view>
 
 namespace vanity {
 
@@ -16,6 +18,10 @@ namespace vanity {
  */
 class Sendable
 {
+public:
+	// the data of a sendable, shared by everyone it is sent to
+	using shared_data_t = std::shared_ptr<const std::string>;
+
 private:
 	// the size of the length field
 	static constexpr auto M_LENGTH_SIZE = sizeof(decltype(htonl(0)));
@@ -30,6 +36,12 @@ public:
 	// destructively extract the sendable data
 	std::string&& extract_data();
 
+	// destructively extract the sendable data, to be sent to many
+	shared_data_t share();
+
+	// obtain a view of the body of some shared data
+	static std::string_view body_of(const shared_data_t& data);
+
 	// obtain a view of the (current) body (without the length field)
 	std::string_view body() const;
 
@@ -42,6 +54,9 @@ public:
 	// add a string to the sendable
 	Sendable& operator<<(const std::string& data);
 
+	// add a string view to the sendable
+	Sendable& operator<<(std::string_view data);
+
 	// add a C string to the sendable
 	Sendable& operator<<(const char* data);
 
@@ -8,10 +8,11 @@
 namespace vanity {
 
 Server::Server(const Config &config):
-	AuthServer(config.auth_file),
-	BindServer(config.host, config.ports, config.cluster_port),
 	LogServer(config.log_file, config.log_level),
-	PersistJournalServer(config.wal_file, config.db_file, config.journal_file),
+	BindServer(config.host, config.ports, config.cluster_port),
+	ClientServer(config.output_limits),
+	AuthServer(config.auth_file),
+	PersistJournalServer(config.wal_file, config.db_file, config.journal_file, config.wal_fsync_policy),
 	m_lock_file{config.lock_file}
 {
 	PersistJournalServer::recover();
@@ -27,8 +28,8 @@ void Server::start() {
 void Server::stop() {
 	RepeatEventServer::stop();
 	PersistentServer::stop();
-	ClientServer::stop();
 	PollServer::stop();
+	ClientServer::stop();
 	BindServer::stop();
 	logger().info("Stopped server");
 }
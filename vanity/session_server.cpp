@@ -69,6 +69,10 @@ user_data_t::channels_t &SessionServer::session_channels(Client &client) {
 	return session_user_data(client).channels;
 }
 
+user_data_t::channels_t &SessionServer::session_patterns(Client &client) {
+	return session_user_data(client).patterns;
+}
+
 uint64_t &SessionServer::session_trn_id(Client &client) {
 	return session_user_data(client).trn_id;
 }
@@ -44,6 +44,9 @@ public:
 	// get a client's current channels
 	static user_data_t::channels_t &session_channels(Client &client);
 
+	// get a client's current channel patterns
+	static user_data_t::channels_t &session_patterns(Client &client);
+
 	// get a reference to a client's current trn_id
 	static uint64_t& session_trn_id(Client& client);
 
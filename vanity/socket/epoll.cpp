@@ -51,6 +51,15 @@ void Epoll::remove(int fd) const {
 		throw SocketError("Could not remove client from epoll");
 }
 
+void Epoll::modify(uint32_t event_mask, void *data_ptr, int fd) const {
+	epoll_event event{};
+	event.events = event_mask;
+	event.data.ptr = data_ptr;
+	int ctl = epoll_ctl(m_fd, EPOLL_CTL_MOD, fd, &event);
+	if (ctl < 0)
+		throw SocketError("Could not modify client in epoll");
+}
+
 void Epoll::add(SocketReadHandler &handler) const {
 	add(handler.get_event_mask(), &handler, handler.socket_fd());
 }
@@ -59,6 +68,10 @@ void Epoll::remove(const SocketReadHandler &handler) const {
 	remove(handler.socket_fd());
 }
 
+void Epoll::modify(SocketReadHandler &handler, uint32_t event_mask) const {
+	modify(event_mask, &handler, handler.socket_fd());
+}
+
 void Epoll::add(SocketWriteHandler &handler) const {
 	add(handler.get_event_mask(), &handler, handler.socket_fd());
 }
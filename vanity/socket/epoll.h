@@ -54,6 +54,9 @@ private:
 	// remove an object from the epoll
 	void remove(int fd) const;
 
+	// change the events an object in the epoll is polled for
+	void modify(uint32_t event_mask, void* data_ptr, int fd) const;
+
 public:
 	// add an object to the epoll
 	void add(SocketReadHandler& handler) const;
@@ -61,6 +64,9 @@ public:
 	// remove an object from the epoll
 	void remove(const SocketReadHandler& handler) const;
 
+	// change the events an object in the epoll is polled for
+	void modify(SocketReadHandler& handler, uint32_t event_mask) const;
+
 	// add an object to the epoll
 	void add(SocketWriteHandler& handler) const;
 
@@ -2,6 +2,9 @@
 // Created by kingsli on 4/4/24.
 //
 
+#include <algorithm>
+#include <thread>
+
 #include "epoll_server.h"
 #include "exceptions.h"
 #include "socket_writer.h"
@@ -10,8 +13,10 @@
 namespace vanity::socket {
 
 EpollServer::EpollServer() {
-	m_super_epoll.add(m_read_epoll);
-	m_super_epoll.add(m_write_epoll);
+	auto count = std::max(std::thread::hardware_concurrency(), 1u);
+	m_reactors.reserve(count);
+	for (unsigned int i = 0; i < count; ++i)
+		m_reactors.emplace_back(std::make_unique<Reactor>());
 }
 
 void EpollServer::add_read_handler(SocketReadHandler &read_handler) {
@@ -23,26 +28,68 @@ void EpollServer::remove_read_handler(SocketReadHandler &read_handler) {
 }
 
 void EpollServer::add_writer(SocketWriter &writer) {
-	m_write_epoll.add(writer);
+	if (auto reactor = owner(writer.socket_fd()))
+		reactor->add_writer(writer);
 }
 
 void EpollServer::remove_writer(SocketWriter &writer) {
-	m_write_epoll.remove(writer);
+	if (auto reactor = owner(writer.socket_fd()))
+		reactor->remove_writer(writer);
+}
+
+size_t EpollServer::reactor_count() const {
+	return m_reactors.size();
+}
+
+Reactor &EpollServer::reactor(size_t index) {
+	return *m_reactors[index];
 }
 
 void EpollServer::epoll_add(SocketReadHandler &handler) {
-	m_read_epoll.add(handler);
+	std::lock_guard lock{m_owners_mutex};
+	auto& reactor = least_loaded();
+	reactor.add_read_handler(handler);
+	m_owners[handler.socket_fd()] = &reactor;
 }
 
 void EpollServer::epoll_remove(SocketReadHandler &handler) {
-	m_read_epoll.remove(handler);
+	std::lock_guard lock{m_owners_mutex};
+	auto it = m_owners.find(handler.socket_fd());
+	if (it == m_owners.end())
+		return;
+
+	it->second->remove_read_handler(handler);
+	m_owners.erase(it);
+}
+
+void EpollServer::epoll_pause(SocketReadHandler &handler) {
+	if (auto reactor = owner(handler.socket_fd()))
+		reactor->pause_read_handler(handler);
+}
+
+void EpollServer::epoll_resume(SocketReadHandler &handler) {
+	if (auto reactor = owner(handler.socket_fd()))
+		reactor->resume_read_handler(handler);
+}
+
+Reactor &EpollServer::least_loaded() {
+	auto it = std::min_element(m_reactors.begin(), m_reactors.end(), [](auto& a, auto& b) {
+		return a->load() < b->load();
+	});
+	return **it;
+}
+
+Reactor *EpollServer::owner(int fd) {
+	std::lock_guard lock{m_owners_mutex};
+	auto it = m_owners.find(fd);
+	return it == m_owners.end() ? nullptr : it->second;
 }
 
-int EpollServer::epoll_wait(int timeout) {
+int EpollServer::epoll_wait(Reactor& reactor, int timeout) {
 	static constexpr int poll_size = 1;
-	static epoll_event events[poll_size] {};
+	epoll_event events[poll_size] {};
 
-	int n = m_super_epoll.wait(events, poll_size, timeout);
+	int n = reactor.wait(events, poll_size, timeout);
 
 	if (n < 0) {
 		SocketError err{{}};
@@ -53,11 +100,11 @@ int EpollServer::epoll_wait(int timeout) {
 	return n;
 }
 
-void EpollServer::epoll_ready() {
+void EpollServer::epoll_ready(Reactor& reactor) {
 	static constexpr int super_poll_size = 2;
-	static epoll_event events[super_poll_size] {};
+	epoll_event events[super_poll_size] {};
 
-	int n = m_super_epoll.wait(events, super_poll_size, 0);
+	int n = reactor.wait(events, super_poll_size, 0);
 
 	if (n < 0) {
 		SocketError err{{}};
@@ -66,13 +113,13 @@ void EpollServer::epoll_ready() {
 
 	for (int i = 0; i < n; ++i) {
 		auto epoll = static_cast<Epoll *>(events[i].data.ptr);
-		epoll_ready(*epoll);
+		epoll_ready(reactor, *epoll);
 	}
 }
 
-void EpollServer::epoll_ready(Epoll &epoll) {
+void EpollServer::epoll_ready(Reactor& reactor, Epoll &epoll) {
 	static constexpr int poll_size = 10;
-	static epoll_event events[poll_size] {};
+	epoll_event events[poll_size] {};
 
 	while (true) {
 		int n = epoll.wait(events, poll_size, 0);
@@ -87,10 +134,10 @@ void EpollServer::epoll_ready(Epoll &epoll) {
 			break;
 
 		for (int i = 0; i < n; ++i)
-			if (&epoll == &m_read_epoll)
+			if (&epoll == &reactor.m_read_epoll)
 				read_ready(events[i]);
-			else if (&epoll == &m_write_epoll)
-				write_ready(events[i]);
+			else if (&epoll == &reactor.m_write_epoll)
+				write_ready(reactor, events[i]);
 			else
 				logger().error("Unknown epoll");
 	}
@@ -101,9 +148,9 @@ void EpollServer::read_ready(epoll_event &event) {
 	read_handler_ready(handler);
 }
 
-void EpollServer::write_ready(epoll_event &event) {
+void EpollServer::write_ready(Reactor& reactor, epoll_event &event) {
 	auto handler = static_cast<SocketWriteHandler*>(event.data.ptr);
-	handler->ready(*this);
+	handler->ready(reactor);
 }
 
 } // namespace vanity::socket
@@ -5,15 +5,23 @@
 #ifndef VANITY_EPOLL_SERVER_H
 #define VANITY_EPOLL_SERVER_H
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include "client/read_manager.h"
-#include "epoll.h"
 #include "log_server.h"
+#include "reactor.h"
 
 
 namespace vanity::socket {
 
 /*
  * An EpollServer handles epolls and epoll events
+ *
+ * Sockets are sharded across a number of Reactors,
+ * each new socket going to the least loaded Reactor
  */
 class EpollServer:
 	public virtual LogServer,
@@ -21,14 +29,14 @@ class EpollServer:
 	public virtual WriteManager
 {
 private:
-	// the epoll instance for reading
-	Epoll m_read_epoll;
+	// the reactors sockets are sharded across
+	std::vector<std::unique_ptr<Reactor>> m_reactors;
 
-	// the epoll instance for writing
-	Epoll m_write_epoll;
+	// the reactor that owns each registered socket, by file descriptor
+	std::unordered_map<int, Reactor*> m_owners;
 
-	// the epoll instance for polling the other epoll instances
-	SuperEpoll m_super_epoll;
+	// mutex for m_owners
+	std::mutex m_owners_mutex;
 
 public:
 	// create an epoll server
@@ -47,32 +55,51 @@ public:
 	void remove_writer(SocketWriter& writer) override;
 
 protected:
-	// block until an event is ready
+	// the number of reactors
+	size_t reactor_count() const;
+
+	// get the reactor at index
+	Reactor& reactor(size_t index);
+
+	// block until an event is ready on the reactor
 	// for a maximum of timeout milliseconds
 	// returns the number of events ready or -1 on error
-	int epoll_wait(int timeout);
+	int epoll_wait(Reactor& reactor, int timeout);
 
-	// add a SocketReadHandler
+	// add a SocketReadHandler to the least loaded reactor
 	void epoll_add(SocketReadHandler& handler);
 
-	// remove a SocketReadHandler
+	// remove a SocketReadHandler from its reactor
 	void epoll_remove(SocketReadHandler& handler);
 
-	// pull all ready events from all epolls
-	void epoll_ready();
+	// stop polling a SocketReadHandler until epoll_resume is called,
+	// except for the peer hanging up
+	void epoll_pause(SocketReadHandler& handler);
+
+	// poll a paused SocketReadHandler again
+	void epoll_resume(SocketReadHandler& handler);
+
+	// pull all ready events from all epolls of the reactor
+	void epoll_ready(Reactor& reactor);
 
 	// a SocketReadHandler is ready
 	virtual void read_handler_ready(SocketReadHandler* handler) = 0;
 
 private:
-	// this epoll instance is ready
-	void epoll_ready(Epoll& epoll);
+	// the reactor with the fewest read handlers
+	Reactor& least_loaded();
+
+	// the reactor that owns a socket, or nullptr if none does
+	Reactor* owner(int fd);
+
+	// this epoll instance of the reactor is ready
+	void epoll_ready(Reactor& reactor, Epoll& epoll);
 
 	// an event was gotten from the read epoll
 	void read_ready(epoll_event& event);
 
-	// an event was gotten from the write epoll
-	void write_ready(epoll_event& event);
+	// an event was gotten from the write epoll of the reactor
+	void write_ready(Reactor& reactor, epoll_event& event);
 };
 
 } // namespace vanity::socket
@@ -0,0 +1,50 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#include "reactor.h"
+#include "socket_writer.h"
+
+
+namespace vanity::socket {
+
+Reactor::Reactor() {
+	m_super_epoll.add(m_read_epoll);
+	m_super_epoll.add(m_write_epoll);
+}
+
+void Reactor::add_read_handler(SocketReadHandler &handler) {
+	m_read_epoll.add(handler);
+	++m_load;
+}
+
+void Reactor::remove_read_handler(SocketReadHandler &handler) {
+	m_read_epoll.remove(handler);
+	--m_load;
+}
+
+void Reactor::pause_read_handler(SocketReadHandler &handler) {
+	m_read_epoll.modify(handler, handler.get_paused_event_mask());
+}
+
+void Reactor::resume_read_handler(SocketReadHandler &handler) {
+	m_read_epoll.modify(handler, handler.get_event_mask());
+}
+
+void Reactor::add_writer(SocketWriter &writer) {
+	m_write_epoll.add(writer);
+}
+
+void Reactor::remove_writer(SocketWriter &writer) {
+	m_write_epoll.remove(writer);
+}
+
+size_t Reactor::load() const {
+	return m_load;
+}
+
+int Reactor::wait(epoll_event *events, int max_events, int timeout) const {
+	return m_super_epoll.wait(events, max_events, timeout);
+}
+
+} // namespace vanity::socket
@@ -0,0 +1,80 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_REACTOR_H
+#define VANITY_REACTOR_H
+
+#include <atomic>
+
+#include "client/write_manager.h"
+#include "epoll.h"
+
+
+namespace vanity::socket {
+
+/*
+ * A Reactor owns a subset of all sockets, with its own epoll instances
+ * Each Reactor is waited on by exactly one thread, so every event
+ * for a socket is handled on the thread that owns the socket
+ */
+class Reactor : public WriteManager
+{
+private:
+	friend class EpollServer;
+
+	// the epoll instance for reading
+	Epoll m_read_epoll;
+
+	// the epoll instance for writing
+	Epoll m_write_epoll;
+
+	// the epoll instance for polling the other epoll instances
+	SuperEpoll m_super_epoll;
+
+	// the number of read handlers currently owned by this reactor
+	std::atomic<size_t> m_load {0};
+
+public:
+	// create a reactor
+	Reactor();
+
+	// no copy
+	Reactor(const Reactor&) = delete;
+	Reactor& operator=(const Reactor&) = delete;
+
+	// no move
+	Reactor(Reactor&&) = delete;
+	Reactor& operator=(Reactor&&) = delete;
+
+	// add a read handler to this reactor
+	void add_read_handler(SocketReadHandler& handler);
+
+	// remove a read handler from this reactor
+	void remove_read_handler(SocketReadHandler& handler);
+
+	// stop polling a read handler, without removing it from this reactor
+	// it is still polled for the peer hanging up, so a paused client is removed
+	void pause_read_handler(SocketReadHandler& handler);
+
+	// poll a paused read handler again
+	void resume_read_handler(SocketReadHandler& handler);
+
+	// add a socket writer
+	void add_writer(SocketWriter& writer) override;
+
+	// remove a socket writer
+	void remove_writer(SocketWriter& writer) override;
+
+	// the number of read handlers owned by this reactor
+	size_t load() const;
+
+	// block until an event is ready
+	// for a maximum of timeout milliseconds
+	// returns the number of events ready or -1 on error
+	int wait(epoll_event* events, int max_events, int timeout) const;
+};
+
+} // namespace vanity::socket
+
+#endif //VANITY_REACTOR_H
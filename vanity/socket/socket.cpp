@@ -1,5 +1,6 @@
 #include <arpa/inet.h>
 #include <stdexcept>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include "exceptions.h"
@@ -45,13 +46,30 @@ size_t Socket::read(char* buffer, size_t buffer_size) const
 }
 
 size_t Socket::write(const char *buffer, size_t buffer_size) const {
-	auto bytes = ::write(m_fd, buffer, buffer_size);
+	auto bytes = ::send(m_fd, buffer, buffer_size, MSG_NOSIGNAL);
 	if (bytes < 0)
 		throw SocketError("Could not write to the socket");
 
 	return bytes;
 }
 
+size_t Socket::writev(const iovec *buffers, size_t count) const {
+	msghdr msg{};
+	msg.msg_iov = const_cast<iovec*>(buffers);
+	msg.msg_iovlen = count;
+
+	// a peer that hung up is an error, not a SIGPIPE that kills the server
+	auto bytes = ::sendmsg(m_fd, &msg, MSG_NOSIGNAL);
+	if (bytes < 0)
+		throw SocketError("Could not write to the socket");
+
+	return bytes;
+}
+
+void Socket::shutdown() const {
+	::shutdown(m_fd, SHUT_RDWR);
+}
+
 Socket Socket::connect(const char *host, uint16_t port) {
 	struct addrinfo hints{};
 	hints.ai_family = AF_INET;    // Allow IPv4
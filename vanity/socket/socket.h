@@ -4,6 +4,7 @@
 #include <cerrno>
 #include <string>
 #include <netdb.h>
+#include <sys/uio.h>
 
 
 namespace vanity::socket {
@@ -52,6 +53,12 @@ public:
 	// write from a buffer to the socket
 	size_t write(const char* buffer, size_t buffer_size) const;
 
+	// write from several buffers to the socket, in order
+	size_t writev(const iovec* buffers, size_t count) const;
+
+	// stop all reads and writes on the socket, without closing it
+	void shutdown() const;
+
 	// get the host and port of the remote socket
 	std::pair<std::string, uint16_t> get_remote_addr() const;
 
@@ -23,6 +23,11 @@ public:
 		return EPOLLIN;
 	};
 
+	// get the event bit mask while paused, only the peer hanging up
+	static constexpr uint32_t get_paused_event_mask() {
+		return EPOLLRDHUP;
+	};
+
 	virtual ~SocketReadHandler() = default;
 
 	// get the socket file descriptor
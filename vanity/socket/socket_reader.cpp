@@ -1,32 +1,98 @@
+#include <cstring>
+
+#include "exceptions.h"
 #include "socket_reader.h"
 
 namespace vanity::socket {
 
+void SocketReader::reserve(size_t size)
+{
+	if (m_start == m_end)
+		m_start = m_end = 0;
+
+	if (m_buffer.size() - m_end >= size)
+		return;
+
+	// move the unconsumed bytes to the front
+	if (m_start > 0) {
+		std::memmove(m_buffer.data(), m_buffer.data() + m_start, m_end - m_start);
+		m_end -= m_start;
+		m_start = 0;
+	}
+
+	if (m_buffer.size() - m_end < size)
+		m_buffer.resize(m_end + size);
+}
+
+size_t SocketReader::next_message_left() const
+{
+	auto available = m_end - m_start;
+	if (available < M_LENGTH_SIZE)
+		return M_READ_SIZE;
+
+	uint32_t size = 0;
+	std::memcpy(&size, m_buffer.data() + m_start, M_LENGTH_SIZE);
+
+	auto needed = M_LENGTH_SIZE + ntohl(size);
+	return std::max(M_READ_SIZE, needed > available ? needed - available : 0);
+}
+
+bool SocketReader::fill(Socket& socket)
+{
+	size_t budget = M_READ_BUDGET;
+	while (budget > 0) {
+		reserve(std::min(next_message_left(), budget));
+
+		auto wanted = std::min(m_buffer.size() - m_end, budget);
+		size_t bytes_read;
+		try {
+			bytes_read = socket.read(m_buffer.data() + m_end, wanted);
+		}
+		catch (const SocketError& e) {
+			if (e.is_retry())
+				return true;
+			throw;
+		}
+
+		if (bytes_read == 0)
+			return false;
+
+		m_end += bytes_read;
+		budget -= bytes_read;
+
+		// the socket has nothing more for now
+		if (bytes_read < wanted)
+			break;
+	}
+
+	return true;
+}
+
 bool SocketReader::read(Socket& socket, const callback_t& callback)
 {
-	if (m_message_left == 0) {
+	bool open = fill(socket);
+
+	while (m_end - m_start >= M_LENGTH_SIZE) {
 		uint32_t size = 0;
-		if (socket.read(reinterpret_cast<char*>(&size), sizeof(size)) == 0)
-			return false;
+		std::memcpy(&size, m_buffer.data() + m_start, M_LENGTH_SIZE);
+		size = ntohl(size);
+
+		if (m_end - m_start - M_LENGTH_SIZE < size)
+			break;
 
-		m_message_left = ntohl(size);
-		m_message.resize(m_message_left);
+		m_message.assign(m_buffer.data() + m_start + M_LENGTH_SIZE, size);
+		m_start += M_LENGTH_SIZE + size;
+		if (not callback(m_message))
+			break;
 	}
 
-	size_t bytes_read = socket.read(
-		m_message.data() + m_message.size() - m_message_left,
-		m_message_left
-	);
-	if (bytes_read == 0)
-		return false;
-
-	m_message_left -= bytes_read;
-	if (m_message_left == 0) {
-		callback(m_message);
-		m_message.clear();
+	// don't hold on to a large buffer once it has been drained
+	if (m_start == m_end and m_buffer.size() > M_READ_SIZE) {
+		m_buffer = std::string{};
+		m_start = m_end = 0;
 	}
 
-	return true;
+	return open;
 }
 
 } // namespace vanity::socket
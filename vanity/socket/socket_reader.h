@@ -11,21 +11,57 @@ namespace vanity::socket {
 /*
 A SocketReader reads and buffers text from a Socket,
 emitting a message when one is read
+
+Each call reads as much as the socket has, up to a budget,
+then emits every complete message in the buffer, so a client
+that pipelines many small messages costs one read() per batch
+rather than two per message
 */
 class SocketReader
 {
 private:
-	// buffer for message read
+	// the most to ask for in a single read()
+	static constexpr size_t M_READ_SIZE = 16 * 1024;
+
+	// the most to read from the socket in a single call to read()
+	// the rest is left for the next time the socket is ready
+	static constexpr size_t M_READ_BUDGET = 256 * 1024;
+
+	// the size of the length before each message
+	static constexpr size_t M_LENGTH_SIZE = sizeof(uint32_t);
+
+	// bytes read from the socket
+	// the unconsumed ones are from m_start to m_end
+	std::string m_buffer;
+
+	// the start of the unconsumed bytes in m_buffer
+	size_t m_start = 0;
+
+	// the end of the unconsumed bytes in m_buffer
+	size_t m_end = 0;
+
+	// the message being emitted
+	// reused so emitting a message does not allocate
 	std::string m_message;
 
-	// the remaining size of the current message, if any (0 if no message)
-	size_t m_message_left = 0;
+	// make room for at least size more bytes after m_end
+	void reserve(size_t size);
+
+	// the number of bytes needed to complete the next message
+	// or M_READ_SIZE if it is complete
+	size_t next_message_left() const;
+
+	// read from the socket into the buffer, up to M_READ_BUDGET
+	// returns false if the socket is closed
+	bool fill(Socket& socket);
 
 public:
-	using callback_t = std::function<void(const std::string&)>;
+	// called with each message
+	// returns false to stop emitting messages
+	using callback_t = std::function<bool(const std::string&)>;
 
 	// Read from the client's socket, buffering until a message is read
-	// transparently calls the callback with the message
+	// transparently calls the callback with each message read
 	// returns true if the socket is open, false if it is closed
 	bool read(Socket& socket, const callback_t& callback);
 };
@@ -2,6 +2,8 @@
 // Created by kingsli on 9/16/23.
 //
 
+#include <climits>
+
 #include "exceptions.h"
 #include "socket.h"
 #include "socket_writer.h"
@@ -18,47 +20,157 @@ int SocketWriter::socket_fd() const {
 
 void SocketWriter::ready(WriteManager& manager) {
 	std::lock_guard lock(m_mutex);
-	try_write_all();
-
-	if (m_message.empty())
-		manager.remove_writer(*this);
+	try_write_all(manager);
 }
 
 void SocketWriter::write(WriteManager& manager, std::string&& response) {
 	std::lock_guard lock(m_mutex);
-	auto was_empty = m_message.empty();
+	if (m_closed)
+		return;
 
-	if (was_empty)
-		m_message = std::move(response);
-	else
-		m_message += response;
+	enqueue(std::move(response));
+	flush_unless_corked(manager);
+}
 
-	try_write_all();
-	if (was_empty and !m_message.empty())
-		manager.add_writer(*this);
+void SocketWriter::write(WriteManager& manager, shared_buffer_t response) {
+	std::lock_guard lock(m_mutex);
+	if (m_closed)
+		return;
+
+	enqueue(std::move(response));
+	try_write_all(manager);
+}
+
+void SocketWriter::cork() {
+	std::lock_guard lock(m_mutex);
+	m_corked = true;
+}
+
+void SocketWriter::uncork(WriteManager& manager) {
+	std::lock_guard lock(m_mutex);
+	m_corked = false;
+	try_write_all(manager);
+}
+
+void SocketWriter::close() {
+	std::lock_guard lock(m_mutex);
+	drop_all();
+}
+
+void SocketWriter::drop_all() {
+	m_closed = true;
+	m_queue.clear();
+	m_index = 0;
+	m_size = 0;
+	check_drain();
+}
+
+size_t SocketWriter::pending() const {
+	return m_size;
+}
+
+bool SocketWriter::notify_below(size_t size, std::function<void()> on_drain) {
+	std::lock_guard lock(m_mutex);
+	if (m_size < size)
+		return false;
+
+	m_drain_size = size;
+	m_on_drain = std::move(on_drain);
+	return true;
 }
 
-void SocketWriter::try_write_all() {
-	while (m_index < m_message.size()) {
-		if (do_write())
+void SocketWriter::enqueue(std::string&& response) {
+	if (response.empty())
+		return;
+
+	m_size += response.size();
+
+	// coalesce a small response into the last buffer
+	if (not m_queue.empty() and response.size() <= M_COALESCE_SIZE) {
+		auto& back = m_queue.back();
+		if (not back.shared and back.owned.size() + response.size() <= M_BUFFER_SIZE) {
+			back.owned += response;
 			return;
+		}
+	}
+
+	m_queue.push_back({std::move(response), nullptr});
+}
+
+void SocketWriter::enqueue(shared_buffer_t response) {
+	// a small response is cheaper to copy than to queue on its own
+	if (response->size() <= M_COALESCE_SIZE)
+		return enqueue(std::string{*response});
+
+	m_size += response->size();
+	m_queue.push_back({{}, std::move(response)});
+}
+
+void SocketWriter::flush_unless_corked(WriteManager& manager) {
+	if (not m_corked or m_size >= M_CORK_LIMIT)
+		try_write_all(manager);
+}
+
+void SocketWriter::try_write_all(WriteManager& manager) {
+	while (not m_queue.empty() and not do_write());
+
+	check_drain();
 
-		m_index = 0;
-		m_message.clear();
+	if (m_queue.empty() and m_registered) {
+		manager.remove_writer(*this);
+		m_registered = false;
+	}
+	else if (not m_queue.empty() and not m_registered) {
+		manager.add_writer(*this);
+		m_registered = true;
 	}
 }
 
-bool SocketWriter::do_write(){
+void SocketWriter::check_drain() {
+	if (not m_on_drain or m_size >= m_drain_size)
+		return;
+
+	auto on_drain = std::move(m_on_drain);
+	m_on_drain = nullptr;
+	on_drain();
+}
+
+bool SocketWriter::do_write() {
+	static constexpr size_t max_iov = IOV_MAX;
+	iovec iov[max_iov];
+
+	size_t count = 0;
+	for (auto it = m_queue.begin(); it != m_queue.end() and count < max_iov; ++it, ++count) {
+		auto buffer = it->view().substr(count == 0 ? m_index : 0);
+		iov[count].iov_base = const_cast<char*>(buffer.data());
+		iov[count].iov_len = buffer.size();
+	}
+
+	size_t written;
 	try {
-		m_index += m_socket.write(m_message.c_str() + m_index, m_message.size() - m_index);
-		return m_index != m_message.size();
+		written = m_socket.writev(iov, count);
 	}
 	catch (SocketError& e) 	{
 		if (e.is_retry())
 			return true;
 
-		throw;
+		// the peer is gone: the read epoll sees the shutdown, and the client is removed from there
+		drop_all();
+		m_socket.shutdown();
+		return false;
 	}
+
+	// drop the buffers that were written completely
+	m_size -= written;
+	written += m_index;
+	while (not m_queue.empty() and written >= m_queue.front().view().size()) {
+		written -= m_queue.front().view().size();
+		m_queue.pop_front();
+	}
+	m_index = written;
+
+	// a short write means the socket is full
+	return not m_queue.empty() and count < max_iov;
 }
 
 } // namespace vanity::socket
@@ -5,8 +5,12 @@
 #ifndef VANITY_SOCKET_WRITER_H
 #define VANITY_SOCKET_WRITER_H
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <string_view>
 
 #include "socket_write_handler.h"
 
@@ -15,22 +19,80 @@ namespace vanity::socket {
 
 /*
  * A SocketWriter allows to write to a socket
+ *
+ * Responses are queued as separate buffers and written with
+ * a single writev() per batch, so a pending response is never
+ * copied again when another one is queued behind it. Small
+ * responses are coalesced into the last buffer instead.
+ *
+ * A response written to many sockets, like a published message,
+ * can be queued as one buffer shared by all their writers
+ *
+ * While corked, responses are only queued, and are all flushed
+ * together when the writer is uncorked. Shared responses are sent
+ * on behalf of other clients, so they are written right away even
+ * while corked, along with whatever is queued before them
  */
 class SocketWriter : public SocketWriteHandler
 {
+public:
+	// a buffer shared by several writers, which none of them may change
+	using shared_buffer_t = std::shared_ptr<const std::string>;
+
 private:
+	// a buffer waiting to be written, either owned by this writer or shared
+	struct buffer_t {
+		// the buffer, if owned
+		std::string owned;
+
+		// the buffer, if shared
+		shared_buffer_t shared;
+
+		// the bytes of the buffer
+		std::string_view view() const {
+			return shared ? std::string_view{*shared} : std::string_view{owned};
+		}
+	};
+
+	// responses up to this size are appended to the last buffer
+	static constexpr size_t M_COALESCE_SIZE = 1024;
+
+	// the largest a buffer may grow to by coalescing
+	static constexpr size_t M_BUFFER_SIZE = 16 * 1024;
+
+	// the most to hold back while corked before flushing anyway
+	static constexpr size_t M_CORK_LIMIT = 64 * 1024;
+
 	// the socket to write to
 	const Socket& m_socket;
 
-	// the message to write
-	std::string m_message;
+	// the buffers waiting to be written
+	std::deque<buffer_t> m_queue;
 
-	// the mutex to protect the message string
+	// the mutex to protect the queue
 	std::mutex m_mutex;
 
-	// the index of the next character to write in the current message
+	// the index of the next character to write in the first buffer
 	size_t m_index = 0;
 
+	// the number of bytes waiting to be written
+	std::atomic<size_t> m_size = 0;
+
+	// whether writes are being held back
+	bool m_corked = false;
+
+	// whether the writer is registered for write events
+	bool m_registered = false;
+
+	// whether the writer has been closed
+	bool m_closed = false;
+
+	// called once fewer than m_drain_size bytes are waiting
+	std::function<void()> m_on_drain;
+
+	// the number of waiting bytes m_on_drain waits for
+	size_t m_drain_size = 0;
+
 public:
 	// create a SocketWriter
 	explicit SocketWriter(const Socket& socket);
@@ -47,9 +109,30 @@ public:
 	// copy assignment
 	SocketWriter& operator=(const SocketWriter& other) = delete;
 
-	// register to the server's epoll to write a response
+	// queue a response, and write it unless the writer is corked
+	// register to the server's epoll if it cannot be written yet
 	void write(WriteManager& manager, std::string&& response);
 
+	// queue a shared response, and write it even if the writer is corked
+	// register to the server's epoll if it cannot be written yet
+	void write(WriteManager& manager, shared_buffer_t response);
+
+	// hold back writes until uncork() is called
+	void cork();
+
+	// write everything held back since cork() was called
+	void uncork(WriteManager& manager);
+
+	// drop everything waiting to be written, and every later response
+	void close();
+
+	// the number of bytes waiting to be written
+	size_t pending() const;
+
+	// call on_drain once fewer than size bytes are waiting
+	// returns false, without calling it, if that is already the case
+	bool notify_below(size_t size, std::function<void()> on_drain);
+
 	// get the socket file descriptor
 	int socket_fd() const override;
 
@@ -57,12 +140,29 @@ public:
 	void ready(WriteManager& manager) override;
 
 private:
+	// add a response to the queue
+	void enqueue(std::string&& response);
+
+	// add a shared response to the queue
+	void enqueue(shared_buffer_t response);
+
+	// try to write all messages in the queue, unless corked
+	void flush_unless_corked(WriteManager& manager);
+
 	// write to the socket
 	// return false when done, true otherwise
+	// if the socket cannot be written to, closes the writer and shuts down the socket
 	bool do_write();
 
 	// try to write all messages in the queue
-	void try_write_all();
+	// and register or unregister for write events as needed
+	void try_write_all(WriteManager& manager);
+
+	// call m_on_drain if few enough bytes are waiting
+	void check_drain();
+
+	// drop everything waiting to be written, and every later response
+	void drop_all();
 };
 
 } // namespace vanity::socket
@@ -0,0 +1,69 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_CACHED_CLOCK_H
+#define VANITY_CACHED_CLOCK_H
+
+#include <chrono>
+#include <optional>
+
+
+namespace vanity {
+
+/*
+ * A CachedClock reads the system clock once for a batch of work
+ *
+ * While a CachedClock::Batch is alive on a thread, now() on that thread
+ * returns the time the outermost batch began, so an operation on many
+ * keys reads the clock once instead of once per key. Outside a batch,
+ * now() reads the system clock
+ */
+class CachedClock
+{
+public:
+	using clock = std::chrono::system_clock;
+	using time_point = clock::time_point;
+
+private:
+	// the time the batch on this thread began, if there is one
+	static inline thread_local std::optional<time_point> t_now;
+
+public:
+	// the time the current batch began, or the current time
+	static time_point now() {
+		return t_now ? *t_now : clock::now();
+	}
+
+	/*
+	 * A Batch holds the time of a CachedClock on the current thread
+	 * A batch inside another keeps the time of the outer one
+	 */
+	class Batch
+	{
+	private:
+		// whether this batch set the time
+		bool m_outermost;
+
+	public:
+		// begin a batch on this thread
+		Batch() : m_outermost{not t_now} {
+			if (m_outermost)
+				t_now = clock::now();
+		}
+
+		// no copy
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+		// end the batch
+		~Batch() {
+			if (m_outermost)
+				t_now.reset();
+		}
+	};
+};
+
+} // namespace vanity
+
+#endif //VANITY_CACHED_CLOCK_H
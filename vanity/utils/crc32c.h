@@ -0,0 +1,126 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_CRC32C_H
+#define VANITY_CRC32C_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+
+namespace vanity::crc32c {
+
+/*
+ * CRC32C (Castagnoli), as used by iSCSI, ext4 and most storage formats
+ *
+ * On x86-64 CPUs with SSE4.2 and on ARMv8 CPUs with the CRC extension,
+ * the hardware crc32c instructions are used, otherwise a table is
+ */
+
+// the reflected Castagnoli polynomial
+static constexpr uint32_t M_POLYNOMIAL = 0x82f63b78;
+
+// the lookup table for the software implementation
+static constexpr auto M_TABLE = [] {
+	std::array<uint32_t, 256> table {};
+	for (uint32_t i = 0; i < 256; ++i) {
+		uint32_t crc = i;
+		for (int j = 0; j < 8; ++j)
+			crc = (crc >> 1) ^ (M_POLYNOMIAL & (0 - (crc & 1)));
+		table[i] = crc;
+	}
+	return table;
+}();
+
+// extend crc over data, a byte at a time
+inline uint32_t extend_software(uint32_t crc, const char* data, size_t size) {
+	for (size_t i = 0; i < size; ++i)
+		crc = (crc >> 8) ^ M_TABLE[(crc ^ static_cast<uint8_t>(data[i])) & 0xff];
+	return crc;
+}
+
+#if defined(__x86_64__)
+
+// extend crc over data, using the SSE4.2 crc32 instruction
+__attribute__((target("sse4.2")))
+inline uint32_t extend_hardware(uint32_t crc, const char* data, size_t size) {
+	uint64_t crc64 = crc;
+	for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		crc64 = _mm_crc32_u64(crc64, word);
+	}
+
+	crc = static_cast<uint32_t>(crc64);
+	for (; size > 0; --size, ++data)
+		crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+	return crc;
+}
+
+// whether the CPU has the crc32 instruction
+inline bool has_hardware() {
+	static const bool supported = __builtin_cpu_supports("sse4.2");
+	return supported;
+}
+
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+// extend crc over data, using the ARMv8 crc32c instructions
+inline uint32_t extend_hardware(uint32_t crc, const char* data, size_t size) {
+	for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		crc = __crc32cd(crc, word);
+	}
+
+	for (; size > 0; --size, ++data)
+		crc = __crc32cb(crc, static_cast<uint8_t>(*data));
+	return crc;
+}
+
+// whether the CPU has the crc32c instructions
+inline bool has_hardware() {
+	return true;
+}
+
+#else
+
+// no hardware implementation on this platform
+inline uint32_t extend_hardware(uint32_t crc, const char* data, size_t size) {
+	return extend_software(crc, data, size);
+}
+
+// whether the CPU has the crc32c instructions
+inline bool has_hardware() {
+	return false;
+}
+
+#endif
+
+// extend a CRC32C value (as returned by crc32c()) over more data
+inline uint32_t extend(uint32_t crc, const char* data, size_t size) {
+	crc = ~crc;
+	if (has_hardware())
+		crc = extend_hardware(crc, data, size);
+	else
+		crc = extend_software(crc, data, size);
+	return ~crc;
+}
+
+// compute the CRC32C of data
+inline uint32_t crc32c(const char* data, size_t size) {
+	return extend(0, data, size);
+}
+
+} // namespace vanity::crc32c
+
+#endif //VANITY_CRC32C_H
@@ -8,6 +8,7 @@
 #include <climits>
 #include <cstdint>
 #include <functional>
+#include <string_view>
 #include <utility>
 
 
@@ -98,4 +99,24 @@ public:
 
 } // namespace vanity::boost_hash
 
+namespace vanity {
+
+/*
+ * A transparent hash for strings
+ *
+ * Used with std::equal_to<>, this lets a map keyed by std::string
+ * be looked up by a std::string_view without building a string.
+ * It agrees with std::hash<std::string>.
+ */
+struct string_hash
+{
+	using is_transparent = void;
+
+	std::size_t operator()(std::string_view str) const noexcept {
+		return std::hash<std::string_view>{}(str);
+	}
+};
+
+} // namespace vanity
+
 #endif //VANITY_HASH_H
@@ -0,0 +1,89 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_MAPPED_FILE_H
+#define VANITY_MAPPED_FILE_H
+
+#include <algorithm>
+#include <fcntl.h>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+namespace vanity {
+
+/*
+ * A MappedFile maps a whole file into memory, read-only
+ *
+ * Pages are only read from disk when they are first touched,
+ * so mapping a large file is cheap until its contents are used
+ */
+class MappedFile
+{
+private:
+	// the start of the mapping, or nullptr if the file is empty
+	const char* m_data = nullptr;
+
+	// the size of the file
+	size_t m_size = 0;
+
+public:
+	// map a file
+	explicit MappedFile(const std::filesystem::path& file) {
+		int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			throw std::runtime_error("Could not open file: " + file.string());
+
+		m_size = std::filesystem::file_size(file);
+		if (m_size > 0) {
+			auto data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error("Could not map file: " + file.string());
+			}
+			m_data = static_cast<const char*>(data);
+		}
+
+		// the mapping stays valid without the descriptor
+		::close(fd);
+	}
+
+	// no copy
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// unmap the file
+	~MappedFile() {
+		if (m_data)
+			::munmap(const_cast<char*>(m_data), m_size);
+	}
+
+	// the contents of the file
+	std::span<const char> data() const {
+		return {m_data, m_size};
+	}
+
+	// advise the kernel that a range of the file will be read soon, in order
+	void will_need(size_t offset, size_t size) const {
+		if (not m_data or size == 0 or offset >= m_size)
+			return;
+
+		// the advised range must start on a page
+		auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+		auto start = offset / page * page;
+		auto length = std::min(offset + size, m_size) - start;
+
+		// advice values are not flags, so each needs its own call
+		::madvise(const_cast<char*>(m_data) + start, length, MADV_SEQUENTIAL);
+		::madvise(const_cast<char*>(m_data) + start, length, MADV_WILLNEED);
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_MAPPED_FILE_H
@@ -0,0 +1,279 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_MPMC_QUEUE_H
+#define VANITY_MPMC_QUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+
+namespace vanity {
+
+// a threadsafe, bounded, lock-free queue
+// a drop-in for Queue<T>, for values that are cheap to default construct
+//
+// this is Dmitry Vyukov's bounded MPMC queue: each cell carries a sequence
+// number saying whether it is ready to be written or read, so producers
+// and consumers each claim a cell with one CAS and never take a lock.
+// a thread that must wait, for an element or for space, spins briefly,
+// then parks on a futex (std::atomic::wait), which costs a wake syscall
+// only while some thread is actually parked
+template <class T, size_t Capacity = 1024>
+class MpmcQueue
+{
+private:
+	static_assert(Capacity >= 2 and (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	// mask a position to an index in m_cells
+	static constexpr size_t M_MASK = Capacity - 1;
+
+	// times to spin before parking, when there is another core to wait for
+	static constexpr int M_SPINS = 128;
+
+	// the size of a cache line, to keep the positions apart
+	// they are kept apart by padding rather than alignas, so embedding
+	// the queue does not raise the alignment of the class holding it
+	static constexpr size_t M_CACHE_LINE = 64;
+
+	// longest a timed wait parks between checks
+	static constexpr std::chrono::microseconds M_MAX_BACKOFF {1000};
+
+	// a slot in the ring
+	struct cell {
+		// the position this cell can be written at, or read at plus one
+		std::atomic<size_t> sequence;
+
+		// the element in the cell
+		T value;
+	};
+
+	// the ring of cells
+	std::array<cell, Capacity> m_cells;
+
+	// keeps the cells apart from the positions
+	char m_cells_pad[M_CACHE_LINE];
+
+	// the position of the next element to be written
+	std::atomic<size_t> m_enqueue_pos {0};
+
+	// keeps the positions apart
+	char m_enqueue_pad[M_CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+	// the position of the next element to be read
+	std::atomic<size_t> m_dequeue_pos {0};
+
+	// keeps the positions apart from the parking counters
+	char m_dequeue_pad[M_CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+	// bumped after every push, for consumers to park on
+	std::atomic<uint32_t> m_pushes {0};
+
+	// bumped after every pop, for producers to park on
+	std::atomic<uint32_t> m_pops {0};
+
+	// the number of parked consumers
+	std::atomic<uint32_t> m_parked_consumers {0};
+
+	// the number of parked producers
+	std::atomic<uint32_t> m_parked_producers {0};
+
+	// times to spin before parking on this machine
+	// on a single core, the thread being waited for cannot run while we spin
+	static int spins() {
+		static const int spins = std::thread::hardware_concurrency() > 1 ? M_SPINS : 0;
+		return spins;
+	}
+
+	// tell the CPU this is a spin loop
+	static void relax() {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__)
+		asm volatile("yield");
+#endif
+	}
+
+	// write to a free cell, or return false if the queue is full
+	template<typename ...Args>
+	bool try_emplace(Args&&... args) {
+		auto pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		while (true) {
+			auto& slot = m_cells[pos & M_MASK];
+			auto seq = slot.sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+			if (diff == 0) {
+				if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					slot.value = T(std::forward<Args>(args)...);
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	// read from a full cell, or return std::nullopt if the queue is empty
+	std::optional<T> try_pop() {
+		auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		while (true) {
+			auto& slot = m_cells[pos & M_MASK];
+			auto seq = slot.sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+			if (diff == 0) {
+				if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					std::optional<T> val{std::move(slot.value)};
+					slot.sequence.store(pos + Capacity, std::memory_order_release);
+					return val;
+				}
+			}
+			else if (diff < 0)
+				return std::nullopt;
+			else
+				pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	// signal one parked thread waiting on counter, if there is any
+	static void signal(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& parked) {
+		counter.fetch_add(1);
+		if (parked.load() > 0)
+			counter.notify_one();
+	}
+
+	// call attempt until it succeeds, spinning, then parking on counter
+	template<typename F>
+	static auto spin_then_park(F&& attempt, std::atomic<uint32_t>& counter, std::atomic<uint32_t>& parked) {
+		for (int i = 0, n = spins(); i < n; ++i) {
+			if (auto result = attempt())
+				return result;
+			relax();
+		}
+
+		while (true) {
+			// announce the park before the last check, so a signal after it is not missed
+			++parked;
+			auto seen = counter.load();
+			if (auto result = attempt()) {
+				--parked;
+				return result;
+			}
+
+			counter.wait(seen);
+			--parked;
+			if (auto result = attempt())
+				return result;
+		}
+	}
+
+	// call attempt until it succeeds or timeout microseconds pass
+	template<typename F>
+	static auto spin_then_sleep(F&& attempt, long timeout) {
+		using namespace std::chrono;
+		auto end = steady_clock::now() + microseconds{timeout};
+		auto backoff = microseconds{1};
+
+		for (int i = 0, n = spins(); i < n; ++i) {
+			if (auto result = attempt())
+				return result;
+			relax();
+		}
+
+		// atomic waits cannot time out, so sleep in growing steps instead
+		while (true) {
+			if (auto result = attempt())
+				return result;
+
+			auto now = steady_clock::now();
+			if (now >= end)
+				return decltype(attempt()){};
+
+			std::this_thread::sleep_for(std::min({backoff, M_MAX_BACKOFF, duration_cast<microseconds>(end - now)}));
+			backoff *= 2;
+		}
+	}
+
+public:
+	// create an empty queue
+	MpmcQueue() {
+		for (size_t i = 0; i < Capacity; ++i)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	// no copy
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+	// no move, the cells are shared with other threads by address
+	MpmcQueue(MpmcQueue&&) = delete;
+	MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+	// get an element from the queue, blocking till one is available
+	T get()
+	{
+		auto val = spin_then_park([this] { return try_pop(); }, m_pushes, m_parked_consumers);
+		signal(m_pops, m_parked_producers);
+		return std::move(*val);
+	}
+
+	// get an element from the queue, blocking till one is available
+	// or timeout in microseconds
+	std::optional<T> get(long timeout)
+	{
+		auto val = spin_then_sleep([this] { return try_pop(); }, timeout);
+		if (val)
+			signal(m_pops, m_parked_producers);
+		return val;
+	}
+
+	// wait for timeout in microseconds for an element
+	// return false on timeout, true otherwise
+	// a get() is not guaranteed to succeed after a wait() returns true
+	bool wait(long timeout) {
+		return spin_then_sleep([this] { return not empty(); }, timeout);
+	}
+
+	// check if the queue is empty
+	bool empty()
+	{
+		auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+		auto seq = m_cells[pos & M_MASK].sequence.load(std::memory_order_acquire);
+		return seq != pos + 1;
+	}
+
+	// push an item onto the queue, blocking while it is full
+	void push(T item) {
+		emplace(std::move(item));
+	}
+
+	// emplace an item onto the queue, blocking while it is full
+	template<typename ...Args>
+	void emplace(Args&&... args)
+	{
+		// the arguments are only used by the attempt that succeeds
+		spin_then_park([&] { return try_emplace(std::forward<Args>(args)...); }, m_pops, m_parked_producers);
+		signal(m_pushes, m_parked_consumers);
+	}
+
+	// clear the queue
+	void clear()
+	{
+		while (try_pop())
+			signal(m_pops, m_parked_producers);
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_MPMC_QUEUE_H
@@ -0,0 +1,212 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_PATTERN_TRIE_H
+#define VANITY_PATTERN_TRIE_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace vanity {
+
+/*
+ * A PatternTrie maps glob patterns to sets of values, and finds
+ * the values of every pattern that matches some text
+ *
+ * In a pattern, '*' matches any sequence of characters, and '?'
+ * matches any one character. Patterns share nodes for their common
+ * prefixes, so a match walks the text once for all of them. It keeps
+ * the set of nodes the text read so far can reach, each node once,
+ * so a match costs at most the number of nodes times the length of
+ * the text, however many '*'s the patterns have. A trailing '*', as
+ * in a prefix pattern, matches the rest of the text without walking
+ * it any further.
+ */
+template<typename T>
+class PatternTrie
+{
+private:
+	// matches any sequence of characters
+	static constexpr char M_ANY_SEQUENCE = '*';
+
+	// matches any one character
+	static constexpr char M_ANY_CHAR = '?';
+
+	// a node in the trie
+	struct node {
+		// the next node for each character, including the wildcards
+		std::unordered_map<char, std::unique_ptr<node>> next;
+
+		// the values of the patterns that end here
+		std::unordered_set<T> values;
+
+		// whether the node is reached by a '*', so it matches any character itself
+		bool any_sequence = false;
+
+		// whether nothing ends at or after this node
+		bool empty() const {
+			return next.empty() and values.empty();
+		}
+	};
+
+	// the root of the trie, for the empty prefix
+	node m_root;
+
+	// the number of (pattern, value) pairs in the trie
+	size_t m_size = 0;
+
+	/*
+	 * The state of a match: the nodes the text read so far can reach
+	 */
+	template<typename F>
+	struct matcher
+	{
+		// called with the value of every pattern that matches
+		F& on_match;
+
+		// the nodes reached by the text read so far
+		std::vector<const node*> current;
+
+		// the nodes reached by the text including the next character
+		std::vector<const node*> next;
+
+		// the nodes already in next
+		std::unordered_set<const node*> seen;
+
+		// the nodes of trailing '*'s, whose values were already passed
+		std::unordered_set<const node*> done;
+
+		// start a match that calls on_match
+		explicit matcher(F& on_match) : on_match{on_match} {}
+
+		// reach a node, and the node after its '*' if any, since a '*' may match nothing
+		void reach(const node& target) {
+			if (target.any_sequence and target.next.empty()) {
+				// a trailing '*' matches the rest of the text, whatever it is
+				if (done.insert(&target).second)
+					for (const auto& value : target.values)
+						on_match(value);
+				return;
+			}
+
+			if (not seen.insert(&target).second)
+				return;
+
+			next.push_back(&target);
+			if (auto it = target.next.find(M_ANY_SEQUENCE); it != target.next.end())
+				reach(*it->second);
+		}
+
+		// follow the character c from every node reached so far
+		void step(char c) {
+			next.clear();
+			seen.clear();
+			for (auto state : current) {
+				if (state->any_sequence)
+					reach(*state);
+
+				// a wildcard in the text is only matched by the wildcards
+				auto end = state->next.end();
+				if (c != M_ANY_SEQUENCE and c != M_ANY_CHAR)
+					if (auto it = state->next.find(c); it != end)
+						reach(*it->second);
+
+				if (auto it = state->next.find(M_ANY_CHAR); it != end)
+					reach(*it->second);
+			}
+			std::swap(current, next);
+		}
+
+		// call on_match with the values of every pattern that matches the text
+		void run(const node& root, std::string_view text) {
+			reach(root);
+			std::swap(current, next);
+			for (char c : text) {
+				if (current.empty())
+					return;
+				step(c);
+			}
+
+			for (auto state : current)
+				for (const auto& value : state->values)
+					on_match(value);
+		}
+	};
+
+	// collapse consecutive '*'s, which match the same as one
+	static std::string normalize(std::string_view pattern) {
+		std::string normal;
+		normal.reserve(pattern.size());
+		for (size_t i = 0; i < pattern.size(); ++i)
+			if (not (pattern[i] == M_ANY_SEQUENCE and i > 0 and pattern[i - 1] == M_ANY_SEQUENCE))
+				normal += pattern[i];
+		return normal;
+	}
+
+	// erase a pattern's value below current, pruning emptied nodes
+	// returns whether the value was found
+	static bool erase(node& current, std::string_view pattern, const T& value) {
+		if (pattern.empty())
+			return current.values.erase(value) > 0;
+
+		auto it = current.next.find(pattern.front());
+		if (it == current.next.end())
+			return false;
+
+		auto erased = erase(*it->second, pattern.substr(1), value);
+		if (it->second->empty())
+			current.next.erase(it);
+
+		return erased;
+	}
+
+public:
+	// add a value for a pattern
+	// returns whether it was not already there
+	bool insert(std::string_view pattern, const T& value) {
+		auto current = &m_root;
+		for (char c : normalize(pattern)) {
+			auto& next = current->next[c];
+			if (not next) {
+				next = std::make_unique<node>();
+				next->any_sequence = c == M_ANY_SEQUENCE;
+			}
+			current = next.get();
+		}
+
+		auto inserted = current->values.insert(value).second;
+		m_size += inserted;
+		return inserted;
+	}
+
+	// remove a value for a pattern
+	// returns whether it was there
+	bool erase(std::string_view pattern, const T& value) {
+		auto erased = erase(m_root, normalize(pattern), value);
+		m_size -= erased;
+		return erased;
+	}
+
+	// whether there are no patterns
+	bool empty() const {
+		return m_size == 0;
+	}
+
+	// call on_match(value) for the value of every pattern matching text
+	// a value is passed once for each of its patterns that match
+	template<typename F>
+	void match(std::string_view text, F&& on_match) const {
+		if (not empty())
+			matcher<F>{on_match}.run(m_root, text);
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_PATTERN_TRIE_H
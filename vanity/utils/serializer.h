@@ -6,277 +6,593 @@
 #define VANITY_SERIALIZER_H
 
 #include <concepts>
+#include <cstring>
 #include <fstream>
-
+#include <istream>
+#include <list>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "db/db/sharded_map.h"
 #include "db/db/types.h"
+#include "db/db/value.h"
 
 namespace vanity::serializer {
 
-// write something to an output stream
-template<typename T>
-static void write(std::ofstream &out, const T& value);
+// something that can be written to, like std::ostream or BufferWriter
+template<typename Out>
+concept Output = requires(Out& out, const char* data, size_t size) {
+	out.write(data, size);
+};
 
-// read something from an input stream
-template<typename T>
-static T read(std::ifstream &in);
+// something that can be read from, like std::istream or SpanReader
+template<typename In>
+concept Input = requires(In& in, char* data, size_t size) {
+	in.read(data, size);
+};
 
-// write an arithmetic value to the output stream
-template<typename T>
-requires std::is_arithmetic_v<std::remove_reference_t<T>>
-void write(std::ofstream &out, const T& value)
+/*
+ * A BufferWriter collects writes in a contiguous buffer
+ *
+ * With a sink, the buffer is handed to the sink in large chunks, so
+ * the sink is written to once per chunk rather than once per field.
+ * Without a sink, everything written stays in the buffer.
+ */
+class BufferWriter
 {
-	out.write(reinterpret_cast<const char *>(&value), sizeof(T));
-}
+private:
+	// the size at which the buffer is flushed to the sink
+	static constexpr size_t M_FLUSH_SIZE = 1024 * 1024;
 
-// read an arithmetic value from the input stream
-template<typename T>
-requires std::is_arithmetic_v<std::remove_reference_t<T>>
-T read(std::ifstream &in)
+	// the buffer
+	std::string m_buffer;
+
+	// the sink, if any
+	std::ostream* m_sink = nullptr;
+
+	// the number of bytes flushed to the sink
+	size_t m_flushed = 0;
+
+public:
+	// create a BufferWriter without a sink
+	BufferWriter() = default;
+
+	// create a BufferWriter that flushes to sink
+	explicit BufferWriter(std::ostream& sink) : m_sink{&sink} {
+		m_buffer.reserve(M_FLUSH_SIZE);
+	}
+
+	// no copy
+	BufferWriter(const BufferWriter&) = delete;
+	BufferWriter& operator=(const BufferWriter&) = delete;
+
+	// flush what is left to the sink
+	~BufferWriter() {
+		flush();
+	}
+
+	// write data
+	void write(const char* data, size_t size) {
+		if (m_sink and size >= M_FLUSH_SIZE) {
+			// too large to be worth copying into the buffer
+			flush();
+			m_sink->write(data, static_cast<std::streamsize>(size));
+			m_flushed += size;
+			return;
+		}
+
+		m_buffer.append(data, size);
+		if (m_sink and m_buffer.size() >= M_FLUSH_SIZE)
+			flush();
+	}
+
+	// hand the buffer to the sink, if any
+	void flush() {
+		if (not m_sink or m_buffer.empty())
+			return;
+
+		m_sink->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		m_flushed += m_buffer.size();
+		m_buffer.clear();
+	}
+
+	// the number of bytes written so far
+	size_t position() const {
+		return m_flushed + m_buffer.size();
+	}
+
+	// the bytes in the buffer
+	std::string_view view() const {
+		return m_buffer;
+	}
+
+	// the bytes in the buffer
+	std::span<char> data() {
+		return m_buffer;
+	}
+
+	// empty the buffer, keeping its capacity
+	void clear() {
+		m_buffer.clear();
+	}
+
+	// take the buffer
+	std::string take() {
+		return std::exchange(m_buffer, {});
+	}
+};
+
+/*
+ * A SpanReader reads from a span of memory, without copying it
+ * where the reader can use a view of it instead
+ */
+class SpanReader
 {
-	T value;
-	in.read(reinterpret_cast<char *>(&value), sizeof(T));
-	return value;
-}
+private:
+	// the data
+	std::span<const char> m_data;
+
+	// the position of the next read
+	size_t m_pos = 0;
+
+public:
+	// create a SpanReader over data
+	explicit SpanReader(std::span<const char> data) : m_data{data} {}
+
+	// create a SpanReader over a string
+	explicit SpanReader(std::string_view data) : m_data{data.data(), data.size()} {}
+
+	// get a view of the next size bytes, and move past them
+	std::string_view read_view(size_t size) {
+		if (size > remaining())
+			throw std::out_of_range("Read past the end of the data");
+
+		std::string_view view {m_data.data() + m_pos, size};
+		m_pos += size;
+		return view;
+	}
+
+	// copy the next size bytes into data
+	void read(char* data, size_t size) {
+		auto view = read_view(size);
+		std::memcpy(data, view.data(), size);
+	}
 
-// write an enum to the output stream
+	// the position of the next read
+	size_t position() const {
+		return m_pos;
+	}
+
+	// the number of bytes left
+	size_t remaining() const {
+		return m_data.size() - m_pos;
+	}
+};
+
+
+/*
+ * How a value of type T is written and read
+ *
+ * This is specialized for each type that can be serialized,
+ * with a static write(Output&, const T&) and a static T read(Input&)
+ */
 template<typename T>
-requires std::is_enum_v<std::remove_reference_t<T>>
-void write(std::ofstream &out, const T& value)
+struct serial;
+
+// write something to an output
+template<typename T, Output Out>
+void write(Out &out, const T& value)
 {
-	write(out, static_cast<std::underlying_type_t<T>>(value));
+	serial<T>::write(out, value);
 }
 
-// read an enum from the input stream
-template<typename T>
-requires std::is_enum_v<std::remove_reference_t<T>>
-T read(std::ifstream &in)
+// read something from an input
+template<typename T, Input In>
+T read(In &in)
 {
-	return static_cast<T>(read<std::underlying_type_t<T>>(in));
+	return serial<T>::read(in);
 }
 
-// write a string to the output stream
-template<>
-void write<db::string_t>(std::ofstream &out, const db::string_t& value)
+// read a pair from an input
+template<typename K, typename V, Input In>
+std::pair<K, V> read(In &in)
 {
-	write(out, value.size());
-	out.write(value.data(), value.size());
+	K first = read<K>(in);
+	V second = read<V>(in);
+	return std::make_pair(std::move(first), std::move(second));
 }
 
-// read a string from the input stream
-template<>
-db::string_t read<db::string_t>(std::ifstream &in)
+// arithmetic values are written as they are in memory
+template<typename T>
+requires std::is_arithmetic_v<T>
+struct serial<T>
 {
-	auto size = read<std::streamsize>(in);
-	db::string_t str{};
-	str.resize(size);
-	in.read(str.data(), size);
-	return str;
-}
+	template<Output Out>
+	static void write(Out &out, const T& value) {
+		out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
 
-// write a list to the output stream
-template<>
-void write<db::list_t>(std::ofstream &out, const db::list_t& value)
+	template<Input In>
+	static T read(In &in) {
+		T value;
+		in.read(reinterpret_cast<char *>(&value), sizeof(T));
+		return value;
+	}
+};
+
+// enums are written as their underlying type
+template<typename T>
+requires std::is_enum_v<T>
+struct serial<T>
 {
-	write(out, value.size());
-	for (const auto& s : value)
-		write(out, s);
-}
+	template<Output Out>
+	static void write(Out &out, const T& value) {
+		serializer::write(out, static_cast<std::underlying_type_t<T>>(value));
+	}
 
-// read a list from the input stream
+	template<Input In>
+	static T read(In &in) {
+		return static_cast<T>(serializer::read<std::underlying_type_t<T>>(in));
+	}
+};
+
+// strings are written as their size, then their characters
 template<>
-db::list_t read<db::list_t>(std::ifstream &in)
+struct serial<db::string_t>
 {
-	db::list_t list{};
-	auto size = read<std::streamsize>(in);
-	for (std::streamsize i = 0; i < size; ++i)
-		list.push_back(read<db::string_t>(in));
-	return list;
-}
+	template<Output Out>
+	static void write(Out &out, const db::string_t& value) {
+		serializer::write(out, value.size());
+		out.write(value.data(), value.size());
+	}
 
-// write a set to the output stream
+	template<Input In>
+	static db::string_t read(In &in) {
+		auto size = serializer::read<std::streamsize>(in);
+		if constexpr (requires { in.read_view(size); }) {
+			return db::string_t{in.read_view(size)};
+		}
+		else {
+			db::string_t str{};
+			str.resize(size);
+			in.read(str.data(), size);
+			return str;
+		}
+	}
+};
+
+// string_views are written like strings
 template<>
-void write<db::set_t>(std::ofstream &out, const db::set_t& value)
+struct serial<std::string_view>
 {
-	write(out, value.size());
-	for (const auto& s : value)
-		write(out, s);
-}
+	template<Output Out>
+	static void write(Out &out, const std::string_view& value) {
+		serializer::write(out, value.size());
+		out.write(value.data(), value.size());
+	}
+};
 
-// read a set from the input stream
+// time points are written as they are in memory
 template<>
-db::set_t read<db::set_t>(std::ifstream &in)
+struct serial<db::time_t>
 {
-	db::set_t set{};
-	auto size = read<std::streamsize>(in);
-	for (std::streamsize i = 0; i < size; ++i)
-		set.insert(read<db::string_t>(in));
-	return set;
-}
+	template<Output Out>
+	static void write(Out &out, const db::time_t& value) {
+		out.write(reinterpret_cast<const char *>(&value), sizeof(db::time_t));
+	}
 
-// write a hash to the output stream
-template<>
-void write<db::hash_t>(std::ofstream &out, const db::hash_t& value)
+	template<Input In>
+	static db::time_t read(In &in) {
+		db::time_t value;
+		in.read(reinterpret_cast<char *>(&value), sizeof(db::time_t));
+		return value;
+	}
+};
+
+// lists are written as their size, then their elements
+template<typename T>
+struct serial<std::list<T>>
 {
-	write(out, value.size());
-	for (const auto& s : value) {
-		write(out, s.first);
-		write(out, s.second);
+	template<Output Out>
+	static void write(Out &out, const std::list<T>& value) {
+		serializer::write(out, value.size());
+		for (const auto& v : value)
+			serializer::write(out, v);
 	}
-}
 
-// read a hash from the input stream
+	template<Input In>
+	static std::list<T> read(In &in) {
+		std::list<T> list{};
+		auto size = serializer::read<std::streamsize>(in);
+		for (std::streamsize i = 0; i < size; ++i)
+			list.push_back(serializer::read<T>(in));
+		return list;
+	}
+};
+
+// quicklists are written like lists of strings
 template<>
-db::hash_t read<db::hash_t>(std::ifstream &in)
+struct serial<db::list_t>
 {
-	db::hash_t hash{};
-	auto size = read<std::streamsize>(in);
-	for (std::streamsize i = 0; i < size; ++i) {
-		auto key = read<db::string_t>(in);
-		auto value = read<db::string_t>(in);
-		hash[key] = value;
-	}
-	return hash;
-}
+	template<Output Out>
+	static void write(Out &out, const db::list_t& value) {
+		serializer::write(out, value.size());
+		for (auto v : value)
+			serializer::write(out, v);
+	}
+
+	template<Input In>
+	static db::list_t read(In &in) {
+		db::list_t list{};
+		auto size = serializer::read<std::streamsize>(in);
+		for (std::streamsize i = 0; i < size; ++i)
+			list.push_back(serializer::read<db::string_t>(in));
+		return list;
+	}
+};
 
-// write a primary_serialize_type to the output stream
+// compact sets are written like sets of strings
 template<>
-void write<db::db_data_type>(std::ofstream &out, const db::db_data_type& value)
+struct serial<db::set_t>
 {
-	// int8_t saves us 7 bytes per primary_serialize_type since we'll never have > 256 types
-	auto index = static_cast<int8_t>(value.index());
-	write(out, index);
-	switch (index) {
-		case 0:
-			return write(out, std::get<0>(value));
-		case 1:
-			return write(out, std::get<1>(value));
-		case 2:
-			return write(out, std::get<2>(value));
-		case 3:
-			return write(out, std::get<3>(value));
-		case 4:
-			return write(out, std::get<4>(value));
-		case 5:
-			return write(out, std::get<5>(value));
-		default:
-			throw std::runtime_error("invalid type");
+	template<Output Out>
+	static void write(Out &out, const db::set_t& value) {
+		serializer::write(out, value.size());
+		for (const auto& v : value)
+			serializer::write(out, v);
 	}
-}
 
-// read a primary_serialize_type from the input stream
+	template<Input In>
+	static db::set_t read(In &in) {
+		db::set_t set{};
+		auto size = serializer::read<std::streamsize>(in);
+		set.reserve(size);
+		for (std::streamsize i = 0; i < size; ++i)
+			set.insert(serializer::read<db::string_t>(in));
+		return set;
+	}
+};
+
+// compact hashes are written like maps of strings to strings
 template<>
-db::db_data_type read<db::db_data_type>(std::ifstream &in)
+struct serial<db::hash_t>
 {
-	switch (read<int8_t>(in)) {
-		case 0:
-			return read<db::db_index_t<0>>(in);
-		case 1:
-			return read<db::db_index_t<1>>(in);
-		case 2:
-			return read<db::db_index_t<2>>(in);
-		case 3:
-			return read<db::db_index_t<3>>(in);
-		case 4:
-			return read<db::db_index_t<4>>(in);
-		case 5:
-			return read<db::db_index_t<5>>(in);
-		default:
-			throw std::runtime_error("invalid type");
+	template<Output Out>
+	static void write(Out &out, const db::hash_t& value) {
+		serializer::write(out, value.size());
+		for (const auto& [k, v] : value) {
+			serializer::write(out, k);
+			serializer::write(out, v);
+		}
 	}
-}
 
-// write a db::time_t to the output stream
-template<>
-void write<db::time_t>(std::ofstream &out, const db::time_t& value)
+	template<Input In>
+	static db::hash_t read(In &in) {
+		db::hash_t hash{};
+		auto size = serializer::read<std::streamsize>(in);
+		hash.reserve(size);
+		for (std::streamsize i = 0; i < size; ++i) {
+			auto [k, v] = serializer::read<db::string_t, db::string_t>(in);
+			hash.insert_or_assign(std::move(k), std::move(v));
+		}
+		return hash;
+	}
+};
+
+// vectors are written as their size, then their elements
+template<typename T>
+struct serial<std::vector<T>>
 {
-	out.write(reinterpret_cast<const char *>(&value), sizeof(db::time_t));
-}
+	template<Output Out>
+	static void write(Out &out, const std::vector<T>& value) {
+		serializer::write(out, value.size());
+		for (const auto& v : value)
+			serializer::write(out, v);
+	}
 
-// read a db::time_t from the input stream
-template<>
-db::time_t read<db::time_t>(std::ifstream &in)
+	template<Input In>
+	static std::vector<T> read(In &in) {
+		std::vector<T> vec{};
+		auto size = serializer::read<size_t>(in);
+		vec.reserve(size);
+		for (size_t i = 0; i < size; ++i)
+			vec.push_back(serializer::read<T>(in));
+		return vec;
+	}
+};
+
+// sets are written as their size, then their elements
+template<typename T>
+struct serial<std::unordered_set<T>>
 {
-	db::time_t value;
-	in.read(reinterpret_cast<char *>(&value), sizeof(db::time_t));
-	return value;
-}
+	template<Output Out>
+	static void write(Out &out, const std::unordered_set<T>& value) {
+		serializer::write(out, value.size());
+		for (const auto& v : value)
+			serializer::write(out, v);
+	}
 
-// write a vector of strings to the output stream
-template<>
-void write<std::vector<db::string_t>>(std::ofstream &out, const std::vector<db::string_t>& value)
+	template<Input In>
+	static std::unordered_set<T> read(In &in) {
+		std::unordered_set<T> set{};
+		auto size = serializer::read<std::streamsize>(in);
+		set.reserve(size);
+		for (std::streamsize i = 0; i < size; ++i)
+			set.insert(serializer::read<T>(in));
+		return set;
+	}
+};
+
+// pairs are written as their first, then their second element
+template<typename K, typename V>
+struct serial<std::pair<K, V>>
 {
-	write(out, value.size());
-	for (const auto& v : value)
-		write(out, v);
-}
+	template<Output Out>
+	static void write(Out &out, const std::pair<K, V>& value) {
+		serializer::write(out, value.first);
+		serializer::write(out, value.second);
+	}
+};
 
-// read a vector of strings from the input stream
-template<>
-std::vector<db::string_t> read<std::vector<db::string_t>>(std::ifstream &in)
+// maps are written as their size, then their pairs
+template<typename K, typename V, typename Hash, typename Equal>
+struct serial<std::unordered_map<K, V, Hash, Equal>>
 {
-	std::vector<db::string_t> vec{};
-	auto size = read<size_t>(in);
-	vec.reserve(size);
-	for (size_t i = 0; i < size; ++i)
-		vec.push_back(read<db::string_t>(in));
-	return vec;
-}
+	template<Output Out>
+	static void write(Out &out, const std::unordered_map<K, V, Hash, Equal>& value) {
+		serializer::write(out, value.size());
+		for (const auto& pair : value)
+			serializer::write(out, pair);
+	}
 
-// write a string_view to the output stream
-template<>
-void write(std::ofstream &out, const std::string_view& value)
+	template<Input In>
+	static std::unordered_map<K, V, Hash, Equal> read(In &in) {
+		std::unordered_map<K, V, Hash, Equal> map{};
+		auto size = serializer::read<std::streamsize>(in);
+		map.reserve(size);
+		for (std::streamsize i = 0; i < size; ++i)
+			map.insert(serializer::read<K, V>(in));
+		return map;
+	}
+};
+
+// KeyTables are written in the same format as an unordered_map,
+// without their expiry times
+template<typename K, typename V, typename Hash>
+struct serial<db::KeyTable<K, V, Hash>>
 {
-	write(out, value.size());
-	out.write(value.data(), value.size());
-}
+	template<Output Out>
+	static void write(Out &out, const db::KeyTable<K, V, Hash>& value) {
+		serializer::write(out, value.size());
+		for (const auto& [k, v] : value) {
+			serializer::write(out, k);
+			serializer::write(out, v);
+		}
+	}
+};
 
-// write a pair to the output stream
-template<typename K, typename V>
-void write(std::ofstream &out, const std::pair<K, V>& value)
+// ShardedMaps are written in the same format as an unordered_map,
+// without their expiry times
+template<typename K, typename V, typename Hash>
+struct serial<db::ShardedMap<K, V, Hash>>
 {
-	write(out, value.first);
-	write(out, value.second);
-}
+	template<Output Out>
+	static void write(Out &out, const db::ShardedMap<K, V, Hash>& value) {
+		serializer::write(out, value.size());
+		for (const auto& [k, v] : value) {
+			serializer::write(out, k);
+			serializer::write(out, v);
+		}
+	}
+};
 
-// read a pair from the input stream
-template<typename K, typename V>
-std::pair<K, V> read(std::ifstream &in)
+// values are written as the index of their type, then the value
+template<>
+struct serial<db::db_data_type>
 {
-	K first = read<K>(in);
-	V second = read<V>(in);
-	return std::make_pair(first, second);
-}
+	template<Output Out>
+	static void write(Out &out, const db::db_data_type& value) {
+		// int8_t saves us 7 bytes per primary_serialize_type since we'll never have > 256 types
+		auto index = static_cast<int8_t>(value.index());
+		serializer::write(out, index);
+		switch (index) {
+			case 0:
+				return serializer::write(out, std::get<0>(value));
+			case 1:
+				return serializer::write(out, std::get<1>(value));
+			case 2:
+				return serializer::write(out, std::get<2>(value));
+			case 3:
+				return serializer::write(out, std::get<3>(value));
+			case 4:
+				return serializer::write(out, std::get<4>(value));
+			case 5:
+				return serializer::write(out, std::get<5>(value));
+			default:
+				throw std::runtime_error("invalid type");
+		}
+	}
 
-// write an unordered_map to the output stream
-template<typename K, typename V>
-void write(std::ofstream &out, const std::unordered_map<K, V>& value)
+	template<Input In>
+	static db::db_data_type read(In &in) {
+		switch (serializer::read<int8_t>(in)) {
+			case 0:
+				return serializer::read<db::db_index_t<0>>(in);
+			case 1:
+				return serializer::read<db::db_index_t<1>>(in);
+			case 2:
+				return serializer::read<db::db_index_t<2>>(in);
+			case 3:
+				return serializer::read<db::db_index_t<3>>(in);
+			case 4:
+				return serializer::read<db::db_index_t<4>>(in);
+			case 5:
+				return serializer::read<db::db_index_t<5>>(in);
+			default:
+				throw std::runtime_error("invalid type");
+		}
+	}
+};
+
+// stored values are written in the same format as a db_data_type
+template<>
+struct serial<db::Value>
 {
-	write(out, value.size());
-	for (const auto& pair : value)
-		write(out, pair);
-}
+	template<Output Out>
+	static void write(Out &out, const db::Value& value) {
+		auto index = static_cast<int8_t>(value.index());
+		serializer::write(out, index);
+		switch (index) {
+			case 0: {
+				db::Value::string_buffer buffer;
+				return serializer::write(out, value.view(buffer));
+			}
+			case 1:
+				return serializer::write(out, value.get<db::db_index_t<1>>());
+			case 2:
+				return serializer::write(out, value.get<db::db_index_t<2>>());
+			case 3:
+				return serializer::write(out, value.get<db::db_index_t<3>>());
+			case 4:
+				return serializer::write(out, value.get<db::db_index_t<4>>());
+			case 5:
+				return serializer::write(out, value.get<db::db_index_t<5>>());
+			default:
+				throw std::runtime_error("invalid type");
+		}
+	}
+
+	template<Input In>
+	static db::Value read(In &in) {
+		return db::Value{serializer::read<db::db_data_type>(in)};
+	}
+};
 
 
 /*
  * Handle for reading with the serializer::read function
  */
+template<Input In>
 class ReadHandle
 {
 private:
-	// the input stream
-	std::ifstream& m_in;
+	// the input
+	In& m_in;
 
 public:
 	// create a new ReadHandle
-	explicit ReadHandle(std::ifstream& in): m_in(in) {}
+	explicit ReadHandle(In& in): m_in(in) {}
 
-	// read a value from the input stream
+	// read a value from the input
 	template<typename T>
 	T read() {
 		return serializer::read<T>(m_in);
 	}
 
-	// read several values from the input stream in order
+	// read several values from the input in order
 	template<typename ...Args, typename = std::enable_if_t<sizeof...(Args) != 1>>
 	std::tuple<Args...> read() {
 		return {read<Args>()...};
@@ -286,23 +602,24 @@ public:
 /*
  * Handle for writing with the serializer::write function
  */
+template<Output Out>
 class WriteHandle
 {
 private:
-	// the output stream
-	std::ofstream& m_out;
+	// the output
+	Out& m_out;
 
 public:
 	// create a new WriteHandle
-	explicit WriteHandle(std::ofstream& out): m_out(out) {}
+	explicit WriteHandle(Out& out): m_out(out) {}
 
-	// write a value to the output stream
+	// write a value to the output
 	template<typename T>
 	void write(const T& value) {
 		serializer::write(m_out, value);
 	}
 
-	// write several values to the output stream in order
+	// write several values to the output in order
 	template<typename ...Args, typename = std::enable_if_t<sizeof...(Args) != 1>>
 	void write(const Args&... values) {
 		(write(values), ...);
@@ -0,0 +1,136 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_STRING_TRIE_H
+#define VANITY_STRING_TRIE_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+
+namespace vanity {
+
+// a table of strings and the values they represent
+template<typename T, size_t N>
+using string_table = std::array<std::pair<T, std::string_view>, N>;
+
+// the number of characters a StringTrie can hold: 'A' to 'Z' and '_'
+static constexpr size_t M_TRIE_ALPHABET = 27;
+
+// the index of a character in the trie alphabet
+// or M_TRIE_ALPHABET if it is not part of it
+constexpr size_t trie_index(char c) {
+	if (c >= 'A' and c <= 'Z')
+		return c - 'A';
+	if (c == '_')
+		return M_TRIE_ALPHABET - 1;
+	return M_TRIE_ALPHABET;
+}
+
+// the number of nodes needed for a trie of the strings in table
+template<typename T, size_t N>
+constexpr size_t trie_size(const string_table<T, N>& table) {
+	// the root, then one node per distinct non-empty prefix
+	size_t size = 1;
+	for (size_t i = 0; i < N; ++i) {
+		auto str = table[i].second;
+		for (size_t len = 1; len <= str.size(); ++len) {
+			bool seen = false;
+			for (size_t j = 0; j < i and not seen; ++j)
+				seen = table[j].second.substr(0, len) == str.substr(0, len);
+			size += not seen;
+		}
+	}
+	return size;
+}
+
+/*
+ * A StringTrie finds the value of the longest string of a table
+ * at the start of some text, in one pass over the text
+ *
+ * The trie is built at compile time. Each node holds the next node
+ * for every character in the alphabet, so a lookup is one array
+ * access per character matched.
+ */
+template<typename T, size_t Nodes>
+class StringTrie
+{
+private:
+	// the index of a missing node
+	static constexpr uint16_t M_NONE = 0;
+
+	static_assert(Nodes <= UINT16_MAX, "too many nodes in StringTrie");
+
+	// a node in the trie
+	struct node {
+		// the next node for each character
+		std::array<uint16_t, M_TRIE_ALPHABET> next {};
+
+		// whether a string in the table ends here
+		bool terminal = false;
+
+		// the value of the string that ends here
+		T value {};
+	};
+
+	// the nodes, the root is the first
+	std::array<node, Nodes> m_nodes {};
+
+public:
+	// build a trie from a table of strings
+	template<size_t N>
+	consteval explicit StringTrie(const string_table<T, N>& table) {
+		size_t size = 1;
+		for (const auto& [value, str] : table) {
+			size_t current = 0;
+			for (char c : str) {
+				auto index = trie_index(c);
+				if (index == M_TRIE_ALPHABET)
+					throw std::logic_error("StringTrie strings must be upper case letters and underscores");
+
+				auto& next = m_nodes[current].next[index];
+				if (next == M_NONE)
+					next = size++;
+				current = next;
+			}
+
+			if (m_nodes[current].terminal)
+				throw std::logic_error("duplicate string in StringTrie");
+
+			m_nodes[current].terminal = true;
+			m_nodes[current].value = value;
+		}
+
+		if (size != Nodes)
+			throw std::logic_error("StringTrie size does not match its table");
+	}
+
+	// find the longest string in the trie that text starts with
+	// returns its value and its length, or std::nullopt if there is none
+	constexpr std::optional<std::pair<T, size_t>> match(std::string_view text) const {
+		std::optional<std::pair<T, size_t>> found;
+		size_t current = 0;
+		for (size_t i = 0; i < text.size(); ++i) {
+			auto index = trie_index(text[i]);
+			if (index == M_TRIE_ALPHABET)
+				break;
+
+			current = m_nodes[current].next[index];
+			if (current == M_NONE)
+				break;
+
+			if (m_nodes[current].terminal)
+				found.emplace(m_nodes[current].value, i + 1);
+		}
+		return found;
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_STRING_TRIE_H
@@ -0,0 +1,211 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_TIMING_WHEEL_H
+#define VANITY_TIMING_WHEEL_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace vanity {
+
+/*
+ * A TimingWheel holds values until a time point they are due at
+ *
+ * Time is split into ticks of M_TICK. The wheel has M_LEVELS levels of
+ * M_SLOTS slots each, and a slot in level l holds the values due in a
+ * span of M_SLOTS^l ticks. As time advances, the slots of a level are
+ * emptied into the finer level below when their span begins, so a value
+ * only moves once per level, and advancing never looks at a value
+ * that is not about to be due. Values due further away than the whole
+ * wheel spans wait in the last slot they can reach, and are placed
+ * again when it comes around.
+ *
+ * The slots are allocated on the first insert, so an unused wheel is small
+ */
+template<typename T>
+class TimingWheel
+{
+public:
+	using clock = std::chrono::system_clock;
+	using time_point = clock::time_point;
+
+	// a value and when it is due
+	struct entry {
+		T value;
+		time_point due;
+	};
+
+private:
+	using tick_t = uint64_t;
+
+	// the length of a tick
+	static constexpr std::chrono::milliseconds M_TICK {10};
+
+	// log2 of the number of slots in a level
+	static constexpr int M_SLOT_BITS = 6;
+
+	// the number of slots in a level
+	static constexpr tick_t M_SLOTS = tick_t{1} << M_SLOT_BITS;
+
+	// the number of levels
+	// together they span M_SLOTS^M_LEVELS ticks, about 1.9 days
+	static constexpr int M_LEVELS = 4;
+
+	using level_type = std::array<std::vector<entry>, M_SLOTS>;
+	using levels_type = std::array<level_type, M_LEVELS>;
+
+	// the levels, allocated on the first insert
+	std::unique_ptr<levels_type> m_levels;
+
+	// values that are due
+	std::vector<entry> m_due;
+
+	// the last tick advanced to
+	tick_t m_now = tick_of(clock::now());
+
+	// the number of values in the levels
+	size_t m_size = 0;
+
+	// the tick a time point is in
+	static tick_t tick_of(time_point tp) {
+		using namespace std::chrono;
+		return duration_cast<milliseconds>(tp.time_since_epoch()).count() / M_TICK.count();
+	}
+
+	// the number of ticks a slot in a level spans
+	static constexpr tick_t span_of(int level) {
+		return tick_t{1} << (M_SLOT_BITS * level);
+	}
+
+	// the slot in a level a tick falls in
+	static constexpr size_t slot_of(tick_t tick, int level) {
+		return (tick >> (M_SLOT_BITS * level)) & (M_SLOTS - 1);
+	}
+
+	// put an entry in the slot it is due in, or with the due values
+	void place(entry e) {
+		auto tick = tick_of(e.due);
+		if (tick <= m_now) {
+			m_due.push_back(std::move(e));
+			return;
+		}
+
+		// clamp to the furthest tick the wheel can hold
+		auto delta = std::min(tick - m_now, span_of(M_LEVELS) - 1);
+
+		int level = 0;
+		while (delta >= span_of(level + 1))
+			++level;
+
+		(*m_levels)[level][slot_of(m_now + delta, level)].push_back(std::move(e));
+		++m_size;
+	}
+
+	// place the entries of a slot again, now that its span has begun
+	void cascade(int level, size_t slot) {
+		auto entries = std::move((*m_levels)[level][slot]);
+		(*m_levels)[level][slot].clear();
+		m_size -= entries.size();
+
+		for (auto& e : entries)
+			place(std::move(e));
+	}
+
+public:
+	// add a value due at a time point
+	void insert(T value, time_point due) {
+		if (not m_levels)
+			m_levels = std::make_unique<levels_type>();
+
+		place({std::move(value), due});
+	}
+
+	// move every value due by a time point to the due values
+	void advance(time_point now) {
+		auto target = tick_of(now);
+
+		// once the levels are empty, skip straight to the target
+		while (m_now < target and m_size > 0) {
+			++m_now;
+
+			// the coarser levels first, so their entries can fall
+			// into a finer slot that begins at the same tick
+			for (int level = M_LEVELS - 1; level > 0; --level)
+				if (m_now % span_of(level) == 0)
+					cascade(level, slot_of(m_now, level));
+
+			cascade(0, slot_of(m_now, 0));
+		}
+
+		m_now = std::max(m_now, target);
+	}
+
+	// remove and return up to limit due values
+	std::vector<entry> take_due(size_t limit) {
+		if (m_due.size() <= limit)
+			return std::exchange(m_due, {});
+
+		std::vector<entry> taken {
+			std::make_move_iterator(m_due.end() - limit),
+			std::make_move_iterator(m_due.end())
+		};
+		m_due.resize(m_due.size() - limit);
+		return taken;
+	}
+
+	// put back entries taken with take_due()
+	// the ones still due are handed out after every other due value
+	void put_back(std::vector<entry> entries) {
+		std::vector<entry> due;
+		for (auto& e : entries) {
+			if (tick_of(e.due) <= m_now)
+				due.push_back(std::move(e));
+			else
+				insert(std::move(e.value), e.due);
+		}
+
+		m_due.insert(m_due.begin(), std::make_move_iterator(due.begin()), std::make_move_iterator(due.end()));
+	}
+
+	// whether there are due values
+	bool has_due() const {
+		return not m_due.empty();
+	}
+
+	// the number of values in the wheel, due or not
+	size_t size() const {
+		return m_size + m_due.size();
+	}
+
+	// remove and return every value, due or not
+	std::vector<entry> take_all() {
+		auto taken = std::exchange(m_due, {});
+		if (m_levels)
+			for (auto& level : *m_levels)
+				for (auto& slot : level)
+					std::move(slot.begin(), slot.end(), std::back_inserter(taken));
+
+		clear();
+		return taken;
+	}
+
+	// remove all values
+	void clear() {
+		m_levels.reset();
+		m_due.clear();
+		m_size = 0;
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_TIMING_WHEEL_H
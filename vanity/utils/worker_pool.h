@@ -0,0 +1,120 @@
+//
+// Created by kingsli on 10/18/26.
+//
+
+#ifndef VANITY_WORKER_POOL_H
+#define VANITY_WORKER_POOL_H
+
+#include <exception>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "queue.h"
+
+
+namespace vanity {
+
+/*
+ * A WorkerPool runs tasks on a fixed set of threads
+ *
+ * The threads are started once, with the pool, so running
+ * tasks never pays for creating and joining threads.
+ * run() takes a batch of tasks, runs the first one on the calling
+ * thread and the rest on the workers, and waits for all of them
+ */
+class WorkerPool
+{
+public:
+	using task_t = std::function<void()>;
+
+private:
+	// the tasks waiting for a worker, std::nullopt stops a worker
+	Queue<std::optional<task_t>> m_tasks;
+
+	// the worker threads
+	std::vector<std::thread> m_workers;
+
+	// run tasks until stopped
+	void work() {
+		while (auto task = m_tasks.get())
+			(*task)();
+	}
+
+public:
+	// start a pool of size workers
+	explicit WorkerPool(size_t size) {
+		m_workers.reserve(size);
+		for (size_t i = 0; i < size; ++i)
+			m_workers.emplace_back(&WorkerPool::work, this);
+	}
+
+	// no copy
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// stop the workers, once they finish the tasks queued
+	~WorkerPool() {
+		for (size_t i = 0; i < m_workers.size(); ++i)
+			m_tasks.push(std::nullopt);
+		for (auto& worker : m_workers)
+			worker.join();
+	}
+
+	// the number of workers
+	size_t size() const {
+		return m_workers.size();
+	}
+
+	// run a batch of tasks, the first on this thread and the rest on the
+	// workers, or all of them on this thread if there are no workers
+	// returns once all of them are done, rethrowing the first exception
+	void run(std::vector<task_t>& tasks) {
+		if (tasks.empty())
+			return;
+
+		if (m_workers.empty()) {
+			for (auto& task : tasks)
+				task();
+			return;
+		}
+
+		std::latch done {static_cast<std::ptrdiff_t>(tasks.size() - 1)};
+		std::exception_ptr error;
+		std::mutex error_mutex;
+
+		for (size_t i = 1; i < tasks.size(); ++i) {
+			m_tasks.push([&task = tasks[i], &done, &error, &error_mutex] {
+				try {
+					task();
+				}
+				catch (...) {
+					std::lock_guard lock {error_mutex};
+					if (not error)
+						error = std::current_exception();
+				}
+				done.count_down();
+			});
+		}
+
+		// the tasks refer to this frame, so wait for them even if this one throws
+		try {
+			tasks.front()();
+		}
+		catch (...) {
+			done.wait();
+			throw;
+		}
+
+		done.wait();
+		if (error)
+			std::rethrow_exception(error);
+	}
+};
+
+} // namespace vanity
+
+#endif //VANITY_WORKER_POOL_H